@@ -0,0 +1,110 @@
+// Hex and base64 throughput: byte-wise sos_push loops vs sos_append_hex / sos_append_base64 and decoders.
+// Usage: bench_codec [bytes]
+
+#include "bench.h"
+#include "../sos_codec.h"
+#include <string.h>
+
+static void
+push_hex(Sos* out, const unsigned char* in, size_t n)
+{
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < n; ++i) {
+        sos_push(out, digits[in[i] >> 4]);
+        sos_push(out, digits[in[i] & 0xf]);
+    }
+}
+
+static void
+push_base64(Sos* out, const unsigned char* in, size_t n)
+{
+    static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i = 0;
+    for (; i + 3 <= n; i += 3) {
+        const unsigned v = (unsigned)in[i] << 16 | (unsigned)in[i + 1] << 8 | in[i + 2];
+        sos_push(out, chars[v >> 18]);
+        sos_push(out, chars[v >> 12 & 0x3f]);
+        sos_push(out, chars[v >> 6 & 0x3f]);
+        sos_push(out, chars[v & 0x3f]);
+    }
+    if (i < n) {
+        const unsigned v = (unsigned)in[i] << 16 | (i + 1 < n ? (unsigned)in[i + 1] << 8 : 0);
+        sos_push(out, chars[v >> 18]);
+        sos_push(out, chars[v >> 12 & 0x3f]);
+        sos_push(out, i + 1 < n ? chars[v >> 6 & 0x3f] : '=');
+        sos_push(out, '=');
+    }
+}
+
+// Encode `len` bytes as blocks of `block` bytes, e.g. digests or blobs
+static void
+run(size_t block, const unsigned char* in, size_t len)
+{
+    const size_t n = len / block * block;
+    Sos out, back;
+    sos_init(&out);
+    sos_init(&back);
+
+    uint64_t t0 = bench_now_ns();
+    for (size_t i = 0; i < n; i += block) {
+        push_hex(&out, in + i, block);
+    }
+    const uint64_t push_hex_ns = bench_now_ns() - t0;
+    sos_clear(&out);
+    t0 = bench_now_ns();
+    for (size_t i = 0; i < n; i += block) {
+        BENCH_CHECK(sos_append_hex(&out, in + i, block) == SOS_OK);
+    }
+    const uint64_t hex_ns = bench_now_ns() - t0;
+    t0 = bench_now_ns();
+    BENCH_CHECK(sos_append_hex_decoded(&back, sos_cstr(&out), sos_len(&out)) == SOS_OK);
+    const uint64_t unhex_ns = bench_now_ns() - t0;
+    BENCH_CHECK(sos_len(&back) == n && memcmp(sos_cstr(&back), in, n) == 0);
+
+    sos_clear(&out);
+    t0 = bench_now_ns();
+    for (size_t i = 0; i < n; i += block) {
+        push_base64(&out, in + i, block);
+    }
+    const uint64_t push_b64_ns = bench_now_ns() - t0;
+    sos_clear(&out);
+    t0 = bench_now_ns();
+    for (size_t i = 0; i < n; i += block) {
+        BENCH_CHECK(sos_append_base64(&out, in + i, block, SOS_BASE64_STANDARD) == SOS_OK);
+    }
+    const uint64_t b64_ns = bench_now_ns() - t0;
+    sos_clear(&back);
+    sos_clear(&out);
+    BENCH_CHECK(sos_append_base64(&out, in, n, SOS_BASE64_STANDARD) == SOS_OK);
+    t0 = bench_now_ns();
+    BENCH_CHECK(sos_append_base64_decoded(&back, sos_cstr(&out), sos_len(&out), SOS_BASE64_STANDARD) == SOS_OK);
+    const uint64_t unb64_ns = bench_now_ns() - t0;
+    BENCH_CHECK(sos_len(&back) == n && memcmp(sos_cstr(&back), in, n) == 0);
+
+    printf("block %6zu: hex push %5.2f GB/s, append %5.2f GB/s | base64 push %5.2f GB/s, append %5.2f GB/s\n", block,
+           (double)n / push_hex_ns, (double)n / hex_ns, (double)n / push_b64_ns, (double)n / b64_ns);
+    if (block == n) {
+        printf("decode whole buffer: hex %5.2f GB/s, base64 %5.2f GB/s\n", (double)n / unhex_ns, (double)n / unb64_ns);
+    }
+    sos_finish(&out);
+    sos_finish(&back);
+}
+
+int main(int argc, char** argv)
+{
+    const size_t len = argc > 1 ? strtoull(argv[1], NULL, 10) : (size_t)32 << 20;
+    unsigned char* const in = malloc(len);
+    BENCH_CHECK(in);
+    uint64_t x = 88172645463325252u;
+    for (size_t i = 0; i < len; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        in[i] = (unsigned char)x;
+    }
+    run(32, in, len);   // SHA-256 digest
+    run(4096, in, len); // Blob
+    run(len, in, len);
+    free(in);
+    return 0;
+}
@@ -0,0 +1,171 @@
+// sos::string against std::string, in std::vector growth and std::unordered_map workloads.
+// Usage: bench_cxx [count]
+//
+// "relocating vector" grows with realloc() when the element type is trivially relocatable, as
+// containers that honor sos::is_trivially_relocatable do.
+
+#include "bench.h"
+#include "../sos.hpp"
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Minimal growable array, relocating its elements on growth
+template <class T>
+class RelocVec {
+public:
+    RelocVec() = default;
+    RelocVec(const RelocVec&) = delete;
+    RelocVec& operator=(const RelocVec&) = delete;
+    ~RelocVec()
+    {
+        for (size_t i = 0; i < len_; ++i) {
+            data_[i].~T();
+        }
+        std::free(data_);
+    }
+
+    template <class... Args>
+    void emplace_back(Args&&... args)
+    {
+        if (len_ == cap_) {
+            grow();
+        }
+        new (data_ + len_) T(std::forward<Args>(args)...);
+        ++len_;
+    }
+
+    size_t size() const { return len_; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+private:
+    void grow()
+    {
+        const size_t cap = cap_ ? cap_ * 2 : 16;
+        T* data;
+        if constexpr (sos::is_trivially_relocatable_v<T>) {
+            data = static_cast<T*>(std::realloc(static_cast<void*>(data_), cap * sizeof(T)));
+            BENCH_CHECK(data);
+        } else {
+            data = static_cast<T*>(std::malloc(cap * sizeof(T)));
+            BENCH_CHECK(data);
+            sos::relocate(data_, data_ + len_, data);
+            std::free(data_);
+        }
+        data_ = data;
+        cap_ = cap;
+    }
+
+    T* data_ = nullptr;
+    size_t len_ = 0;
+    size_t cap_ = 0;
+};
+
+// Keys of 8 to 40 chars, so that some fit the small buffers and some do not
+static std::vector<std::string>
+make_keys(size_t count)
+{
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    uint64_t x = 0x9E3779B97F4A7C15u;
+    for (size_t i = 0; i < count; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        std::string k = "key:" + std::to_string(i) + ":";
+        k.append(x % 33, (char)('a' + x % 26));
+        keys.push_back(std::move(k));
+    }
+    return keys;
+}
+
+static void
+report(const char* what, const char* impl, uint64_t ns, size_t ops)
+{
+    printf("%-28s %-18s %7.1f ns/op\n", what, impl, (double)ns / ops);
+}
+
+template <class Vec>
+static void
+vector_growth(const char* impl, const std::vector<std::string>& keys)
+{
+    const uint64_t t0 = bench_now_ns();
+    size_t total = 0;
+    {
+        Vec v;
+        for (const std::string& k : keys) {
+            v.emplace_back(k.data(), k.size());
+        }
+        for (size_t i = 0; i < v.size(); ++i) {
+            total += v[i].size();
+        }
+    }
+    report("vector growth + destroy", impl, bench_now_ns() - t0, keys.size());
+    BENCH_CHECK(total > 0);
+}
+
+template <class Str, class Hash>
+static void
+map_workload(const char* impl, const std::vector<std::string>& keys)
+{
+    std::unordered_map<Str, size_t, Hash> m;
+    uint64_t t0 = bench_now_ns();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        m.emplace(Str(keys[i].data(), keys[i].size()), i);
+    }
+    report("unordered_map insert", impl, bench_now_ns() - t0, keys.size());
+
+    std::vector<Str> probes;
+    probes.reserve(keys.size());
+    for (size_t i = keys.size(); i-- > 0;) {
+        probes.emplace_back(keys[i].data(), keys[i].size());
+    }
+    t0 = bench_now_ns();
+    size_t sum = 0;
+    for (const Str& p : probes) {
+        sum += m.find(p)->second;
+    }
+    report("unordered_map find", impl, bench_now_ns() - t0, keys.size());
+    BENCH_CHECK(sum == keys.size() * (keys.size() - 1) / 2);
+}
+
+#ifdef SOS_HAVE_PMR
+template <class Str>
+static void
+pmr_vector(const char* impl, const std::vector<std::string>& keys)
+{
+    std::vector<char> arena(keys.size() * 128);
+    const uint64_t t0 = bench_now_ns();
+    {
+        std::pmr::monotonic_buffer_resource res(arena.data(), arena.size());
+        std::vector<Str> v;
+        v.reserve(keys.size());
+        for (const std::string& k : keys) {
+            v.emplace_back(k.data(), k.size(), &res);
+        }
+    }
+    report("vector build, monotonic pmr", impl, bench_now_ns() - t0, keys.size());
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    const std::vector<std::string> keys = make_keys(count);
+
+    vector_growth<std::vector<std::string>>("std::string", keys);
+    vector_growth<std::vector<sos::string>>("sos::string", keys);
+    vector_growth<RelocVec<std::string>>("std::string reloc", keys);
+    vector_growth<RelocVec<sos::string>>("sos::string reloc", keys);
+
+    map_workload<std::string, std::hash<std::string>>("std::string", keys);
+    map_workload<sos::string, std::hash<sos::string>>("sos::string", keys);
+
+#ifdef SOS_HAVE_PMR
+    pmr_vector<std::pmr::string>("std::pmr::string", keys);
+    pmr_vector<sos::pmr::string>("sos::pmr::string", keys);
+#endif
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Split a tab-delimited buffer into strings: per-field sos_init_from_range vs sos_init_many_from_delimited.
+// Usage: bench_delimited [buffer_bytes]
+
+#include "bench.h"
+#include <string.h>
+
+int main(int argc, char** argv)
+{
+    const size_t size = argc > 1 ? strtoull(argv[1], NULL, 10) : (size_t)64 << 20;
+
+    // Mix of short and long fields
+    static const char* const samples[] = {"42", "GET", "/index.html", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36", "200", "https://example.com/a/b/c?q=1"};
+    char* const buf = malloc(size + 64);
+    BENCH_CHECK(buf);
+    size_t len = 0;
+    size_t fields = 0;
+    while (len < size) {
+        const char* const s = samples[fields % 6];
+        const size_t n = strlen(s);
+        memcpy(buf + len, s, n);
+        len += n;
+        buf[len++] = '\t';
+        fields += 1;
+    }
+
+    Sos* const out = malloc(fields * sizeof(Sos));
+    BENCH_CHECK(out);
+
+    uint64_t t0 = bench_now_ns();
+    size_t count = 0;
+    for (const char* p = buf; p < buf + len;) {
+        const char* const q = memchr(p, '\t', (size_t)(buf + len - p));
+        BENCH_CHECK(sos_init_from_range(&out[count++], p, (size_t)(q - p)) == SOS_OK);
+        p = q + 1;
+    }
+    const uint64_t single_ns = bench_now_ns() - t0;
+    t0 = bench_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        sos_finish(&out[i]);
+    }
+    const uint64_t single_finish_ns = bench_now_ns() - t0;
+    BENCH_CHECK(count == fields);
+
+    t0 = bench_now_ns();
+    const SosManyResult ret = sos_init_many_from_delimited(buf, len, '\t', out, fields);
+    const uint64_t many_ns = bench_now_ns() - t0;
+    BENCH_CHECK(ret.status == SOS_OK && ret.count == fields && ret.consumed == len);
+    t0 = bench_now_ns();
+    sos_finish_many(out, ret.count, ret.storage);
+    const uint64_t many_finish_ns = bench_now_ns() - t0;
+
+    printf("%zu bytes, %zu fields\n", len, fields);
+    printf("sos_init_from_range per field:  %8.1f ms (%.1f ns/field), finish %8.1f ms\n", single_ns / 1e6, (double)single_ns / fields, single_finish_ns / 1e6);
+    printf("sos_init_many_from_delimited:   %8.1f ms (%.1f ns/field), finish %8.3f ms\n", many_ns / 1e6, (double)many_ns / fields, many_finish_ns / 1e6);
+
+    free(out);
+    free(buf);
+    return 0;
+}
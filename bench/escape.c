@@ -0,0 +1,107 @@
+// Escape throughput: byte-wise sos_push loops vs the bulk escaping functions.
+// Usage: bench_escape [bytes]
+
+#include "bench.h"
+#include "../sos_escape.h"
+#include <string.h>
+
+static void
+naive_json(Sos* out, const char* in, size_t len)
+{
+    static const char hex[] = "0123456789abcdef";
+    for (size_t i = 0; i < len; ++i) {
+        const unsigned char c = (unsigned char)in[i];
+        if (c == '"' || c == '\\') {
+            sos_push(out, '\\');
+            sos_push(out, (char)c);
+        } else if (c == '\n') {
+            sos_append_cstr(out, "\\n");
+        } else if (c < 0x20) {
+            sos_append_cstr(out, "\\u00");
+            sos_push(out, hex[c >> 4]);
+            sos_push(out, hex[c & 0xf]);
+        } else {
+            sos_push(out, (char)c);
+        }
+    }
+}
+
+static void
+naive_csv(Sos* out, const char* in, size_t len)
+{
+    sos_push(out, '"');
+    for (size_t i = 0; i < len; ++i) {
+        if (in[i] == '"') {
+            sos_push(out, '"');
+        }
+        sos_push(out, in[i]);
+    }
+    sos_push(out, '"');
+}
+
+static void
+naive_url(Sos* out, const char* in, size_t len)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    for (size_t i = 0; i < len; ++i) {
+        const unsigned char c = (unsigned char)in[i];
+        if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-' || c == '.' || c == '_' || c == '~') {
+            sos_push(out, (char)c);
+        } else {
+            sos_push(out, '%');
+            sos_push(out, hex[c >> 4]);
+            sos_push(out, hex[c & 0xf]);
+        }
+    }
+}
+
+typedef void (*NaiveFn)(Sos*, const char*, size_t);
+typedef SosStatus (*BulkFn)(Sos* restrict, const char* restrict, size_t);
+
+// Escape `in` as fields of `field` bytes, into one output string
+static void
+run(const char* name, NaiveFn naive, BulkFn bulk, const char* in, size_t len, size_t field)
+{
+    Sos out;
+    sos_init(&out);
+    uint64_t t0 = bench_now_ns();
+    for (size_t i = 0; i < len; i += field) {
+        naive(&out, in + i, field);
+    }
+    const uint64_t naive_ns = bench_now_ns() - t0;
+    const size_t naive_len = sos_len(&out);
+
+    sos_clear(&out);
+    t0 = bench_now_ns();
+    for (size_t i = 0; i < len; i += field) {
+        BENCH_CHECK(bulk(&out, in + i, field) == SOS_OK);
+    }
+    const uint64_t bulk_ns = bench_now_ns() - t0;
+    BENCH_CHECK(sos_len(&out) == naive_len);
+    sos_finish(&out);
+
+    printf("%-5s field %5zu: push loop %6.2f GB/s, bulk %6.2f GB/s\n", name, field, (double)len / naive_ns, (double)len / bulk_ns);
+}
+
+int main(int argc, char** argv)
+{
+    const size_t len = argc > 1 ? strtoull(argv[1], NULL, 10) : (size_t)64 << 20;
+
+    // Text with occasional quotes, newlines and spaces
+    static const char text[] = "The quick brown fox said \"hello\" to the lazy dog, twice.\nAnother_line-of.text~here ";
+    char* const in = malloc(len + sizeof(text));
+    BENCH_CHECK(in);
+    for (size_t i = 0; i < len; i += sizeof(text) - 1) {
+        memcpy(in + i, text, sizeof(text) - 1);
+    }
+
+    static const size_t fields[] = {16, 64, 1024};
+    for (size_t f = 0; f < 3; ++f) {
+        const size_t n = len / fields[f] * fields[f];
+        run("json", naive_json, sos_append_json_escaped, in, n, fields[f]);
+        run("csv", naive_csv, sos_append_csv_quoted, in, n, fields[f]);
+        run("url", naive_url, sos_append_url_encoded, in, n, fields[f]);
+    }
+    free(in);
+    return 0;
+}
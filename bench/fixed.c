@@ -0,0 +1,53 @@
+// Building short keys: Sos vs SOS_FIXED.
+// Usage: bench_fixed [count]
+
+#include "bench.h"
+#include "../sos_fixed.h"
+#include <string.h>
+
+static const char* const parts[] = {"http", "server", "requests", "latency", "p99", "upstream.timeout"};
+
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000;
+    const size_t nparts = sizeof(parts) / sizeof(parts[0]);
+    size_t lens[sizeof(parts) / sizeof(parts[0])];
+    for (size_t i = 0; i < nparts; ++i) {
+        lens[i] = strlen(parts[i]);
+    }
+
+    // Keys of "a.b.<n>", crossing the small buffer size for the longer parts
+    uint64_t t0 = bench_now_ns();
+    uint64_t sos_sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Sos s;
+        sos_init(&s);
+        const size_t a = i % nparts, b = (i / nparts) % nparts;
+        BENCH_CHECK(sos_append_range(&s, parts[a], lens[a]) == SOS_OK);
+        BENCH_CHECK(sos_push(&s, '.') == SOS_OK);
+        BENCH_CHECK(sos_append_range(&s, parts[b], lens[b]) == SOS_OK);
+        BENCH_CHECK(sos_push(&s, '.') == SOS_OK);
+        BENCH_CHECK(sos_push(&s, (char)('0' + i % 10)) == SOS_OK);
+        sos_sum += sos_hash(&s);
+        sos_finish(&s);
+    }
+    const uint64_t sos_ns = bench_now_ns() - t0;
+
+    t0 = bench_now_ns();
+    uint64_t fixed_sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        SOS_FIXED(63) s = SOS_FIXED_INIT(63);
+        const size_t a = i % nparts, b = (i / nparts) % nparts;
+        BENCH_CHECK(sos_fixed_append_range(&s.hdr, parts[a], lens[a]) == SOS_OK);
+        BENCH_CHECK(sos_fixed_push(&s.hdr, '.') == SOS_OK);
+        BENCH_CHECK(sos_fixed_append_range(&s.hdr, parts[b], lens[b]) == SOS_OK);
+        BENCH_CHECK(sos_fixed_push(&s.hdr, '.') == SOS_OK);
+        BENCH_CHECK(sos_fixed_push(&s.hdr, (char)('0' + i % 10)) == SOS_OK);
+        fixed_sum += sos_fixed_hash(&s.hdr);
+    }
+    const uint64_t fixed_ns = bench_now_ns() - t0;
+    BENCH_CHECK(sos_sum == fixed_sum);
+
+    printf("build+hash %zu keys: Sos %6.1f ns/key, SOS_FIXED %6.1f ns/key\n", count, (double)sos_ns / count, (double)fixed_ns / count);
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Compressed string column: compression ratio, decompression throughput and compressed equality scans.
+// Usage: bench_fsst [strings]
+
+#include "bench.h"
+#include "../sos_fsst.h"
+#include <string.h>
+
+int main(int argc, char** argv)
+{
+    const size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+
+    static const char* const hosts[] = {"example.com", "www.example.org", "static.example.net", "cdn.images.example.io"};
+    static const char* const paths[] = {"/index.html", "/api/v1/users/", "/assets/img/logo.png", "/search?q=", "/blog/2024/05/"};
+    Sos* const arr = malloc(n * sizeof(Sos));
+    BENCH_CHECK(arr);
+    size_t raw = 0;
+    size_t heap = 0;
+    for (size_t i = 0; i < n; ++i) {
+        BENCH_CHECK(sos_init_format(&arr[i], "https://%s%s%zu", hosts[i % 4], paths[i / 4 % 5], i * 2654435761u % 100000) == SOS_OK);
+        raw += sos_len(&arr[i]);
+        heap += sizeof(Sos) + (sos_len(&arr[i]) > SOS_SBO_BUFSIZE - 1 ? sos_cap(&arr[i]) + 1 : 0);
+    }
+
+    uint64_t t0 = bench_now_ns();
+    SosFsstColumn col;
+    BENCH_CHECK(sos_fsst_column_build(&col, arr, n) == SOS_OK);
+    const uint64_t build_ns = bench_now_ns() - t0;
+
+    // Best of several rounds, decoding is short enough to be skewed by other load
+    enum { ROUNDS = 5 };
+    char buf[256];
+    uint64_t decode_ns = UINT64_MAX;
+    uint64_t get_ns = UINT64_MAX;
+    for (int r = 0; r < ROUNDS; ++r) {
+        size_t total = 0;
+        t0 = bench_now_ns();
+        for (size_t i = 0; i < n; ++i) {
+            total += sos_fsst_column_get_into(&col, i, buf, sizeof(buf));
+        }
+        const uint64_t ns = bench_now_ns() - t0;
+        BENCH_CHECK(total == raw);
+        decode_ns = ns < decode_ns ? ns : decode_ns;
+
+        t0 = bench_now_ns();
+        for (size_t i = 0; i < n; ++i) {
+            Sos s;
+            BENCH_CHECK(sos_fsst_column_get(&col, i, &s) == SOS_OK);
+            sos_finish(&s);
+        }
+        const uint64_t get_round_ns = bench_now_ns() - t0;
+        get_ns = get_round_ns < get_ns ? get_round_ns : get_ns;
+    }
+
+    const Sos* const key = &arr[n / 2];
+    size_t hits_raw = 0;
+    t0 = bench_now_ns();
+    for (size_t i = 0; i < n; ++i) {
+        hits_raw += sos_eq(&arr[i], key);
+    }
+    const uint64_t eq_raw_ns = bench_now_ns() - t0;
+
+    Sos needle;
+    sos_init(&needle);
+    size_t hits = 0;
+    t0 = bench_now_ns();
+    BENCH_CHECK(sos_fsst_compress(&col.table, sos_cstr(key), sos_len(key), &needle) == SOS_OK);
+    for (size_t i = 0; i < n; ++i) {
+        hits += sos_fsst_column_eq(&col, i, &needle);
+    }
+    const uint64_t eq_ns = bench_now_ns() - t0;
+    BENCH_CHECK(hits == hits_raw);
+
+    printf("%zu strings, %zu payload bytes\n", n, raw);
+    printf("Sos array:      %10zu bytes\n", heap);
+    printf("FSST column:    %10zu bytes (payload %zu, ratio %.2f)\n", sos_fsst_column_memory(&col), col.offsets[n], (double)raw / col.offsets[n]);
+    printf("build:          %8.1f ms\n", build_ns / 1e6);
+    printf("decode (buf):   %8.1f ms (%.2f GB/s)\n", decode_ns / 1e6, (double)raw / decode_ns);
+    printf("decode (Sos):   %8.1f ms (%.2f GB/s)\n", get_ns / 1e6, (double)raw / get_ns);
+    printf("eq scan raw:    %8.1f ms\n", eq_raw_ns / 1e6);
+    printf("eq scan packed: %8.1f ms\n", eq_ns / 1e6);
+
+    sos_finish(&needle);
+    sos_fsst_column_finish(&col);
+    for (size_t i = 0; i < n; ++i) {
+        sos_finish(&arr[i]);
+    }
+    free(arr);
+    return 0;
+}
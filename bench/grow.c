@@ -0,0 +1,48 @@
+// Grow a single string to a large size with fixed-size appends.
+// Usage: bench_grow [total_bytes] [append_bytes]
+
+#include "bench.h"
+#include <string.h>
+
+int main(int argc, char** argv)
+{
+    const size_t total = argc > 1 ? strtoull(argv[1], NULL, 10) : (size_t)1 << 30;
+    const size_t chunk = argc > 2 ? strtoull(argv[2], NULL, 10) : 4096;
+    BENCH_CHECK(chunk > 0);
+
+    char* const buf = malloc(chunk);
+    BENCH_CHECK(buf);
+    memset(buf, 'x', chunk);
+
+#ifdef SOS_MMAP_THRESHOLD
+    printf("mmap threshold: %zu\n", (size_t)SOS_MMAP_THRESHOLD);
+#else
+    printf("mmap threshold: disabled\n");
+#endif
+
+    Sos s;
+    sos_init(&s);
+    size_t appends = 0;
+    size_t cap_changes = 0;
+    size_t cap = sos_cap(&s);
+
+    const uint64_t t0 = bench_now_ns();
+    while (sos_len(&s) < total) {
+        BENCH_CHECK(sos_append_range(&s, buf, chunk) == SOS_OK);
+        appends += 1;
+        if (sos_cap(&s) != cap) {
+            cap = sos_cap(&s);
+            cap_changes += 1;
+        }
+    }
+    const uint64_t t1 = bench_now_ns();
+    sos_finish(&s);
+    const uint64_t t2 = bench_now_ns();
+
+    printf("grew to %zu bytes in %zu appends of %zu bytes\n", total, appends, chunk);
+    printf("total: %.3f ms, %.1f ns/append, %zu capacity changes, finish: %.3f ms\n", (t1 - t0) / 1e6, (double)(t1 - t0) / appends, cap_changes,
+           (t2 - t1) / 1e6);
+
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Substring search over hostnames and user agents: SosNgramIndex against a scan of every string.
+// Usage: bench_ngram [strings] [threads]
+
+#include "bench.h"
+#include <sos_ngram.h>
+#include <string.h>
+
+static bool
+count_visitor(size_t id, SosView str, void* ctx)
+{
+    (void)id; (void)str;
+    *(size_t*)ctx += 1;
+    return true;
+}
+
+static size_t
+scan_count(const Sos* strs, size_t n, SosView needle)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const SosView s = sos_view(&strs[i]);
+        for (size_t k = 0; k + needle.len <= s.len; ++k) {
+            if (s.data[k] == needle.data[0] && memcmp(s.data + k, needle.data, needle.len) == 0) {
+                count += 1;
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 2000000;
+    const unsigned threads = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 10) : 0;
+
+    static const char* const words[] = {"api", "cdn", "mail", "www", "static", "eu-west", "us-east", "edge", "img", "auth"};
+    static const char* const tlds[] = {"com", "net", "org", "io", "co.uk"};
+    Sos* const strs = malloc(n * sizeof(Sos));
+    BENCH_CHECK(strs);
+    uint64_t x = 0x9E3779B97F4A7C15u;
+    for (size_t i = 0; i < n; ++i) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+        if (i % 2) {
+            sos_init_format(&strs[i], "Mozilla/5.0 (Platform %u; rv:%u) Engine/%u Build/%06x", (unsigned)(x % 40), (unsigned)(x >> 8) % 120,
+                            (unsigned)(x >> 16) % 700, (unsigned)(x >> 40) & 0xffffff);
+        } else {
+            sos_init_format(&strs[i], "%s%u.%s-%u.%s.%s", words[x % 10], (unsigned)(x >> 8) % 100000, words[(x >> 24) % 10],
+                            (unsigned)(x >> 28) % 1000, words[(x >> 40) % 10], tlds[(x >> 48) % 5]);
+        }
+    }
+
+    uint64_t t0 = bench_now_ns();
+    SosNgramIndex* const serial = sos_ngram_index_create();
+    BENCH_CHECK(serial && sos_ngram_index_add(serial, NULL, strs, n) == SOS_OK);
+    const uint64_t serial_ns = bench_now_ns() - t0;
+    sos_ngram_index_destroy(serial);
+
+    SosPool* const pool = sos_pool_create(threads);
+    BENCH_CHECK(pool);
+    t0 = bench_now_ns();
+    SosNgramIndex* const index = sos_ngram_index_create();
+    BENCH_CHECK(index && sos_ngram_index_add(index, pool, strs, n) == SOS_OK);
+    const uint64_t parallel_ns = bench_now_ns() - t0;
+
+    printf("%zu strings, %.1f bytes/string indexed\n", n, (double)sos_ngram_index_memory(index) / n);
+    printf("build: %.0f ms on 1 thread, %.0f ms on %u threads\n", serial_ns / 1e6, parallel_ns / 1e6, sos_pool_size(pool));
+    printf("%-24s %10s %14s %14s\n", "needle", "matches", "scan us", "index us");
+
+    static const char* const needles[] = {"mail4242.", "Build/00ab", "edge77.auth-1", "rv:119) Engine/69", "us-east-42.", "eu-west", "co.uk", "zzz"};
+    for (size_t q = 0; q < sizeof(needles) / sizeof(needles[0]); ++q) {
+        const SosView needle = {.data = needles[q], .len = strlen(needles[q])};
+        t0 = bench_now_ns();
+        const size_t expected = scan_count(strs, n, needle);
+        const uint64_t scan_ns = bench_now_ns() - t0;
+
+        enum { ROUNDS = 20 };
+        size_t found = 0;
+        t0 = bench_now_ns();
+        for (int r = 0; r < ROUNDS; ++r) {
+            found = 0;
+            BENCH_CHECK(sos_ngram_index_search(index, needle, count_visitor, &found) == SOS_OK);
+        }
+        const uint64_t index_ns = (bench_now_ns() - t0) / ROUNDS;
+        BENCH_CHECK(found == expected);
+        printf("%-24s %10zu %14.1f %14.1f\n", needles[q], found, scan_ns / 1e3, index_ns / 1e3);
+    }
+
+    sos_ngram_index_destroy(index);
+    sos_pool_destroy(pool);
+    for (size_t i = 0; i < n; ++i) {
+        sos_finish(&strs[i]);
+    }
+    free(strs);
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Scaling of parallel bulk operations from 1 to N threads.
+// Usage: bench_parallel [count] [max_threads]
+
+#include "bench.h"
+#include <sos_pool.h>
+#include <sos_sort.h>
+
+static void
+lower_fn(Sos* str, void* ctx)
+{
+    (void)ctx;
+    sos_to_lower(str);
+}
+
+int main(int argc, char** argv)
+{
+    const size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 4000000;
+    unsigned max_threads = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 10) : 0;
+    if (max_threads == 0) {
+        SosPool* const probe = sos_pool_create(0);
+        BENCH_CHECK(probe);
+        max_threads = sos_pool_size(probe);
+        sos_pool_destroy(probe);
+    }
+
+    Sos* const arr = malloc(n * sizeof(Sos));
+    Sos* const copy = malloc(n * sizeof(Sos));
+    uint64_t* const hashes = malloc(n * sizeof(uint64_t));
+    unsigned char* const bitmap = malloc((n + 7) / 8);
+    BENCH_CHECK(arr && copy && hashes && bitmap);
+    uint32_t rng = 3;
+    for (size_t i = 0; i < n; ++i) {
+        rng = rng * 1664525u + 1013904223u;
+        BENCH_CHECK(sos_init_format(&arr[i], "User-Agent/%u (Platform %u) Engine/%u", rng >> 20, (rng >> 8) & 0xff, rng & 0xff) == SOS_OK);
+    }
+
+    printf("%zu strings\n", n);
+    printf("%8s %12s %12s %12s %12s\n", "threads", "hash ms", "lower ms", "utf8 ms", "sort ms");
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        SosPool* const pool = sos_pool_create(threads);
+        BENCH_CHECK(pool);
+
+        uint64_t t0 = bench_now_ns();
+        sos_parallel_hash(pool, arr, n, hashes);
+        const uint64_t hash_ns = bench_now_ns() - t0;
+
+        t0 = bench_now_ns();
+        sos_parallel_for_each(pool, arr, n, lower_fn, NULL);
+        const uint64_t lower_ns = bench_now_ns() - t0;
+
+        t0 = bench_now_ns();
+        sos_parallel_utf8_validate(pool, arr, n, bitmap);
+        const uint64_t utf8_ns = bench_now_ns() - t0;
+
+        for (size_t i = 0; i < n; ++i) {
+            BENCH_CHECK(sos_init_by_copy(&copy[i], &arr[i]) == SOS_OK);
+        }
+        t0 = bench_now_ns();
+        BENCH_CHECK(sos_sort_parallel(pool, copy, n) == SOS_OK);
+        const uint64_t sort_ns = bench_now_ns() - t0;
+        for (size_t i = 0; i < n; ++i) {
+            sos_finish(&copy[i]);
+        }
+
+        printf("%8u %12.2f %12.2f %12.2f %12.2f\n", sos_pool_size(pool), hash_ns / 1e6, lower_ns / 1e6, utf8_ns / 1e6, sort_ns / 1e6);
+        sos_pool_destroy(pool);
+        if (threads * 2 > max_threads && threads != max_threads) {
+            threads = max_threads / 2; // Finish with max_threads
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        sos_finish(&arr[i]);
+    }
+    free(arr);
+    free(copy);
+    free(hashes);
+    free(bitmap);
+    return 0;
+}
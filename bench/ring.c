@@ -0,0 +1,166 @@
+// Contention of log producers handing lines to one writer: SosRing against a mutex-protected queue.
+// Usage: bench_ring [lines]
+//
+// Producers format lines into their own Sos and hand them over; the consumer writes batches to /dev/null.
+
+#include "bench.h"
+#include "../sos_ring.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "../sos_io.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define QUEUE_CAP 4096
+#define BATCH 256
+
+// Baseline: bounded array queue under a mutex
+typedef struct {
+    pthread_mutex_t lock;
+    Sos    slots[QUEUE_CAP];
+    size_t head;
+    size_t len;
+} LockedQueue;
+
+static bool
+locked_push(LockedQueue* q, Sos* s)
+{
+    pthread_mutex_lock(&q->lock);
+    const bool ok = q->len < QUEUE_CAP;
+    if (ok) {
+        sos_init_by_move(&q->slots[(q->head + q->len) % QUEUE_CAP], s);
+        q->len += 1;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return ok;
+}
+
+static size_t
+locked_pop_batch(LockedQueue* q, Sos* out, size_t max)
+{
+    pthread_mutex_lock(&q->lock);
+    size_t n = 0;
+    for (; n < max && q->len > 0; ++n) {
+        sos_init_by_move(&out[n], &q->slots[q->head]);
+        q->head = (q->head + 1) % QUEUE_CAP;
+        q->len -= 1;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return n;
+}
+
+typedef struct {
+    SosRing*     ring;
+    LockedQueue* queue;
+    unsigned     id;
+    size_t       lines;
+} Producer;
+
+static void
+format_line(Sos* s, unsigned id, size_t i)
+{
+    sos_init_format(s, "ts=%zu worker=%u level=info msg=\"request served\" status=200\n", i, id);
+}
+
+static void*
+produce(void* arg)
+{
+    const Producer* const p = arg;
+    for (size_t i = 0; i < p->lines; ++i) {
+        Sos s;
+        format_line(&s, p->id, i);
+        if (p->ring) {
+            while (sos_ring_push(p->ring, &s) != SOS_OK) {
+                sched_yield();
+            }
+        } else {
+            while (!locked_push(p->queue, &s)) {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+static double
+run(unsigned producers, size_t lines, bool use_ring, int fd)
+{
+    SosRing* const ring = use_ring ? sos_ring_create(QUEUE_CAP) : NULL;
+    LockedQueue* const queue = use_ring ? NULL : calloc(1, sizeof(LockedQueue));
+    BENCH_CHECK(use_ring ? ring != NULL : queue != NULL);
+    if (queue) {
+        pthread_mutex_init(&queue->lock, NULL);
+    }
+
+    pthread_t* const threads = malloc(producers * sizeof(pthread_t));
+    Producer* const args = malloc(producers * sizeof(Producer));
+    BENCH_CHECK(threads && args);
+    const size_t per = lines / producers;
+    const size_t total = per * producers;
+
+    const uint64_t t0 = bench_now_ns();
+    for (unsigned t = 0; t < producers; ++t) {
+        args[t] = (Producer) {ring, queue, t, per};
+        BENCH_CHECK(pthread_create(&threads[t], NULL, produce, &args[t]) == 0);
+    }
+    Sos batch[BATCH];
+    size_t done = 0;
+    while (done < total) {
+        size_t n;
+        if (ring) {
+            BENCH_CHECK(sos_ring_write_fd(ring, fd, BATCH, &n) == SOS_OK);
+        } else {
+            n = locked_pop_batch(queue, batch, BATCH);
+            BENCH_CHECK(sos_writev_fd(fd, batch, n) == SOS_OK);
+            for (size_t i = 0; i < n; ++i) {
+                sos_finish(&batch[i]);
+            }
+        }
+        if (n == 0) {
+            sched_yield();
+        }
+        done += n;
+    }
+    for (unsigned t = 0; t < producers; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+    const uint64_t ns = bench_now_ns() - t0;
+
+    if (queue) {
+        pthread_mutex_destroy(&queue->lock);
+    }
+    free(queue);
+    sos_ring_destroy(ring);
+    free(args);
+    free(threads);
+    return (double)total * 1e3 / ns; // Mlines/s
+}
+
+int main(int argc, char** argv)
+{
+    const size_t lines = argc > 1 ? strtoull(argv[1], NULL, 10) : 2000000;
+    const int fd = open("/dev/null", O_WRONLY);
+    BENCH_CHECK(fd >= 0);
+
+    printf("%-10s %16s %16s\n", "producers", "mutex Mlines/s", "ring Mlines/s");
+    for (unsigned p = 1; p <= 64; p *= 2) {
+        const double locked = run(p, lines, false, fd);
+        const double ring = run(p, lines, true, fd);
+        printf("%-10u %16.2f %16.2f\n", p, locked, ring);
+    }
+    close(fd);
+    return 0;
+}
+
+#else
+
+int main(void)
+{
+    puts("bench_ring needs POSIX threads");
+    return 0;
+}
+
+#endif
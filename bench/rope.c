@@ -0,0 +1,82 @@
+// Random edit workload on a large document: flat Sos vs SosRope.
+// Usage: bench_rope [document_bytes] [edits]
+
+#include "bench.h"
+#include <sos_rope.h>
+#include <string.h>
+
+static uint32_t
+next_rand(uint32_t* state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t doc_len = argc > 1 ? strtoull(argv[1], NULL, 10) : (size_t)16 << 20;
+    const size_t edits = argc > 2 ? strtoull(argv[2], NULL, 10) : 20000;
+
+    char* const doc = malloc(doc_len);
+    BENCH_CHECK(doc);
+    for (size_t i = 0; i < doc_len; ++i) {
+        doc[i] = (char)('a' + i % 26);
+    }
+    static const char patch[64] = "{{template expansion result}} patched text ...................";
+
+    // Flat string
+    Sos flat;
+    BENCH_CHECK(sos_init_from_range(&flat, doc, doc_len) == SOS_OK);
+    uint32_t rng = 1;
+    uint64_t t0 = bench_now_ns();
+    for (size_t i = 0; i < edits; ++i) {
+        const size_t len = sos_len(&flat);
+        const size_t pos = next_rand(&rng) % (len + 1);
+        const size_t count = 1 + next_rand(&rng) % sizeof(patch);
+        if (next_rand(&rng) % 2 == 0 && count <= len - pos) {
+            char* const data = sos_cstr_mut(&flat);
+            memmove(data + pos, data + pos + count, len - pos - count);
+            sos_resize(&flat, len - count, 0);
+        } else {
+            BENCH_CHECK(sos_expand_for_overwrite(&flat, count).status == SOS_OK);
+            char* const data = sos_cstr_mut(&flat);
+            memmove(data + pos + count, data + pos, len - pos);
+            memcpy(data + pos, patch, count);
+        }
+    }
+    const uint64_t flat_ns = bench_now_ns() - t0;
+
+    // Rope
+    SosRope rope;
+    BENCH_CHECK(sos_rope_init_from_range(&rope, doc, doc_len) == SOS_OK);
+    rng = 1;
+    t0 = bench_now_ns();
+    for (size_t i = 0; i < edits; ++i) {
+        const size_t len = sos_rope_len(&rope);
+        const size_t pos = next_rand(&rng) % (len + 1);
+        const size_t count = 1 + next_rand(&rng) % sizeof(patch);
+        if (next_rand(&rng) % 2 == 0 && count <= len - pos) {
+            BENCH_CHECK(sos_rope_erase(&rope, pos, count) == SOS_OK);
+        } else {
+            BENCH_CHECK(sos_rope_insert(&rope, pos, patch, count) == SOS_OK);
+        }
+    }
+    const uint64_t rope_ns = bench_now_ns() - t0;
+
+    t0 = bench_now_ns();
+    Sos flattened;
+    BENCH_CHECK(sos_rope_flatten(&rope, &flattened) == SOS_OK);
+    const uint64_t flatten_ns = bench_now_ns() - t0;
+    BENCH_CHECK(sos_eq(&flattened, &flat));
+
+    printf("document: %zu bytes, %zu random edits of 1-%zu bytes\n", doc_len, edits, sizeof(patch));
+    printf("flat: %10.1f ns/edit\n", (double)flat_ns / edits);
+    printf("rope: %10.1f ns/edit\n", (double)rope_ns / edits);
+    printf("rope flatten: %.3f ms\n", flatten_ns / 1e6);
+
+    sos_finish(&flattened);
+    sos_rope_finish(&rope);
+    sos_finish(&flat);
+    free(doc);
+    return 0;
+}
@@ -0,0 +1,139 @@
+#ifndef SOS_BENCH_SDSLITE_H
+#define SOS_BENCH_SDSLITE_H
+
+// A minimal string library in the style of SDS (Simple Dynamic Strings), as a baseline for bench_suite.
+// Strings are `char*` to the chars, preceded by a header with length and allocated size.
+// Growth follows SDS: double the needed length below 1 MiB, add 1 MiB above.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef SDSL_MALLOC
+#define SDSL_MALLOC(n) malloc(n)
+#define SDSL_REALLOC(p, n) realloc((p), (n))
+#define SDSL_FREE(p) free(p)
+#endif
+
+#define SDSL_MAX_PREALLOC (1024 * 1024)
+
+typedef char* sdsl;
+
+typedef struct {
+    size_t len;
+    size_t alloc; // Excluding header and null terminator
+} SdslHeader;
+
+#define SDSL_HDR(s) ((SdslHeader*)((s) - sizeof(SdslHeader)))
+
+static sdsl
+sdsl_newlen(const void* init, size_t len)
+{
+    SdslHeader* const h = (SdslHeader*)SDSL_MALLOC(sizeof(SdslHeader) + len + 1);
+    if (!h) {
+        return NULL;
+    }
+    h->len = len;
+    h->alloc = len;
+    sdsl const s = (char*)(h + 1);
+    if (len) {
+        memcpy(s, init, len);
+    }
+    s[len] = 0;
+    return s;
+}
+
+static sdsl
+sdsl_empty(void)
+{
+    return sdsl_newlen("", 0);
+}
+
+static size_t
+sdsl_len(const sdsl s)
+{
+    return SDSL_HDR(s)->len;
+}
+
+static void
+sdsl_free(sdsl s)
+{
+    if (s) {
+        SDSL_FREE(SDSL_HDR(s));
+    }
+}
+
+static sdsl
+sdsl_make_room(sdsl s, size_t add)
+{
+    SdslHeader* h = SDSL_HDR(s);
+    if (h->alloc - h->len >= add) {
+        return s;
+    }
+    size_t newlen = h->len + add;
+    newlen = newlen < SDSL_MAX_PREALLOC ? newlen * 2 : newlen + SDSL_MAX_PREALLOC;
+    h = (SdslHeader*)SDSL_REALLOC(h, sizeof(SdslHeader) + newlen + 1);
+    if (!h) {
+        return NULL;
+    }
+    h->alloc = newlen;
+    return (char*)(h + 1);
+}
+
+static sdsl
+sdsl_catlen(sdsl s, const void* t, size_t len)
+{
+    s = sdsl_make_room(s, len);
+    if (!s) {
+        return NULL;
+    }
+    SdslHeader* const h = SDSL_HDR(s);
+    memcpy(s + h->len, t, len);
+    h->len += len;
+    s[h->len] = 0;
+    return s;
+}
+
+static sdsl
+sdsl_dup(const sdsl s)
+{
+    return sdsl_newlen(s, sdsl_len(s));
+}
+
+static int
+sdsl_cmp(const sdsl a, const sdsl b)
+{
+    const size_t la = sdsl_len(a);
+    const size_t lb = sdsl_len(b);
+    const int c = memcmp(a, b, la < lb ? la : lb);
+    return c != 0 ? c : (la > lb) - (la < lb);
+}
+
+static sdsl
+sdsl_catprintf(sdsl s, const char* fmt, ...)
+{
+    // Like SDS, try a stack buffer first
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    const int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n < 0) {
+        return NULL;
+    }
+    if ((size_t)n < sizeof(buf)) {
+        return sdsl_catlen(s, buf, (size_t)n);
+    }
+    s = sdsl_make_room(s, (size_t)n);
+    if (!s) {
+        return NULL;
+    }
+    va_start(ap, fmt);
+    vsnprintf(s + sdsl_len(s), (size_t)n + 1, fmt, ap);
+    va_end(ap);
+    SDSL_HDR(s)->len += (size_t)n;
+    return s;
+}
+
+#endif // SOS_BENCH_SDSLITE_H
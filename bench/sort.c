@@ -0,0 +1,63 @@
+// Sort an array of strings: qsort() with sos_cmp vs sos_sort.
+// Usage: bench_sort [count]
+
+#include "bench.h"
+#include <sos_sort.h>
+
+static int
+qsort_cmp(const void* lhs, const void* rhs)
+{
+    return sos_cmp(lhs, rhs);
+}
+
+static void
+fill(Sos* arr, size_t n)
+{
+    static const char* const hosts[] = {"api", "www", "static", "cdn", "auth", "img"};
+    uint32_t rng = 7;
+    for (size_t i = 0; i < n; ++i) {
+        rng = rng * 1664525u + 1013904223u;
+        if (rng % 3 == 0) {
+            sos_init_format(&arr[i], "k%u", (unsigned)(rng >> 8));
+        } else {
+            sos_init_format(&arr[i], "https://%s.example.com/v1/items/%u", hosts[(rng >> 4) % 6], (unsigned)(rng >> 8));
+        }
+    }
+}
+
+static void
+finish_all(Sos* arr, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        sos_finish(&arr[i]);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+    Sos* const arr = malloc(n * sizeof(Sos));
+    BENCH_CHECK(arr);
+
+    fill(arr, n);
+    uint64_t t0 = bench_now_ns();
+    qsort(arr, n, sizeof(Sos), qsort_cmp);
+    const uint64_t qsort_ns = bench_now_ns() - t0;
+    finish_all(arr, n);
+
+    fill(arr, n);
+    t0 = bench_now_ns();
+    BENCH_CHECK(sos_sort(arr, n) == SOS_OK);
+    const uint64_t sort_ns = bench_now_ns() - t0;
+    for (size_t i = 1; i < n; ++i) {
+        BENCH_CHECK(sos_cmp(&arr[i - 1], &arr[i]) <= 0);
+    }
+    finish_all(arr, n);
+
+    printf("%zu strings\n", n);
+    printf("qsort + sos_cmp: %8.1f ms\n", qsort_ns / 1e6);
+    printf("sos_sort:        %8.1f ms\n", sort_ns / 1e6);
+
+    free(arr);
+    return 0;
+}
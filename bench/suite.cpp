@@ -0,0 +1,566 @@
+// Benchmark suite: Sos against std::string, a plain malloc'd char* and an SDS-style baseline.
+// Reports ns/op, allocations/op and peak RSS, as a table and optionally as CSV or JSON.
+// Usage: bench_suite [--filter SUBSTR] [--scale X] [--csv FILE] [--json FILE]
+//
+// Peak RSS is the high-water mark of the whole process so far. Use --filter to measure one benchmark on its own.
+
+#include "bench.h"
+#include "../sos_sort.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// Allocation counting
+// std::string through operator new, char* and SDS through counted_malloc, Sos through its allocation hooks.
+
+static uint64_t g_allocs;
+
+void* operator new(std::size_t size)
+{
+    ++g_allocs;
+    void* const p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+static void*
+counted_malloc(size_t size)
+{
+    ++g_allocs;
+    return std::malloc(size);
+}
+
+static void*
+counted_realloc(void* p, size_t size)
+{
+    ++g_allocs;
+    return std::realloc(p, size);
+}
+
+#define SDSL_MALLOC(n) counted_malloc(n)
+#define SDSL_REALLOC(p, n) counted_realloc((p), (n))
+#define SDSL_FREE(p) std::free(p)
+#include "sdslite.h"
+
+static void
+hook_alloc(void*, void*, size_t, const char*)
+{
+    ++g_allocs;
+}
+
+static void
+hook_realloc(void*, void*, size_t, void*, size_t, const char*)
+{
+    ++g_allocs;
+}
+
+static long
+peak_rss_kib()
+{
+#ifndef _WIN32
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // Bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
+
+// Implementations
+// Each provides the same static functions on uninitialized storage (init*) or live strings.
+
+struct SosImpl {
+    using Str = Sos;
+    static constexpr const char* name = "sos";
+    static void init(Str* s, const char* p, size_t n) { BENCH_CHECK(sos_init_from_range(s, p, n) == SOS_OK); }
+    static void init_empty(Str* s) { sos_init(s); }
+    static void init_copy(Str* s, const Str* src) { BENCH_CHECK(sos_init_by_copy(s, src) == SOS_OK); }
+    static void init_format(Str* s, const char* key, int id) { BENCH_CHECK(sos_init_format(s, "%s:%d", key, id) == SOS_OK); }
+    static void push(Str* s, char c) { BENCH_CHECK(sos_push(s, c) == SOS_OK); }
+    static void append(Str* s, const char* p, size_t n) { BENCH_CHECK(sos_append_range(s, p, n) == SOS_OK); }
+    static int cmp(const Str* a, const Str* b) { return sos_cmp(a, b); }
+    static uint64_t hash(const Str* s) { return sos_hash(s); }
+    static size_t len(const Str* s) { return sos_len(s); }
+    static void finish(Str* s) { sos_finish(s); }
+    static void sort(Str* arr, size_t n) { sos_sort(arr, n); }
+};
+
+struct StdImpl {
+    using Str = std::string;
+    static constexpr const char* name = "std::string";
+    static void init(Str* s, const char* p, size_t n) { new (s) std::string(p, n); }
+    static void init_empty(Str* s) { new (s) std::string(); }
+    static void init_copy(Str* s, const Str* src) { new (s) std::string(*src); }
+    static void init_format(Str* s, const char* key, int id)
+    {
+        char buf[64];
+        const int n = snprintf(buf, sizeof(buf), "%s:%d", key, id);
+        new (s) std::string(buf, (size_t)n);
+    }
+    static void push(Str* s, char c) { s->push_back(c); }
+    static void append(Str* s, const char* p, size_t n) { s->append(p, n); }
+    static int cmp(const Str* a, const Str* b) { return a->compare(*b); }
+    static uint64_t hash(const Str* s) { return std::hash<std::string>()(*s); }
+    static size_t len(const Str* s) { return s->size(); }
+    static void finish(Str* s) { s->~basic_string(); }
+    static void sort(Str* arr, size_t n) { std::sort(arr, arr + n); }
+};
+
+// Plain char* with its length, reallocated to the exact size on every change, as typical C code does.
+struct CStr {
+    char*  data;
+    size_t len;
+};
+
+struct CStrImpl {
+    using Str = CStr;
+    static constexpr const char* name = "char*";
+    static void init(Str* s, const char* p, size_t n)
+    {
+        s->data = (char*)counted_malloc(n + 1);
+        BENCH_CHECK(s->data);
+        memcpy(s->data, p, n);
+        s->data[n] = 0;
+        s->len = n;
+    }
+    static void init_empty(Str* s) { init(s, "", 0); }
+    static void init_copy(Str* s, const Str* src) { init(s, src->data, src->len); }
+    static void init_format(Str* s, const char* key, int id)
+    {
+        const int n = snprintf(NULL, 0, "%s:%d", key, id);
+        s->data = (char*)counted_malloc((size_t)n + 1);
+        BENCH_CHECK(s->data);
+        snprintf(s->data, (size_t)n + 1, "%s:%d", key, id);
+        s->len = (size_t)n;
+    }
+    static void push(Str* s, char c) { append(s, &c, 1); }
+    static void append(Str* s, const char* p, size_t n)
+    {
+        s->data = (char*)counted_realloc(s->data, s->len + n + 1);
+        BENCH_CHECK(s->data);
+        memcpy(s->data + s->len, p, n);
+        s->len += n;
+        s->data[s->len] = 0;
+    }
+    static int cmp(const Str* a, const Str* b)
+    {
+        const int c = memcmp(a->data, b->data, std::min(a->len, b->len));
+        return c != 0 ? c : (a->len > b->len) - (a->len < b->len);
+    }
+    static uint64_t hash(const Str* s) { return sos_hash_range(s->data, s->len); }
+    static size_t len(const Str* s) { return s->len; }
+    static void finish(Str* s) { std::free(s->data); }
+    static void sort(Str* arr, size_t n)
+    {
+        qsort(arr, n, sizeof(Str), [](const void* a, const void* b) { return cmp((const Str*)a, (const Str*)b); });
+    }
+};
+
+struct SdsImpl {
+    using Str = sdsl;
+    static constexpr const char* name = "sds-style";
+    static void init(Str* s, const char* p, size_t n) { BENCH_CHECK((*s = sdsl_newlen(p, n)) != NULL); }
+    static void init_empty(Str* s) { BENCH_CHECK((*s = sdsl_empty()) != NULL); }
+    static void init_copy(Str* s, const Str* src) { BENCH_CHECK((*s = sdsl_dup(*src)) != NULL); }
+    static void init_format(Str* s, const char* key, int id) { BENCH_CHECK((*s = sdsl_catprintf(sdsl_empty(), "%s:%d", key, id)) != NULL); }
+    static void push(Str* s, char c) { BENCH_CHECK((*s = sdsl_catlen(*s, &c, 1)) != NULL); }
+    static void append(Str* s, const char* p, size_t n) { BENCH_CHECK((*s = sdsl_catlen(*s, p, n)) != NULL); }
+    static int cmp(const Str* a, const Str* b) { return sdsl_cmp(*a, *b); }
+    static uint64_t hash(const Str* s) { return sos_hash_range(*s, sdsl_len(*s)); }
+    static size_t len(const Str* s) { return sdsl_len(*s); }
+    static void finish(Str* s) { sdsl_free(*s); }
+    static void sort(Str* arr, size_t n)
+    {
+        qsort(arr, n, sizeof(Str), [](const void* a, const void* b) { return sdsl_cmp(*(const sdsl*)a, *(const sdsl*)b); });
+    }
+};
+
+// Harness
+
+struct Result {
+    std::string bench;
+    std::string impl;
+    uint64_t    ops;
+    double      ns_per_op;
+    double      allocs_per_op;
+    long        peak_rss_kib;
+};
+
+struct Timer {
+    uint64_t ns = 0;
+    uint64_t allocs = 0;
+    uint64_t t0 = 0;
+    uint64_t a0 = 0;
+    void start()
+    {
+        a0 = g_allocs;
+        t0 = bench_now_ns();
+    }
+    void stop()
+    {
+        ns += bench_now_ns() - t0;
+        allocs += g_allocs - a0;
+    }
+};
+
+static std::vector<Result> g_results;
+static const char* g_filter = "";
+static uint64_t g_sink; // Keeps results alive
+
+// Storage for `n` strings, to be initialized by the benchmark
+template <class Impl>
+struct Array {
+    using Str = typename Impl::Str;
+    Str*   p;
+    size_t n;
+    explicit Array(size_t count) : p((Str*)std::malloc(count * sizeof(Str) + 1)), n(count) { BENCH_CHECK(p); }
+    ~Array() { std::free(p); }
+    Array(const Array&) = delete;
+    Array& operator=(const Array&) = delete;
+    Str& operator[](size_t i) { return p[i]; }
+    void finish_all()
+    {
+        for (size_t i = 0; i < n; ++i) {
+            Impl::finish(&p[i]);
+        }
+    }
+};
+
+// Storage for one string, to be initialized by the benchmark
+template <class Impl>
+struct Slot {
+    using Str = typename Impl::Str;
+    alignas(Str) unsigned char buf[sizeof(Str)];
+    Str* get() { return reinterpret_cast<Str*>(buf); }
+};
+
+// Run `body(timer)` three times, keep the fastest
+template <class Impl, class Body>
+static void
+measure(const char* bench, uint64_t ops, Body body)
+{
+    const std::string full = std::string(bench) + "/" + Impl::name;
+    if (!strstr(full.c_str(), g_filter)) {
+        return;
+    }
+    Timer best;
+    for (int rep = 0; rep < 3; ++rep) {
+        Timer t;
+        body(t);
+        if (rep == 0 || t.ns < best.ns) {
+            best = t;
+        }
+    }
+    g_results.push_back(Result{bench, Impl::name, ops, (double)best.ns / ops, (double)best.allocs / ops, peak_rss_kib()});
+    const Result& r = g_results.back();
+    printf("%-14s %-12s %10.2f ns/op %8.3f allocs/op %8.1f MiB peak\n", r.bench.c_str(), r.impl.c_str(), r.ns_per_op,
+           r.allocs_per_op, r.peak_rss_kib / 1024.0);
+    fflush(stdout);
+}
+
+static const char short_text[] = "short text";                                                   // 10 chars
+static const char long_text[] = "a longer text that does not fit in any small buffer, 60 chars"; // 61 chars
+
+template <class Impl>
+static void
+micro(size_t n)
+{
+    measure<Impl>("init_short", n, [&](Timer& t) {
+        Array<Impl> arr(n);
+        t.start();
+        for (size_t i = 0; i < n; ++i) {
+            Impl::init(&arr[i], short_text, sizeof(short_text) - 1);
+        }
+        t.stop();
+        arr.finish_all();
+    });
+    measure<Impl>("init_long", n, [&](Timer& t) {
+        Array<Impl> arr(n);
+        t.start();
+        for (size_t i = 0; i < n; ++i) {
+            Impl::init(&arr[i], long_text, sizeof(long_text) - 1);
+        }
+        t.stop();
+        arr.finish_all();
+    });
+
+    const size_t push_len = 256;
+    measure<Impl>("push", n / push_len * push_len, [&](Timer& t) {
+        Array<Impl> arr(n / push_len);
+        for (size_t i = 0; i < arr.n; ++i) {
+            Impl::init_empty(&arr[i]);
+        }
+        t.start();
+        for (size_t i = 0; i < arr.n; ++i) {
+            for (size_t j = 0; j < push_len; ++j) {
+                Impl::push(&arr[i], (char)('a' + j % 26));
+            }
+        }
+        t.stop();
+        arr.finish_all();
+    });
+
+    const size_t pieces = 256; // of 16 bytes
+    measure<Impl>("append", n / pieces * pieces, [&](Timer& t) {
+        Array<Impl> arr(n / pieces);
+        for (size_t i = 0; i < arr.n; ++i) {
+            Impl::init_empty(&arr[i]);
+        }
+        t.start();
+        for (size_t i = 0; i < arr.n; ++i) {
+            for (size_t j = 0; j < pieces; ++j) {
+                Impl::append(&arr[i], long_text + j % 32, 16);
+            }
+        }
+        t.stop();
+        arr.finish_all();
+    });
+
+    measure<Impl>("format", n, [&](Timer& t) {
+        Array<Impl> arr(n);
+        t.start();
+        for (size_t i = 0; i < n; ++i) {
+            Impl::init_format(&arr[i], "user", (int)i);
+        }
+        t.stop();
+        arr.finish_all();
+    });
+
+    for (int long_src = 0; long_src < 2; ++long_src) {
+        measure<Impl>(long_src ? "copy_long" : "copy_short", n, [&](Timer& t) {
+            Slot<Impl> src;
+            if (long_src) {
+                Impl::init(src.get(), long_text, sizeof(long_text) - 1);
+            } else {
+                Impl::init(src.get(), short_text, sizeof(short_text) - 1);
+            }
+            Array<Impl> arr(n);
+            t.start();
+            for (size_t i = 0; i < n; ++i) {
+                Impl::init_copy(&arr[i], src.get());
+            }
+            t.stop();
+            arr.finish_all();
+            Impl::finish(src.get());
+        });
+    }
+
+    // Strings sharing a prefix, compared to their neighbour
+    const size_t m = 4096;
+    Array<Impl> keys(m);
+    for (size_t i = 0; i < m; ++i) {
+        char buf[64];
+        const int len = snprintf(buf, sizeof(buf), "customer/%08zu/orders", i * 2654435761u % 100000000);
+        Impl::init(&keys[i], buf, (size_t)len);
+    }
+    measure<Impl>("compare", n, [&](Timer& t) {
+        int acc = 0;
+        t.start();
+        for (size_t i = 0; i < n; ++i) {
+            acc += Impl::cmp(&keys[i % m], &keys[(i + 1) % m]) < 0;
+        }
+        t.stop();
+        g_sink += (uint64_t)acc;
+    });
+    measure<Impl>("hash", n, [&](Timer& t) {
+        uint64_t acc = 0;
+        t.start();
+        for (size_t i = 0; i < n; ++i) {
+            acc ^= Impl::hash(&keys[i % m]);
+        }
+        t.stop();
+        g_sink += acc;
+    });
+    keys.finish_all();
+
+    measure<Impl>("finish", n, [&](Timer& t) {
+        Array<Impl> arr(n);
+        for (size_t i = 0; i < n; ++i) {
+            if (i % 2) {
+                Impl::init(&arr[i], long_text, sizeof(long_text) - 1);
+            } else {
+                Impl::init(&arr[i], short_text, sizeof(short_text) - 1);
+            }
+        }
+        t.start();
+        arr.finish_all();
+        t.stop();
+    });
+}
+
+// Synthetic access log, one request per line
+static std::string
+make_corpus(size_t lines)
+{
+    static const char* const levels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+    static const char* const paths[] = {"/", "/api/v1/users", "/api/v1/orders/checkout", "/static/app.js", "/healthz"};
+    std::string corpus;
+    corpus.reserve(lines * 120);
+    char buf[256];
+    for (size_t i = 0; i < lines; ++i) {
+        const int n = snprintf(buf, sizeof(buf), "2024-05-%02zu %02zu:%02zu:%02zu %s service=gateway path=%s%s status=%d latency_ms=%zu\n",
+                               1 + i % 28, i / 3600 % 24, i / 60 % 60, i % 60, levels[i % 4], paths[i % 5],
+                               i % 3 ? "" : "?session=0123456789abcdef", i % 7 ? 200 : 503, i * 37 % 2000);
+        corpus.append(buf, (size_t)n);
+    }
+    return corpus;
+}
+
+template <class Impl>
+static void
+macro(size_t n, const std::string& corpus, size_t tokens)
+{
+    measure<Impl>("tokenize", tokens, [&](Timer& t) {
+        Array<Impl> arr(tokens);
+        t.start();
+        size_t count = 0;
+        const char* p = corpus.data();
+        const char* const end = p + corpus.size();
+        while (p < end) {
+            const char* q = p;
+            while (*q != ' ' && *q != '\n') {
+                ++q;
+            }
+            Impl::init(&arr[count++], p, (size_t)(q - p));
+            p = q + 1;
+        }
+        arr.finish_all();
+        t.stop();
+        BENCH_CHECK(count == tokens);
+    });
+
+    // Cache keys like "tenant:42:user:1234567:profile", built piecewise and hashed
+    measure<Impl>("build_keys", n, [&](Timer& t) {
+        uint64_t acc = 0;
+        t.start();
+        for (size_t i = 0; i < n; ++i) {
+            char num[24];
+            Slot<Impl> key;
+            Impl::init(key.get(), "tenant:", 7);
+            Impl::append(key.get(), num, (size_t)snprintf(num, sizeof(num), "%zu", i % 97));
+            Impl::append(key.get(), ":user:", 6);
+            Impl::append(key.get(), num, (size_t)snprintf(num, sizeof(num), "%zu", i));
+            Impl::append(key.get(), ":profile", 8);
+            acc ^= Impl::hash(key.get());
+            Impl::finish(key.get());
+        }
+        t.stop();
+        g_sink += acc;
+    });
+
+    measure<Impl>("sort_column", n, [&](Timer& t) {
+        Array<Impl> arr(n);
+        for (size_t i = 0; i < n; ++i) {
+            char buf[96];
+            const int len = snprintf(buf, sizeof(buf), "https://example.com/%s/%zu", i % 3 ? "item" : "category/item",
+                                     i * 2654435761u % 1000003);
+            Impl::init(&arr[i], buf, (size_t)len);
+        }
+        t.start();
+        Impl::sort(arr.p, n);
+        t.stop();
+        for (size_t i = 1; i < n; i += n / 64 + 1) {
+            BENCH_CHECK(Impl::cmp(&arr[i - 1], &arr[i]) <= 0);
+        }
+        arr.finish_all();
+    });
+}
+
+static void
+write_csv(const char* path)
+{
+    FILE* const f = fopen(path, "w");
+    BENCH_CHECK(f);
+    fprintf(f, "bench,impl,ops,ns_per_op,allocs_per_op,peak_rss_kib\n");
+    for (const Result& r : g_results) {
+        fprintf(f, "%s,%s,%llu,%.3f,%.4f,%ld\n", r.bench.c_str(), r.impl.c_str(), (unsigned long long)r.ops, r.ns_per_op,
+                r.allocs_per_op, r.peak_rss_kib);
+    }
+    fclose(f);
+}
+
+static void
+write_json(const char* path)
+{
+    FILE* const f = fopen(path, "w");
+    BENCH_CHECK(f);
+    fprintf(f, "[\n");
+    for (size_t i = 0; i < g_results.size(); ++i) {
+        const Result& r = g_results[i];
+        fprintf(f, "  {\"bench\": \"%s\", \"impl\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.3f, \"allocs_per_op\": %.4f, \"peak_rss_kib\": %ld}%s\n",
+                r.bench.c_str(), r.impl.c_str(), (unsigned long long)r.ops, r.ns_per_op, r.allocs_per_op, r.peak_rss_kib,
+                i + 1 < g_results.size() ? "," : "");
+    }
+    fprintf(f, "]\n");
+    fclose(f);
+}
+
+int main(int argc, char** argv)
+{
+    double scale = 1.0;
+    const char* csv = NULL;
+    const char* json = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+            g_filter = argv[++i];
+        } else if (!strcmp(argv[i], "--scale") && i + 1 < argc) {
+            scale = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--csv") && i + 1 < argc) {
+            csv = argv[++i];
+        } else if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+            json = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--filter SUBSTR] [--scale X] [--csv FILE] [--json FILE]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    static const SosAllocHooks hooks = {hook_alloc, hook_realloc, NULL, NULL};
+    sos_set_alloc_hooks(&hooks);
+    g_results.reserve(256);
+
+    const size_t n = (size_t)(1000000 * scale) + 1;
+    micro<SosImpl>(n);
+    micro<StdImpl>(n);
+    micro<CStrImpl>(n);
+    micro<SdsImpl>(n);
+
+    const std::string corpus = make_corpus(n / 5);
+    const size_t tokens = (size_t)std::count_if(corpus.begin(), corpus.end(), [](char c) { return c == ' ' || c == '\n'; });
+    macro<SosImpl>(n, corpus, tokens);
+    macro<StdImpl>(n, corpus, tokens);
+    macro<CStrImpl>(n, corpus, tokens);
+    macro<SdsImpl>(n, corpus, tokens);
+
+    if (csv) {
+        write_csv(csv);
+    }
+    if (json) {
+        write_json(json);
+    }
+    return g_sink == 42 ? 1 : 0;
+}
@@ -0,0 +1,226 @@
+// Ordered index of path-like keys: SosTree against a red-black tree comparing with sos_cmp.
+// Usage: bench_tree [keys]
+
+#include "bench.h"
+#include "../sos_tree.h"
+#include "../sos_sort.h"
+#include <string.h>
+
+// Left-leaning red-black tree, as a conventional ordered map
+typedef struct RbNode {
+    Sos            key;
+    void*          value;
+    struct RbNode* left;
+    struct RbNode* right;
+    bool           red;
+} RbNode;
+
+static size_t rb_bytes;
+
+static bool
+is_red(const RbNode* n)
+{
+    return n && n->red;
+}
+
+static RbNode*
+rotate_left(RbNode* h)
+{
+    RbNode* const x = h->right;
+    h->right = x->left;
+    x->left = h;
+    x->red = h->red;
+    h->red = true;
+    return x;
+}
+
+static RbNode*
+rotate_right(RbNode* h)
+{
+    RbNode* const x = h->left;
+    h->left = x->right;
+    x->right = h;
+    x->red = h->red;
+    h->red = true;
+    return x;
+}
+
+static RbNode*
+rb_insert(RbNode* h, const Sos* key, void* value)
+{
+    if (!h) {
+        RbNode* const n = calloc(1, sizeof(RbNode));
+        BENCH_CHECK(n);
+        BENCH_CHECK(sos_init_by_copy(&n->key, key) == SOS_OK);
+        n->value = value;
+        n->red = true;
+        rb_bytes += sizeof(RbNode) + (sos_cap(&n->key) >= SOS_SBO_BUFSIZE ? sos_cap(&n->key) + 1 : 0);
+        return n;
+    }
+    const int c = sos_cmp(key, &h->key);
+    if (c < 0) {
+        h->left = rb_insert(h->left, key, value);
+    } else if (c > 0) {
+        h->right = rb_insert(h->right, key, value);
+    } else {
+        h->value = value;
+    }
+    if (is_red(h->right) && !is_red(h->left)) {
+        h = rotate_left(h);
+    }
+    if (is_red(h->left) && is_red(h->left->left)) {
+        h = rotate_right(h);
+    }
+    if (is_red(h->left) && is_red(h->right)) {
+        h->red = !h->red;
+        h->left->red = !h->left->red;
+        h->right->red = !h->right->red;
+    }
+    return h;
+}
+
+static const RbNode*
+rb_find(const RbNode* n, const Sos* key)
+{
+    while (n) {
+        const int c = sos_cmp(key, &n->key);
+        if (c == 0) {
+            return n;
+        }
+        n = c < 0 ? n->left : n->right;
+    }
+    return NULL;
+}
+
+// Count keys starting with `prefix`, visiting the subtrees that may hold them
+static size_t
+rb_count_prefix(const RbNode* n, const Sos* prefix)
+{
+    if (!n) {
+        return 0;
+    }
+    const int c = strncmp(sos_cstr(&n->key), sos_cstr(prefix), sos_len(prefix));
+    if (c < 0) {
+        return rb_count_prefix(n->right, prefix);
+    } else if (c > 0) {
+        return rb_count_prefix(n->left, prefix);
+    }
+    return 1 + rb_count_prefix(n->left, prefix) + rb_count_prefix(n->right, prefix);
+}
+
+static void
+rb_free(RbNode* n)
+{
+    if (n) {
+        rb_free(n->left);
+        rb_free(n->right);
+        sos_finish(&n->key);
+        free(n);
+    }
+}
+
+static bool
+count_visitor(SosTreeEntry* entry, void* ctx)
+{
+    (void)entry;
+    *(size_t*)ctx += 1;
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    const size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+
+    Sos* const keys = malloc(n * sizeof(Sos));
+    size_t* const probe = malloc(n * sizeof(size_t));
+    BENCH_CHECK(keys && probe);
+    uint64_t x = 0x9E3779B97F4A7C15u;
+    for (size_t i = 0; i < n; ++i) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+        sos_init_format(&keys[i], "/var/lib/app/shard%03u/user%07zu/obj%u", (unsigned)(x % 256), i, (unsigned)(x >> 32) % 100);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+        probe[i] = x % n;
+    }
+
+    // Build
+    uint64_t t0 = bench_now_ns();
+    RbNode* rb = NULL;
+    for (size_t i = 0; i < n; ++i) {
+        rb = rb_insert(rb, &keys[i], (void*)(uintptr_t)i);
+        rb->red = false;
+    }
+    const uint64_t rb_build = bench_now_ns() - t0;
+
+    t0 = bench_now_ns();
+    SosTree art;
+    sos_tree_init(&art);
+    for (size_t i = 0; i < n; ++i) {
+        BENCH_CHECK(sos_tree_insert(&art, sos_view(&keys[i]), (void*)(uintptr_t)i) == SOS_OK);
+    }
+    const uint64_t art_build = bench_now_ns() - t0;
+
+    // Lookup
+    t0 = bench_now_ns();
+    uintptr_t rb_sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        rb_sum += (uintptr_t)rb_find(rb, &keys[probe[i]])->value;
+    }
+    const uint64_t rb_lookup = bench_now_ns() - t0;
+
+    t0 = bench_now_ns();
+    uintptr_t art_sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        art_sum += (uintptr_t)sos_tree_find(&art, sos_view(&keys[probe[i]]))->value;
+    }
+    const uint64_t art_lookup = bench_now_ns() - t0;
+    BENCH_CHECK(rb_sum == art_sum);
+
+    // Prefix scans over each shard
+    t0 = bench_now_ns();
+    size_t rb_scanned = 0;
+    for (unsigned s = 0; s < 256; ++s) {
+        Sos prefix;
+        sos_init_format(&prefix, "/var/lib/app/shard%03u/", s);
+        rb_scanned += rb_count_prefix(rb, &prefix);
+        sos_finish(&prefix);
+    }
+    const uint64_t rb_scan = bench_now_ns() - t0;
+
+    t0 = bench_now_ns();
+    size_t art_scanned = 0;
+    for (unsigned s = 0; s < 256; ++s) {
+        Sos prefix;
+        sos_init_format(&prefix, "/var/lib/app/shard%03u/", s);
+        sos_tree_scan_prefix(&art, sos_view(&prefix), count_visitor, &art_scanned);
+        sos_finish(&prefix);
+    }
+    const uint64_t art_scan = bench_now_ns() - t0;
+    BENCH_CHECK(rb_scanned == n && art_scanned == n);
+    const size_t art_bytes = sos_tree_memory(&art);
+    sos_tree_finish(&art);
+
+    // Bulk load from sorted keys
+    BENCH_CHECK(sos_sort(keys, n) == SOS_OK);
+    t0 = bench_now_ns();
+    BENCH_CHECK(sos_tree_init_from_sorted(&art, keys, NULL, n) == SOS_OK);
+    const uint64_t art_bulk = bench_now_ns() - t0;
+    const size_t bulk_bytes = sos_tree_memory(&art);
+    sos_tree_finish(&art);
+
+    printf("%zu keys            %12s %12s\n", n, "rb+sos_cmp", "SosTree");
+    printf("insert (ns/key)     %12.1f %12.1f\n", (double)rb_build / n, (double)art_build / n);
+    printf("bulk load (ns/key)  %12s %12.1f\n", "-", (double)art_bulk / n);
+    printf("lookup (ns/key)     %12.1f %12.1f\n", (double)rb_lookup / n, (double)art_lookup / n);
+    printf("prefix scan (ns/key)%12.1f %12.1f\n", (double)rb_scan / n, (double)art_scan / n);
+    printf("memory (bytes/key)  %12.1f %12.1f (bulk %.1f)\n", (double)rb_bytes / n, (double)art_bytes / n, (double)bulk_bytes / n);
+
+    rb_free(rb);
+    for (size_t i = 0; i < n; ++i) {
+        sos_finish(&keys[i]);
+    }
+    free(probe);
+    free(keys);
+    return 0;
+}
@@ -1,7 +1,13 @@
+#if defined(SOS_MMAP_THRESHOLD) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // mremap, MAP_ANONYMOUS
+#endif
+
 #include "sos.h"
+#include "sos_internal.h"
 #include <string.h> // memcpy, strlen, strcmp
 #include <stdint.h> // SIZE_MAX
 #include <limits.h>
+#include <inttypes.h>
 #include <assert.h>
 #include <stdio.h>  // vsnprintf
 #include <stdarg.h>
@@ -12,11 +18,415 @@
 #define sos_realloc(p, s) realloc((p), (s))
 #define sos_free(p) free((p))
 
+// Memory mapping for very large strings
+// Long-mode buffers of at-least SOS_MMAP_THRESHOLD bytes are mapped with mmap(), and grown with mremap() where available.
+// Being mapped is solely determined by capacity, so capacities of mapped buffers are always (multiple of page size) - 1.
+#if defined(SOS_MMAP_THRESHOLD) && SOS_MMAP_THRESHOLD > 0
+#if SOS_MMAP_THRESHOLD < 65536
+#error "SOS_MMAP_THRESHOLD must be at-least 64 KiB"
+#endif
+#define SOS_USE_MMAP 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#define SOS_THREAD_LOCAL __declspec(thread)
+#else
+#define SOS_THREAD_LOCAL __thread
+#endif
+
+// Static tracepoints (USDT), for perf, bpftrace or SystemTap
+#ifdef SOS_HAVE_SDT
+#include <sys/sdt.h>
+#define SOS_PROBE2(name, a, b) DTRACE_PROBE2(sos, name, a, b)
+#define SOS_PROBE3(name, a, b, c) DTRACE_PROBE3(sos, name, a, b, c)
+#define SOS_PROBE4(name, a, b, c, d) DTRACE_PROBE4(sos, name, a, b, c, d)
+#else
+#define SOS_PROBE2(name, a, b) ((void)0)
+#define SOS_PROBE3(name, a, b, c) ((void)0)
+#define SOS_PROBE4(name, a, b, c, d) ((void)0)
+#endif
+
+// Statistics, see sos_stats_snapshot()
+#ifdef SOS_STATS
+static SosStats stats;
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SOS_STAT(field, n) _InterlockedExchangeAdd64((volatile __int64*)&stats.field, (__int64)(n))
+#else
+#define SOS_STAT(field, n) __atomic_fetch_add(&stats.field, (uint64_t)(n), __ATOMIC_RELAXED)
+#endif
+#else
+#define SOS_STAT(field, n) ((void)0)
+#endif
+
 // TODO: check for cap/size
 
 #define SOS_MAX_LEN (SIZE_MAX - 2) // buffer len = str cap + 1, plus cap must be odd
 #define SOS_MAX_LEN_FOR_EXPAND ((SOS_MAX_LEN - 1) / 2)
 
+// Per-thread cache of long-mode buffers.
+// Buffers are bucketed by capacity classes 2^k - 1, matching the growth sequence of sos_push (31, 63, 127, ...).
+// A free buffer is kept in the bucket of the largest class it can hold, and serves requests up to that class.
+
+#define SOS_CACHE_MIN_SHIFT   5 // smallest class: 31
+#define SOS_CACHE_NUM_CLASSES 8 // largest class: 4095
+
+typedef struct {
+    char*  heads[SOS_CACHE_NUM_CLASSES]; // Singly-linked free lists, the link is stored in the buffer itself
+    size_t limit;                        // Zero means the cache is disabled
+    size_t bytes;
+    size_t hits;
+    size_t misses;
+} SosBufCache;
+
+static SOS_THREAD_LOCAL SosBufCache tls_cache;
+
+// Allocator of the calling thread, see sos_set_thread_allocator()
+static SOS_THREAD_LOCAL const SosAllocator* tls_allocator;
+
+static size_t
+class_cap(unsigned idx)
+{
+    return ((size_t)1 << (idx + SOS_CACHE_MIN_SHIFT)) - 1;
+}
+
+/**
+ * Index of the smallest class able to hold `cap`, or SOS_CACHE_NUM_CLASSES if there is none.
+ */
+static unsigned
+class_ceil(size_t cap)
+{
+    unsigned idx = 0;
+    while (idx < SOS_CACHE_NUM_CLASSES && class_cap(idx) < cap) {
+        ++idx;
+    }
+    return idx;
+}
+
+/**
+ * Index of the largest class that fits in a buffer of capacity `cap`, or SOS_CACHE_NUM_CLASSES if there is none.
+ */
+static unsigned
+class_floor(size_t cap)
+{
+    if (cap < class_cap(0) || cap > class_cap(SOS_CACHE_NUM_CLASSES - 1) * 2) {
+        return SOS_CACHE_NUM_CLASSES;
+    }
+    unsigned idx = SOS_CACHE_NUM_CLASSES - 1;
+    while (class_cap(idx) > cap) {
+        --idx;
+    }
+    return idx;
+}
+
+static char*
+cache_pop(unsigned idx)
+{
+    char* const buf = tls_cache.heads[idx];
+    if (buf) {
+        memcpy(&tls_cache.heads[idx], buf, sizeof(char*));
+        tls_cache.bytes -= class_cap(idx) + 1;
+    }
+    return buf;
+}
+
+#ifdef SOS_USE_MMAP
+
+static bool
+is_mapped(size_t cap)
+{
+    return cap >= SOS_MMAP_THRESHOLD - 1;
+}
+
+/**
+ * Round up the buffer size for capacity `cap`, to multiple of page size.
+ *
+ * @return The rounded capacity
+ */
+static size_t
+mapped_cap(size_t cap)
+{
+    static size_t page_size;
+    if (page_size == 0) {
+        page_size = (size_t)sysconf(_SC_PAGESIZE);
+    }
+    return ((cap + page_size) & ~(page_size - 1)) - 1;
+}
+
+static void
+advise_mapped(char* data, size_t size)
+{
+#if defined(SOS_MMAP_HUGEPAGE) && defined(MADV_HUGEPAGE)
+    madvise(data, size, MADV_HUGEPAGE);
+#else
+    (void)data; (void)size;
+#endif
+}
+
+static char*
+map_alloc(size_t* cap)
+{
+    *cap = mapped_cap(*cap);
+    void* const data = mmap(NULL, *cap + 1, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+    advise_mapped(data, *cap + 1);
+    return data;
+}
+
+/**
+ * Grow or shrink a mapped buffer, keeping it mapped.
+ */
+static char*
+map_realloc(char* data, size_t len, size_t old_cap, size_t* cap)
+{
+    if (*cap > old_cap && old_cap / 2 <= SOS_MAX_LEN - old_cap) {
+        // Grow geometrically. Only address space is reserved, pages are not committed until touched.
+        const size_t cap_geo = old_cap + old_cap / 2;
+        if (cap_geo > *cap) {
+            *cap = cap_geo;
+        }
+    }
+    *cap = mapped_cap(*cap);
+#ifdef MREMAP_MAYMOVE
+    (void)len;
+    void* const data_new = mremap(data, old_cap + 1, *cap + 1, MREMAP_MAYMOVE);
+    if (data_new == MAP_FAILED) {
+        return NULL;
+    }
+    advise_mapped(data_new, *cap + 1);
+    return data_new;
+#else
+    char* const data_new = map_alloc(cap);
+    if (!data_new) {
+        return NULL;
+    }
+    memcpy(data_new, data, len + 1);
+    munmap(data, old_cap + 1);
+    return data_new;
+#endif
+}
+
+#endif // SOS_USE_MMAP
+
+/**
+ * Allocate a buffer for a long-mode string with capacity of at-least `*cap`.
+ *
+ * @pre `*cap` is odd.
+ * @post On success, `*cap` holds the actual capacity, which is odd.
+ */
+static char*
+buf_alloc_raw(size_t* cap)
+{
+    if (tls_allocator) {
+        return tls_allocator->alloc(tls_allocator->ctx, *cap + 1);
+    }
+#ifdef SOS_USE_MMAP
+    if (is_mapped(*cap)) {
+        return map_alloc(cap);
+    }
+#endif
+    if (tls_cache.limit != 0) {
+        const unsigned idx = class_ceil(*cap);
+        if (idx < SOS_CACHE_NUM_CLASSES) {
+            // Round up to the class, so the buffer can be recycled later.
+            *cap = class_cap(idx);
+            char* const buf = cache_pop(idx);
+            if (buf) {
+                tls_cache.hits += 1;
+                return buf;
+            }
+            tls_cache.misses += 1;
+        }
+    }
+    return sos_malloc(*cap + 1);
+}
+
+/**
+ * Release a long-mode buffer of capacity `cap`.
+ */
+static void
+buf_free_raw(char* data, size_t cap)
+{
+    if (tls_allocator) {
+        tls_allocator->free(tls_allocator->ctx, data, cap + 1);
+        return;
+    }
+#ifdef SOS_USE_MMAP
+    if (is_mapped(cap)) {
+        munmap(data, cap + 1);
+        return;
+    }
+#endif
+    if (tls_cache.limit != 0) {
+        const unsigned idx = class_floor(cap);
+        if (idx < SOS_CACHE_NUM_CLASSES && tls_cache.bytes + class_cap(idx) + 1 <= tls_cache.limit) {
+            memcpy(data, &tls_cache.heads[idx], sizeof(char*));
+            tls_cache.heads[idx] = data;
+            tls_cache.bytes += class_cap(idx) + 1;
+            return;
+        }
+    }
+    sos_free(data);
+}
+
+/**
+ * Resize a long-mode buffer holding `len` chars, to capacity of at-least `*cap`.
+ *
+ * @pre `*cap` is odd and >= `len`.
+ * @post On success, `*cap` holds the actual capacity. On failure, `data` is untouched.
+ */
+static char*
+buf_realloc_raw(char* data, size_t len, size_t old_cap, size_t* cap)
+{
+    if (tls_allocator) {
+        char* const data_new = buf_alloc_raw(cap);
+        if (!data_new) {
+            return NULL;
+        }
+        memcpy(data_new, data, len + 1);
+        buf_free_raw(data, old_cap);
+        return data_new;
+    }
+#ifdef SOS_USE_MMAP
+    if (is_mapped(old_cap) && is_mapped(*cap)) {
+        return map_realloc(data, len, old_cap, cap);
+    }
+    if (is_mapped(old_cap) || is_mapped(*cap)) {
+        // Crossing the threshold, move between heap and mapping
+        char* const data_new = buf_alloc_raw(cap);
+        if (!data_new) {
+            return NULL;
+        }
+        memcpy(data_new, data, len + 1);
+        buf_free_raw(data, old_cap);
+        return data_new;
+    }
+#endif
+    if (tls_cache.limit != 0 && (class_ceil(*cap) < SOS_CACHE_NUM_CLASSES || class_floor(old_cap) < SOS_CACHE_NUM_CLASSES)) {
+        const unsigned idx = class_ceil(*cap);
+        if (*cap <= old_cap && idx < SOS_CACHE_NUM_CLASSES && class_cap(idx) >= old_cap) {
+            // Shrinking within the same class
+            *cap = old_cap;
+            return data;
+        }
+        char* const data_new = buf_alloc_raw(cap);
+        if (!data_new) {
+            return NULL;
+        }
+        memcpy(data_new, data, len + 1);
+        buf_free_raw(data, old_cap);
+        return data_new;
+    }
+    return sos_realloc(data, *cap + 1);
+}
+
+const SosAllocator* sos_set_thread_allocator(const SosAllocator* allocator)
+{
+    const SosAllocator* const prev = tls_allocator;
+    tls_allocator = allocator;
+    return prev;
+}
+
+// Allocation hooks, see sos_set_alloc_hooks()
+static const SosAllocHooks* alloc_hooks;
+
+static const SosAllocHooks*
+load_hooks(void)
+{
+#if defined(_MSC_VER)
+    return *(const SosAllocHooks* const volatile*)&alloc_hooks;
+#else
+    return __atomic_load_n(&alloc_hooks, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void sos_set_alloc_hooks(const SosAllocHooks* hooks)
+{
+#if defined(_MSC_VER)
+    *(const SosAllocHooks* volatile*)&alloc_hooks = hooks;
+#else
+    __atomic_store_n(&alloc_hooks, hooks, __ATOMIC_RELEASE);
+#endif
+}
+
+static void
+trace_alloc(void* data, size_t size, const char* site)
+{
+    const SosAllocHooks* const hooks = load_hooks();
+    if (hooks && hooks->on_alloc) {
+        hooks->on_alloc(hooks->ctx, data, size, site);
+    }
+}
+
+static void
+trace_free(void* data, size_t size, const char* site)
+{
+    const SosAllocHooks* const hooks = load_hooks();
+    if (hooks && hooks->on_free) {
+        hooks->on_free(hooks->ctx, data, size, site);
+    }
+}
+
+// Allocation entry points of the string functions, which report to the hooks.
+// `site` names the library function that allocates, callers pass __func__.
+
+static char*
+buf_alloc(size_t* cap, const char* site)
+{
+    char* const data = buf_alloc_raw(cap);
+    if (data) {
+        trace_alloc(data, *cap + 1, site);
+    }
+    return data;
+}
+
+static void
+buf_free(char* data, size_t cap, const char* site)
+{
+    trace_free(data, cap + 1, site);
+    buf_free_raw(data, cap);
+}
+
+static char*
+buf_realloc(char* data, size_t len, size_t old_cap, size_t* cap, const char* site)
+{
+    char* const data_new = buf_realloc_raw(data, len, old_cap, cap);
+    if (data_new && (data_new != data || *cap != old_cap)) {
+        const SosAllocHooks* const hooks = load_hooks();
+        if (hooks && hooks->on_realloc) {
+            hooks->on_realloc(hooks->ctx, data, old_cap + 1, data_new, *cap + 1, site);
+        }
+    }
+    return data_new;
+}
+
+void sos_cache_set_limit(size_t bytes)
+{
+    tls_cache.limit = bytes;
+    if (tls_cache.bytes > bytes) {
+        sos_cache_flush();
+    }
+}
+
+void sos_cache_flush(void)
+{
+    for (unsigned idx = 0; idx < SOS_CACHE_NUM_CLASSES; ++idx) {
+        char* buf;
+        while ((buf = cache_pop(idx)) != NULL) {
+            sos_free(buf);
+        }
+    }
+}
+
+SosCacheStats sos_cache_stats(void)
+{
+    return (SosCacheStats) {.hits = tls_cache.hits, .misses = tls_cache.misses, .cached_bytes = tls_cache.bytes, .limit = tls_cache.limit};
+}
+
 static int
 is_long(const Sos* self)
 {
@@ -89,9 +499,113 @@ SosViewMut sos_view_mut(Sos* self)
     return (SosViewMut) {.data = self->repr.s.data, .len = short_len(self)};
 }
 
+#ifdef SOS_STATS
+static void
+stat_finish(const Sos* self)
+{
+    // Bucket by bit width of the length
+    size_t len = sos_len(self);
+    unsigned bucket = 0;
+    while (len != 0) {
+        len >>= 1;
+        ++bucket;
+    }
+    SOS_STAT(finish_len_log2[bucket], 1);
+    if (is_long(self)) {
+        SOS_STAT(frees, 1);
+    }
+}
+
+static uint64_t
+stat_load(const uint64_t* counter)
+{
+#if defined(_MSC_VER)
+    return (uint64_t)_InterlockedCompareExchange64((volatile __int64*)counter, 0, 0);
+#else
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+#endif
+}
+
+static void
+stat_clear(uint64_t* counter)
+{
+#if defined(_MSC_VER)
+    _InterlockedExchange64((volatile __int64*)counter, 0);
+#else
+    __atomic_store_n(counter, 0, __ATOMIC_RELAXED);
+#endif
+}
+
+// Apply X to each scalar counter
+#define SOS_STATS_COUNTERS(X) X(short_inits) X(long_inits) X(short_to_long) X(reallocs) X(frees) X(bytes_copied)
+#else
+#define stat_finish(self) ((void)0)
+#endif
+
+void sos_stats_snapshot(SosStats* out)
+{
+    memset(out, 0, sizeof(*out));
+#ifdef SOS_STATS
+    out->enabled = true;
+#define SOS_STAT_LOAD(field) out->field = stat_load(&stats.field);
+    SOS_STATS_COUNTERS(SOS_STAT_LOAD)
+#undef SOS_STAT_LOAD
+    for (unsigned i = 0; i < SOS_STATS_HIST_BUCKETS; ++i) {
+        out->finish_len_log2[i] = stat_load(&stats.finish_len_log2[i]);
+    }
+#endif
+}
+
+void sos_stats_reset(void)
+{
+#ifdef SOS_STATS
+#define SOS_STAT_CLEAR(field) stat_clear(&stats.field);
+    SOS_STATS_COUNTERS(SOS_STAT_CLEAR)
+#undef SOS_STAT_CLEAR
+    for (unsigned i = 0; i < SOS_STATS_HIST_BUCKETS; ++i) {
+        stat_clear(&stats.finish_len_log2[i]);
+    }
+#endif
+}
+
+SosStatus sos_stats_format(const SosStats* stats, Sos* out)
+{
+    if (!stats->enabled) {
+        return sos_append_cstr(out, "sos statistics are disabled, build with SOS_ENABLE_STATS\n");
+    }
+    char line[128];
+    snprintf(line, sizeof(line),
+             "short inits   %" PRIu64 "\nlong inits    %" PRIu64 "\nshort to long %" PRIu64 "\n", stats->short_inits,
+             stats->long_inits, stats->short_to_long);
+    SosStatus ret = sos_append_cstr(out, line);
+    snprintf(line, sizeof(line), "reallocs      %" PRIu64 "\nfrees         %" PRIu64 "\nbytes copied  %" PRIu64 "\n",
+             stats->reallocs, stats->frees, stats->bytes_copied);
+    if (ret == SOS_OK) {
+        ret = sos_append_cstr(out, line);
+    }
+    if (ret == SOS_OK) {
+        ret = sos_append_cstr(out, "length at finish:\n");
+    }
+    for (unsigned i = 0; i < SOS_STATS_HIST_BUCKETS && ret == SOS_OK; ++i) {
+        if (stats->finish_len_log2[i] == 0) {
+            continue;
+        }
+        if (i == 0) {
+            snprintf(line, sizeof(line), "  %20s %" PRIu64 "\n", "0", stats->finish_len_log2[i]);
+        } else {
+            char range[64];
+            snprintf(range, sizeof(range), "%" PRIu64 "-%" PRIu64, (uint64_t)1 << (i - 1), i == 64 ? UINT64_MAX : ((uint64_t)1 << i) - 1);
+            snprintf(line, sizeof(line), "  %20s %" PRIu64 "\n", range, stats->finish_len_log2[i]);
+        }
+        ret = sos_append_cstr(out, line);
+    }
+    return ret;
+}
+
 void sos_init(Sos* self)
 {
     // We could not check here for unreleased self, since self can be uninitialized.
+    SOS_STAT(short_inits, 1);
     self->repr.s.len = 0;
     self->repr.s.data[0] = 0;
 }
@@ -100,13 +614,14 @@ SosStatus sos_init_with_cap(Sos* self, size_t cap)
 {
     if (cap + 1 > SOS_SBO_BUFSIZE) { // long
         cap |= 1u; // add 1 if cap is even
-        self->repr.l.data = sos_malloc(cap + 1);
+        self->repr.l.data = buf_alloc(&cap, __func__);
         if (!self->repr.l.data) {
             return SOS_ERROR_ALLOC;
         }
         self->repr.l.data[0] = 0;
         self->repr.l.len = 0;
         self->repr.l.cap = cap;
+        SOS_STAT(long_inits, 1);
     } else { // short
         sos_init(self);
     }
@@ -119,8 +634,8 @@ SosStatusAndBuf sos_init_for_overwrite(Sos* self, size_t len)
     SosStatusAndBuf ret;
 
     if (len + 1 > SOS_SBO_BUFSIZE) {
-        const size_t cap = len | 1u;
-        self->repr.l.data = sos_malloc(cap + 1);
+        size_t cap = len | 1u;
+        self->repr.l.data = buf_alloc(&cap, __func__);
         if (!self->repr.l.data) {
             ret.status = SOS_ERROR_ALLOC;
             return ret;
@@ -129,7 +644,9 @@ SosStatusAndBuf sos_init_for_overwrite(Sos* self, size_t len)
         self->repr.l.len = len;
         self->repr.l.cap = cap;
         ret.str = self->repr.l.data;
+        SOS_STAT(long_inits, 1);
     } else {
+        SOS_STAT(short_inits, 1);
         set_short_len(self, len);
         self->repr.s.data[len] = 0;
         ret.str = self->repr.s.data;
@@ -157,16 +674,19 @@ SosStatus sos_init_from_cstr(Sos* self, const char* str)
     if (count <= SOS_SBO_BUFSIZE - 1) {
         memcpy(self->repr.s.data, str, count + 1);
         set_short_len(self, count);
+        SOS_STAT(short_inits, 1);
         return SOS_OK;
     } else {
-        char* const data = sos_malloc((count | 1u) + 1);
+        size_t cap = count | 1u;
+        char* const data = buf_alloc(&cap, __func__);
         if (!data) {
             return SOS_ERROR_ALLOC;
         }
         memcpy(data, str, count + 1);
         self->repr.l.data = data;
         self->repr.l.len = count;
-        self->repr.l.cap = count | 1u;
+        self->repr.l.cap = cap;
+        SOS_STAT(long_inits, 1);
         return SOS_OK;
     }
 }
@@ -177,13 +697,34 @@ SosStatus sos_init_adopt_cstr(Sos* self, char* str)
 
     const size_t len = strlen(str);
     self->repr.l.len = len;
+#ifdef SOS_USE_MMAP
+    const bool copy = tls_allocator || is_mapped(len | 1u);
+#else
+    const bool copy = tls_allocator != NULL;
+#endif
+    if (copy) {
+        // The buffer has to come from the allocator or a mapping
+        size_t cap = len | 1u;
+        char* const data = buf_alloc(&cap, __func__);
+        if (!data) {
+            return SOS_ERROR_ALLOC;
+        }
+        memcpy(data, str, len + 1);
+        sos_free(str);
+        self->repr.l.cap = cap;
+        self->repr.l.data = data;
+        SOS_STAT(long_inits, 1);
+        return SOS_OK;
+    }
     // Enforce capacity
     char* const data = sos_realloc(str, (len | 1u) + 1);
     if (!data) {
         return SOS_ERROR_ALLOC;
     }
+    trace_alloc(data, (len | 1u) + 1, __func__);
     self->repr.l.cap = len | 1u;
     self->repr.l.data = data;
+    SOS_STAT(long_inits, 1);
     return SOS_OK;
 }
 
@@ -195,7 +736,8 @@ SosStatus sos_init_format(Sos* self, const char* fmt, ...)
     va_end(args);
 
     if (len + 1 > SOS_SBO_BUFSIZE) {
-        char* const data = sos_malloc((len | 1u) + 1);
+        size_t cap = len | 1u;
+        char* const data = buf_alloc(&cap, __func__);
         if (!data) {
             return SOS_ERROR_ALLOC;
         }
@@ -204,12 +746,14 @@ SosStatus sos_init_format(Sos* self, const char* fmt, ...)
         va_end(args);
         self->repr.l.data = data;
         self->repr.l.len = len;
-        self->repr.l.cap = len | 1u;
+        self->repr.l.cap = cap;
+        SOS_STAT(long_inits, 1);
     } else {
         va_start(args, fmt);
         vsnprintf(self->repr.s.data, len + 1, fmt, args);
         va_end(args);
         set_short_len(self, len);
+        SOS_STAT(short_inits, 1);
     }
 
     return SOS_OK;
@@ -217,8 +761,10 @@ SosStatus sos_init_format(Sos* self, const char* fmt, ...)
 
 void sos_finish(Sos* self)
 {
+    stat_finish(self);
+    SOS_PROBE2(finish, sos_len(self), sos_cap(self));
     if (is_long(self)) {
-        sos_free(self->repr.l.data);
+        buf_free(self->repr.l.data, self->repr.l.cap, __func__);
     }
     // Provide a safeguard, although self should not be used after sos_finish, unless re-initialized
     self->repr.s.len = 0;
@@ -228,6 +774,22 @@ void sos_finish(Sos* self)
 SosViewMut sos_release(Sos* self)
 {
     if (is_long(self)) {
+        // The buffer is no longer owned by a string
+        trace_free(self->repr.l.data, self->repr.l.cap + 1, __func__);
+#ifdef SOS_USE_MMAP
+        const bool copy = tls_allocator || is_mapped(self->repr.l.cap);
+#else
+        const bool copy = tls_allocator != NULL;
+#endif
+        if (copy) {
+            // The caller will free() the buffer, so one from the allocator or a mapping has to be copied to the heap.
+            char* const buf = sos_malloc(self->repr.l.len + 1);
+            if (buf) {
+                memcpy(buf, self->repr.l.data, self->repr.l.len + 1);
+                buf_free_raw(self->repr.l.data, self->repr.l.cap);
+            }
+            return (SosViewMut) { .data = buf, .len = self->repr.l.len };
+        }
         return (SosViewMut) { .data = self->repr.l.data, .len = self->repr.l.len };
     }
     // In short mode, we have to copy the short string to a new buffer.
@@ -255,16 +817,19 @@ void sos_clear(Sos* self)
  * @pre `cap` must be odd and >= current size; `self` must be in short mode
  */
 static SosStatus
-sos_short_to_long(Sos* self, size_t cap)
+sos_short_to_long(Sos* self, size_t cap, const char* site)
 {
     assert(!is_long(self) && cap % 2 == 1 && cap >= short_len(self));
 
-    char* const data_new = sos_malloc(cap + 1);
+    char* const data_new = buf_alloc(&cap, site);
     if (!data_new) {
         return SOS_ERROR_ALLOC;
     }
     const size_t len = short_len(self);
     memcpy(data_new, self->repr.s.data, len + 1);
+    SOS_STAT(short_to_long, 1);
+    SOS_STAT(bytes_copied, len + 1);
+    SOS_PROBE3(short_to_long, len, cap, site);
 
     self->repr.l.data = data_new;
     self->repr.l.len = len;
@@ -273,15 +838,18 @@ sos_short_to_long(Sos* self, size_t cap)
 }
 
 static SosStatus
-sos_reserve_long(Sos* self, size_t cap)
+sos_reserve_long(Sos* self, size_t cap, const char* site)
 {
     assert(is_long(self));
     if (cap > self->repr.l.cap) {
         cap |= 1u;
-        char* const data_new = sos_realloc(self->repr.l.data, cap + 1);
+        char* const data_new = buf_realloc(self->repr.l.data, self->repr.l.len, self->repr.l.cap, &cap, site);
         if (!data_new) {
             return SOS_ERROR_ALLOC;
         }
+        SOS_STAT(reallocs, 1);
+        SOS_STAT(bytes_copied, self->repr.l.len + 1);
+        SOS_PROBE4(reserve_long, self->repr.l.len, self->repr.l.cap, cap, site);
         self->repr.l.data = data_new;
         self->repr.l.cap = cap;
     }
@@ -292,10 +860,10 @@ sos_reserve_long(Sos* self, size_t cap)
 SosStatus sos_reserve(Sos* self, size_t cap)
 {
     if (is_long(self)) {
-        return sos_reserve_long(self, cap);
+        return sos_reserve_long(self, cap, __func__);
     } else if (cap + 1 > SOS_SBO_BUFSIZE) {
         cap |= 1u;
-        return sos_short_to_long(self, cap);
+        return sos_short_to_long(self, cap, __func__);
     }
 
     return SOS_OK;
@@ -305,7 +873,7 @@ SosStatus sos_resize(Sos* self, size_t len, char ch)
 {
     if (is_long(self)) {
         if (len > self->repr.l.len) { // This condition can be skipped.
-            const SosStatus ret = sos_reserve_long(self, len);
+            const SosStatus ret = sos_reserve_long(self, len, __func__);
             if (ret != SOS_OK) {
                 return ret;
             }
@@ -327,7 +895,7 @@ SosStatus sos_resize(Sos* self, size_t len, char ch)
             self->repr.s.data[len] = 0;
             set_short_len(self, len);
         } else {
-            const SosStatus ret = sos_short_to_long(self, len | 1u);
+            const SosStatus ret = sos_short_to_long(self, len | 1u, __func__);
             if (ret != SOS_OK) {
                 return ret;
             }
@@ -347,12 +915,17 @@ void sos_shrink_to_fit(Sos* self)
     if (!is_long(self)) {
         return;
     }
-    const size_t min_cap = self->repr.l.len | 1u;
+    size_t min_cap = self->repr.l.len | 1u;
     if (self->repr.l.cap > min_cap) {
-        char* const data_new = sos_realloc(self->repr.l.data, min_cap);
+        char* const data_new = buf_realloc(self->repr.l.data, self->repr.l.len, self->repr.l.cap, &min_cap, __func__);
         if (!data_new) {
             return;
         }
+        if (data_new != self->repr.l.data || min_cap != self->repr.l.cap) {
+            // The cache may hand back the same buffer when it stays within its size class
+            SOS_STAT(reallocs, 1);
+            SOS_STAT(bytes_copied, self->repr.l.len + 1);
+        }
         self->repr.l.data = data_new;
         self->repr.l.cap = min_cap;
     }
@@ -374,10 +947,12 @@ SosStatus sos_push(Sos* self, char c)
                     cap_new = 31;
                 }
             }
-            char* const data_new = sos_realloc(self->repr.l.data, cap_new + 1);
+            char* const data_new = buf_realloc(self->repr.l.data, self->repr.l.len, self->repr.l.cap, &cap_new, __func__);
             if (!data_new) {
                 return SOS_ERROR_ALLOC;
             }
+            SOS_STAT(reallocs, 1);
+            SOS_STAT(bytes_copied, self->repr.l.len + 1);
             self->repr.l.data = data_new;
             self->repr.l.cap = cap_new;
         }
@@ -387,7 +962,7 @@ SosStatus sos_push(Sos* self, char c)
     } else {
         const unsigned char len = short_len(self);
         if (len == SOS_SBO_BUFSIZE - 1) {
-            const SosStatus ret = sos_short_to_long(self, 31); //Should ensure SOS_SBO_BUFSIZE < 32(or else, and UCHAR_MAX) at compile time
+            const SosStatus ret = sos_short_to_long(self, 31, __func__); //Should ensure SOS_SBO_BUFSIZE < 32(or else, and UCHAR_MAX) at compile time
             if (ret != SOS_OK) {
                 return ret;
             }
@@ -434,7 +1009,7 @@ SosStatus sos_append_range(Sos* restrict self, const char* restrict begin, size_
             self->repr.s.len += (unsigned char)count << 1;
             return SOS_OK;
         } else {
-            const SosStatus ret = sos_short_to_long(self, (SOS_SBO_BUFSIZE + count) | 1u);
+            const SosStatus ret = sos_short_to_long(self, (SOS_SBO_BUFSIZE + count) | 1u, __func__);
             if (ret != SOS_OK) {
                 return ret;
             }
@@ -445,7 +1020,7 @@ SosStatus sos_append_range(Sos* restrict self, const char* restrict begin, size_
         }
     }
     // long mode
-    const SosStatus ret = sos_reserve_long(self, self->repr.l.len + count); //Check for max len
+    const SosStatus ret = sos_reserve_long(self, self->repr.l.len + count, __func__); //Check for max len
     if (ret != SOS_OK) {
         return ret;
     }
@@ -474,12 +1049,18 @@ SosStatus sos_init_by_copy(Sos* restrict self, const Sos* restrict rhs)
 {
     memcpy(self, rhs, sizeof(Sos));
     if (is_long(rhs)) {
-        char* const data = sos_malloc(rhs->repr.l.cap + 1);
+        size_t cap = rhs->repr.l.cap;
+        char* const data = buf_alloc(&cap, __func__);
         if (!data) {
             return SOS_ERROR_ALLOC;
         }
         memcpy(data, rhs->repr.l.data, rhs->repr.l.len + 1);
         self->repr.l.data = data;
+        self->repr.l.cap = cap;
+        SOS_STAT(long_inits, 1);
+        SOS_STAT(bytes_copied, rhs->repr.l.len + 1);
+    } else {
+        SOS_STAT(short_inits, 1);
     }
 
     return SOS_OK;
@@ -507,7 +1088,7 @@ SosStatusAndBuf sos_expand_for_overwrite(Sos* self, size_t count)
             self->repr.s.len += (unsigned char)count << 1;
             return (SosStatusAndBuf){.status = SOS_OK, .str = self->repr.s.data + len};
         } else {
-            const SosStatus ret = sos_short_to_long(self, (SOS_SBO_BUFSIZE + count) | 1u);
+            const SosStatus ret = sos_short_to_long(self, (SOS_SBO_BUFSIZE + count) | 1u, __func__);
             if (ret != SOS_OK) {
                 return (SosStatusAndBuf){.status = ret};
             }
@@ -517,7 +1098,7 @@ SosStatusAndBuf sos_expand_for_overwrite(Sos* self, size_t count)
         }
     }
     // long mode
-    const SosStatus ret = sos_reserve_long(self, self->repr.l.len + count); //Check for max len
+    const SosStatus ret = sos_reserve_long(self, self->repr.l.len + count, __func__); //Check for max len
     if (ret != SOS_OK) {
         return (SosStatusAndBuf){.status = ret};
     }
@@ -528,6 +1109,180 @@ SosStatusAndBuf sos_expand_for_overwrite(Sos* self, size_t count)
     return (SosStatusAndBuf){.status = SOS_OK, .str = str};;
 }
 
+// Batch construction
+
+// Bytes before the long fields in a bulk block
+#define MANY_HEADER sizeof(size_t)
+
+typedef struct {
+    Sos*   out;
+    size_t cap;
+    size_t count;
+    size_t long_bytes; // Bytes of the bulk block needed by long fields
+} ManyBuilder;
+
+/**
+ * Initialize the next string with the field [begin, end).
+ * Long fields temporarily point into the input, until they are moved into the bulk block.
+ */
+static void
+many_push(ManyBuilder* b, const char* begin, const char* end)
+{
+    Sos* const str = &b->out[b->count++];
+    const size_t len = (size_t)(end - begin);
+    if (len + 1 <= SOS_SBO_BUFSIZE) {
+        memcpy(str->repr.s.data, begin, len);
+        str->repr.s.data[len] = 0;
+        set_short_len(str, len);
+    } else {
+        str->repr.l.data = (char*)begin;
+        str->repr.l.len = len;
+        str->repr.l.cap = len | 1u;
+        b->long_bytes += (len | 1u) + 1;
+    }
+}
+
+/**
+ * Count initializations of the strings returned by a batch, once it can no longer fail.
+ */
+static void
+many_stat(const Sos* out, size_t count)
+{
+#ifdef SOS_STATS
+    for (size_t i = 0; i < count; ++i) {
+        if (is_long(&out[i])) {
+            SOS_STAT(long_inits, 1);
+        } else {
+            SOS_STAT(short_inits, 1);
+        }
+    }
+#else
+    (void)out; (void)count;
+#endif
+}
+
+/**
+ * Split input into fields, until input or output runs out.
+ *
+ * @return Number of bytes consumed.
+ */
+static size_t
+many_split(ManyBuilder* b, const char* buf, size_t len, char delim)
+{
+    const char* field = buf;
+    const char* const end = buf + len;
+    size_t pos = 0;
+
+#ifdef SOS_HAVE_SSE2
+    // Find delimiters 16 bytes at a time, then walk the bits of the match mask
+    const __m128i pattern = _mm_set1_epi8(delim);
+    for (; pos + 16 <= len && b->count < b->cap; pos += 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i*)(const void*)(buf + pos));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern));
+        while (mask != 0) {
+            const char* const delim_pos = buf + pos + count_trailing_zeros(mask);
+            many_push(b, field, delim_pos);
+            field = delim_pos + 1;
+            if (b->count == b->cap) {
+                return (size_t)(field - buf);
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    while (b->count < b->cap && field < end) {
+        const char* delim_pos = memchr(buf + pos, delim, (size_t)(end - (buf + pos)));
+        if (!delim_pos) {
+            delim_pos = end;
+        }
+        many_push(b, field, delim_pos);
+        field = delim_pos < end ? delim_pos + 1 : end;
+        pos = (size_t)(field - buf);
+    }
+    return (size_t)(field - buf);
+}
+
+/**
+ * Move long fields into `storage`, which holds at-least `size` bytes.
+ *
+ * @return Number of strings whose long fields fit in `storage`.
+ */
+static size_t
+many_place(Sos* out, size_t count, char* storage, size_t size)
+{
+    size_t used = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Sos* const str = &out[i];
+        if (!is_long(str)) {
+            continue;
+        }
+        const size_t bytes = str->repr.l.cap + 1;
+        if (bytes > size - used) {
+            return i;
+        }
+        char* const data = storage + used;
+        memcpy(data, str->repr.l.data, str->repr.l.len);
+        data[str->repr.l.len] = 0;
+        str->repr.l.data = data;
+        used += bytes;
+    }
+    return count;
+}
+
+SosManyResult sos_init_many_from_delimited(const char* buf, size_t len, char delim, Sos* out, size_t cap)
+{
+    ManyBuilder b = {.out = out, .cap = cap};
+    SosManyResult ret = {.status = SOS_OK};
+    ret.consumed = many_split(&b, buf, len, delim);
+    ret.count = b.count;
+    if (b.long_bytes > 0) {
+        // The block starts with its size, for sos_finish_many() to report to the hooks
+        const size_t size = MANY_HEADER + b.long_bytes;
+        ret.storage = sos_malloc(size);
+        if (!ret.storage) {
+            // Only short strings have been initialized, which hold no resources.
+            return (SosManyResult) {.status = SOS_ERROR_ALLOC};
+        }
+        memcpy(ret.storage, &size, sizeof(size));
+        trace_alloc(ret.storage, size, __func__);
+        many_place(out, b.count, ret.storage + MANY_HEADER, b.long_bytes);
+    }
+    many_stat(out, ret.count);
+    return ret;
+}
+
+SosManyResult sos_init_many_from_delimited_in(const char* buf, size_t len, char delim, Sos* out, size_t cap, char* arena, size_t arena_size)
+{
+    ManyBuilder b = {.out = out, .cap = cap};
+    SosManyResult ret = {.status = SOS_OK};
+    ret.consumed = many_split(&b, buf, len, delim);
+    ret.count = many_place(out, b.count, arena, arena_size);
+    if (ret.count < b.count) {
+        // The first long field that did not fit still points to its position in the input.
+        ret.consumed = (size_t)(out[ret.count].repr.l.data - buf);
+    }
+    many_stat(out, ret.count);
+    return ret;
+}
+
+void sos_finish_many(Sos* arr, size_t count, char* storage)
+{
+#ifdef SOS_STATS
+    for (size_t i = 0; i < count; ++i) {
+        stat_finish(&arr[i]);
+    }
+#else
+    (void)arr; (void)count;
+#endif
+    if (storage) {
+        size_t size;
+        memcpy(&size, storage, sizeof(size));
+        trace_free(storage, size, __func__);
+    }
+    sos_free(storage);
+}
+
 static bool
 eq_cstr(const char* lhs, const char* rhs)
 {
@@ -563,6 +1318,157 @@ bool sos_eq(const Sos* lhs, const Sos* rhs)
     return eq_cstr(v1.data, v2.data);
 }
 
+// Hashing, 64-bit variant of the MurmurHash3 scheme
+
+#define SOS_HASH_K1 0x87c37b91114253d5ull
+#define SOS_HASH_K2 0x4cf5ad432745937full
+
+static uint64_t
+rotl64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t
+fmix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return k;
+}
+
+static uint64_t
+hash_word(uint64_t h, uint64_t w)
+{
+    w *= SOS_HASH_K1;
+    w = rotl64(w, 31);
+    w *= SOS_HASH_K2;
+    h ^= w;
+    return rotl64(h, 27) * 5 + 0x52dce729;
+}
+
+uint64_t sos_hash_range(const char* begin, size_t count)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ull ^ (count * SOS_HASH_K2);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint64_t w;
+        memcpy(&w, begin + i, 8);
+        h = hash_word(h, w);
+    }
+    if (i < count) {
+        uint64_t w = 0;
+        memcpy(&w, begin + i, count - i);
+        h = hash_word(h, w);
+    }
+    return fmix64(h ^ count);
+}
+
+uint64_t sos_hash(const Sos* self)
+{
+    const SosView v = sos_view(self);
+    return sos_hash_range(v.data, v.len);
+}
+
+void sos_to_lower(Sos* self)
+{
+    const SosViewMut v = sos_view_mut(self);
+    for (size_t i = 0; i < v.len; ++i) {
+        if (v.data[i] >= 'A' && v.data[i] <= 'Z') {
+            v.data[i] += 'a' - 'A';
+        }
+    }
+}
+
+void sos_to_upper(Sos* self)
+{
+    const SosViewMut v = sos_view_mut(self);
+    for (size_t i = 0; i < v.len; ++i) {
+        if (v.data[i] >= 'a' && v.data[i] <= 'z') {
+            v.data[i] -= 'a' - 'A';
+        }
+    }
+}
+
+static bool
+is_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+void sos_trim(Sos* self)
+{
+    const SosViewMut v = sos_view_mut(self);
+    size_t begin = 0;
+    size_t end = v.len;
+    while (begin < end && is_space(v.data[begin])) {
+        ++begin;
+    }
+    while (end > begin && is_space(v.data[end - 1])) {
+        --end;
+    }
+    if (begin > 0) {
+        memmove(v.data, v.data + begin, end - begin);
+    }
+    sos_resize(self, end - begin, 0); // Shrinking never allocates
+}
+
+bool sos_is_utf8(const Sos* self)
+{
+    const SosView v = sos_view(self);
+    const unsigned char* const s = (const unsigned char*)v.data;
+    size_t i = 0;
+    while (i < v.len) {
+        // ASCII fast path
+        if (i + 8 <= v.len) {
+            uint64_t w;
+            memcpy(&w, s + i, 8);
+            if ((w & 0x8080808080808080ull) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+        const unsigned char c = s[i];
+        if (c < 0x80) {
+            i += 1;
+            continue;
+        }
+        size_t n;
+        unsigned char lo = 0x80, hi = 0xbf; // Valid range of the second byte
+        if (c >= 0xc2 && c <= 0xdf) {
+            n = 2;
+        } else if (c >= 0xe0 && c <= 0xef) {
+            n = 3;
+            if (c == 0xe0) {
+                lo = 0xa0; // Overlong
+            } else if (c == 0xed) {
+                hi = 0x9f; // Surrogates
+            }
+        } else if (c >= 0xf0 && c <= 0xf4) {
+            n = 4;
+            if (c == 0xf0) {
+                lo = 0x90; // Overlong
+            } else if (c == 0xf4) {
+                hi = 0x8f; // Above U+10FFFF
+            }
+        } else {
+            return false;
+        }
+        if (v.len - i < n || s[i + 1] < lo || s[i + 1] > hi) {
+            return false;
+        }
+        for (size_t k = 2; k < n; ++k) {
+            if ((s[i + k] & 0xc0) != 0x80) {
+                return false;
+            }
+        }
+        i += n;
+    }
+    return true;
+}
 
 #if 0
 
@@ -5,10 +5,14 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "sos_endian.h"
 
 #ifdef __cplusplus
+#define SOS_RESTRICT __restrict // Not a C++ keyword, but supported by GCC, Clang and MSVC
 extern "C" {
+#else
+#define SOS_RESTRICT restrict
 #endif
 
 // The least significant bit of cap indicates long/short mode
@@ -51,7 +55,9 @@ typedef struct {
 typedef enum {
     SOS_OK = 0,
     SOS_ERROR_ALLOC,
-    SOS_ERROR_MAX_CAP
+    SOS_ERROR_MAX_CAP,
+    SOS_ERROR_IO,     // errno is set by the failing system call
+    SOS_ERROR_INVALID // Malformed input
 } SosStatus;
 
 // A struct to hold status code along with pointer to string buffer.
@@ -61,6 +67,53 @@ typedef struct {
     char* str;
 } SosStatusAndBuf;
 
+// Counters of the per-thread buffer cache.
+typedef struct {
+    size_t hits;         // Allocations served from the cache
+    size_t misses;       // Cacheable allocations that fell through to malloc
+    size_t cached_bytes; // Bytes currently held by the cache
+    size_t limit;        // Upper bound of cached_bytes, zero if the cache is disabled
+} SosCacheStats;
+
+// Callbacks on allocation of long-mode buffers, see sos_set_alloc_hooks().
+// `site` is the name of the library function that allocates, e.g. "sos_push". Any callback may be NULL.
+typedef struct {
+    void (*on_alloc)(void* ctx, void* data, size_t size, const char* site);
+    void (*on_realloc)(void* ctx, void* old_data, size_t old_size, void* new_data, size_t new_size, const char* site);
+    void (*on_free)(void* ctx, void* data, size_t size, const char* site);
+    void* ctx;
+} SosAllocHooks;
+
+// Allocator of long-mode buffers for the calling thread, see sos_set_thread_allocator().
+// `alloc` returns NULL on failure. `free` receives the size passed to `alloc`.
+typedef struct {
+    void* (*alloc)(void* ctx, size_t size);
+    void (*free)(void* ctx, void* data, size_t size);
+    void* ctx;
+} SosAllocator;
+
+#define SOS_STATS_HIST_BUCKETS 65
+
+// Library-wide counters, collected when built with SOS_ENABLE_STATS.
+typedef struct {
+    bool     enabled;       // Whether statistics are compiled in
+    uint64_t short_inits;   // Strings initialized in short mode
+    uint64_t long_inits;    // Strings initialized in long mode
+    uint64_t short_to_long; // Transitions from short to long mode
+    uint64_t reallocs;      // Capacity changes of long-mode strings
+    uint64_t frees;         // Long-mode strings finished
+    uint64_t bytes_copied;  // Bytes copied by short-to-long transitions, reallocations and copy-construction
+    uint64_t finish_len_log2[SOS_STATS_HIST_BUCKETS]; // Lengths at finish: [0] empty, [k] in [2^(k-1), 2^k)
+} SosStats;
+
+// Result of batch construction from a delimited buffer.
+typedef struct {
+    SosStatus status;
+    size_t    count;    // Number of strings initialized
+    size_t    consumed; // Bytes of input consumed, including delimiters
+    char*     storage;  // Block holding all long strings, to be passed to sos_finish_many
+} SosManyResult;
+
 // Struct representing a mutable string view
 typedef struct {
     char* data;
@@ -205,7 +258,7 @@ SosViewMut sos_release(Sos* self);
 /**
  * Swap two strings.
  */
-void sos_swap(Sos* restrict s1, Sos* restrict s2);
+void sos_swap(Sos* SOS_RESTRICT s1, Sos* SOS_RESTRICT s2);
 
 /**
  * Initialize by copying from another.
@@ -214,7 +267,7 @@ void sos_swap(Sos* restrict s1, Sos* restrict s2);
  *      `rhs` is initialized.
  * @post On success, `self` is initialized by copying rhs.
  */
-SosStatus sos_init_by_copy(Sos* restrict self, const Sos* restrict rhs);
+SosStatus sos_init_by_copy(Sos* SOS_RESTRICT self, const Sos* SOS_RESTRICT rhs);
 
 /**
  * Initialize by moving from another.
@@ -224,7 +277,37 @@ SosStatus sos_init_by_copy(Sos* restrict self, const Sos* restrict rhs);
  * @post `self` is initialized by moving from `rhs`.
  *       `rhs` is uninitialized.
  */
-void sos_init_by_move(Sos* restrict self, Sos* restrict rhs);
+void sos_init_by_move(Sos* SOS_RESTRICT self, Sos* SOS_RESTRICT rhs);
+
+// Batch construction
+
+/**
+ * Initialize an array of strings by splitting a buffer on a delimiter.
+ * Short fields are stored inline, and all long fields are placed in one bulk allocation.
+ * A delimiter at the end of buffer does not produce a trailing empty field.
+ *
+ * @param[out] out Array of `cap` uninitialized strings.
+ * @return On success, `count` strings of `out` are initialized. If `consumed` is less than `len`,
+ *         `out` was filled up, and the remaining input can be processed by another call.
+ * @post Strings initialized by this function must not be finished individually, nor grown.
+ *       They are released together by sos_finish_many().
+ */
+SosManyResult sos_init_many_from_delimited(const char* buf, size_t len, char delim, Sos* out, size_t cap);
+
+/**
+ * Same as sos_init_many_from_delimited(), but long fields are placed in a caller-provided arena.
+ * If the arena fills up, fewer fields are processed, as indicated by `consumed`.
+ * The returned `storage` is always NULL, the arena must outlive the strings.
+ */
+SosManyResult sos_init_many_from_delimited_in(const char* buf, size_t len, char delim, Sos* out, size_t cap, char* arena, size_t arena_size);
+
+/**
+ * Release strings initialized by sos_init_many_from_delimited() in O(1).
+ *
+ * @param[in] storage The `storage` returned along with the strings.
+ * @post All `count` strings of `arr` are uninitialized.
+ */
+void sos_finish_many(Sos* arr, size_t count, char* storage);
 
 // Modifiers
 
@@ -271,17 +354,17 @@ char sos_pop(Sos* self);
 /**
  * Append another `sos` string.
  */
-SosStatus sos_append(Sos* restrict self, const Sos* restrict rhs);
+SosStatus sos_append(Sos* SOS_RESTRICT self, const Sos* SOS_RESTRICT rhs);
 
 /**
  * Append a C string.
  */
-SosStatus sos_append_cstr(Sos* restrict self, const char* restrict str);
+SosStatus sos_append_cstr(Sos* SOS_RESTRICT self, const char* SOS_RESTRICT str);
 
 /**
  * Append a contiguous range of chars.
  */
-SosStatus sos_append_range(Sos* restrict self, const char* restrict begin, size_t count);
+SosStatus sos_append_range(Sos* SOS_RESTRICT self, const char* SOS_RESTRICT begin, size_t count);
 
 /**
  * Enlarge the string, but does not initialize the expanded content.
@@ -314,6 +397,112 @@ int sos_cmp_cstr(const Sos* lhs, const char* str);
  */
 bool sos_eq(const Sos* lhs, const Sos* rhs);
 
+// Hashing
+
+/**
+ * Compute a 64-bit hash of a char range. The hash is not cryptographic.
+ */
+uint64_t sos_hash_range(const char* begin, size_t count);
+
+/**
+ * Compute a 64-bit hash of a string.
+ *
+ * @note Strings without embedded null bytes that are equal (sos_eq) have equal hashes.
+ *       All `len` chars are hashed, while sos_eq() stops at the first null byte.
+ */
+uint64_t sos_hash(const Sos* self);
+
+// Transformations and checks
+
+/**
+ * Convert ASCII letters to lower case, in place.
+ */
+void sos_to_lower(Sos* self);
+
+/**
+ * Convert ASCII letters to upper case, in place.
+ */
+void sos_to_upper(Sos* self);
+
+/**
+ * Remove leading and trailing ASCII whitespace, in place. Capacity is not modified.
+ */
+void sos_trim(Sos* self);
+
+/**
+ * Test if a string is well-formed UTF-8.
+ * Overlong encodings, surrogates and code points above U+10FFFF are rejected.
+ */
+bool sos_is_utf8(const Sos* self);
+
+// Buffer cache
+// Each thread may keep a cache of released long-mode buffers, bucketed by capacity classes (31, 63, ..., 4095).
+// sos_finish() returns buffers to the cache, and allocations in the growth paths are drawn from it.
+// The cache is disabled by default. All functions below only affect the calling thread.
+
+/**
+ * Enable the buffer cache of the calling thread, with an upper bound on the bytes it holds.
+ * Pass zero to disable it.
+ *
+ * @note With the cache enabled, capacities of small long-mode strings are rounded up to the capacity classes.
+ * @note Buffers are not tied to the thread that allocated them, a string may be released on any thread.
+ */
+void sos_cache_set_limit(size_t bytes);
+
+/**
+ * Free all buffers held by the cache of the calling thread.
+ * This should be called before a thread that used the cache exits, or its buffers are leaked.
+ */
+void sos_cache_flush(void);
+
+/**
+ * Get counters of the calling thread's cache.
+ */
+SosCacheStats sos_cache_stats(void);
+
+// Allocation hooks
+
+/**
+ * Install allocation hooks for all threads, or remove them with NULL.
+ * Hooks see buffers owned by strings: those from the buffer cache and mappings included,
+ * and a buffer handed out by sos_release() as freed.
+ *
+ * @pre `hooks` stays valid until it is replaced. Callbacks may run on any thread, concurrently.
+ */
+void sos_set_alloc_hooks(const SosAllocHooks* hooks);
+
+// Custom allocators
+
+/**
+ * Allocate, resize and free long-mode buffers of the calling thread with `allocator`, or with the default
+ * allocation path again if NULL. The buffer cache and memory mappings are bypassed while an allocator is set.
+ * Buffers handed out by sos_release() and adopted by sos_init_adopt_cstr() are still malloc()'ed ones.
+ *
+ * @pre A long-mode string is only resized or finished under the allocator that allocated its buffer,
+ *      and `allocator` stays valid until it is replaced.
+ * @return The previous allocator, so that it can be restored.
+ */
+const SosAllocator* sos_set_thread_allocator(const SosAllocator* allocator);
+
+// Statistics
+// Compiled in with the CMake option SOS_ENABLE_STATS. Otherwise, snapshots are all zero.
+// Counters are updated with relaxed atomic operations, from all threads.
+
+/**
+ * Take a snapshot of the counters.
+ */
+void sos_stats_snapshot(SosStats* out);
+
+/**
+ * Reset all counters to zero.
+ */
+void sos_stats_reset(void);
+
+/**
+ * Append a human-readable report of a snapshot.
+ */
+SosStatus sos_stats_format(const SosStats* stats, Sos* out);
+
 #ifdef __cplusplus
 }
 #endif
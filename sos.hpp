@@ -0,0 +1,458 @@
+#ifndef SOS_HPP
+#define SOS_HPP
+
+// C++ wrapper of Sos. Header-only, requires C++17.
+//
+// sos::string owns an Sos and is the same size. Moving is a bitwise copy that leaves the source empty,
+// so it never throws, and the type is trivially relocatable: see sos::is_trivially_relocatable.
+// sos::pmr::string additionally holds a std::pmr::memory_resource, which serves its long-mode buffers.
+// Functions throw std::bad_alloc or std::length_error where the C API returns an error.
+
+#include "sos.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+#if defined(__cpp_lib_memory_resource)
+#define SOS_HAVE_PMR 1
+#endif
+
+namespace sos {
+
+template <class Policy>
+class basic_string;
+
+namespace detail {
+
+inline void check(SosStatus status)
+{
+    switch (status) {
+    case SOS_OK:
+        return;
+    case SOS_ERROR_ALLOC:
+        throw std::bad_alloc();
+    case SOS_ERROR_MAX_CAP:
+        throw std::length_error("sos: capacity exceeds the maximum");
+    default:
+        throw std::runtime_error("sos: operation failed");
+    }
+}
+
+// Allocation policy of the default allocation path. Stateless.
+struct default_policy {
+    // Clears the thread allocator around each call, so that a string never takes a buffer from an allocator
+    // installed by C code or by a memory resource up the stack.
+    class scope {
+    public:
+        explicit scope(const default_policy&) noexcept : prev_(sos_set_thread_allocator(nullptr)) {}
+        ~scope() { sos_set_thread_allocator(prev_); }
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+    private:
+        const SosAllocator* prev_;
+    };
+
+    default_policy select_on_copy() const noexcept { return *this; }
+    bool operator==(const default_policy&) const noexcept { return true; }
+};
+
+#ifdef SOS_HAVE_PMR
+// Allocation policy forwarding to a memory resource, installed as the thread allocator around each call.
+class resource_policy {
+public:
+    resource_policy() noexcept : resource_(std::pmr::get_default_resource()) {}
+    resource_policy(std::pmr::memory_resource* resource) noexcept : resource_(resource) {}
+
+    std::pmr::memory_resource* resource() const noexcept { return resource_; }
+
+    class scope {
+    public:
+        explicit scope(const resource_policy& policy) noexcept
+            : allocator_{&allocate, &deallocate, policy.resource_}, prev_(sos_set_thread_allocator(&allocator_))
+        {}
+        ~scope() { sos_set_thread_allocator(prev_); }
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+    private:
+        // The C core sees failures as NULL, not exceptions
+        static void* allocate(void* ctx, std::size_t size) noexcept
+        {
+            try {
+                return static_cast<std::pmr::memory_resource*>(ctx)->allocate(size, alignof(std::max_align_t));
+            } catch (...) {
+                return nullptr;
+            }
+        }
+        static void deallocate(void* ctx, void* data, std::size_t size) noexcept
+        {
+            static_cast<std::pmr::memory_resource*>(ctx)->deallocate(data, size, alignof(std::max_align_t));
+        }
+
+        SosAllocator allocator_;
+        const SosAllocator* prev_;
+    };
+
+    // Like std::pmr containers, copies use the default resource
+    resource_policy select_on_copy() const noexcept { return resource_policy(); }
+    bool operator==(const resource_policy& rhs) const noexcept { return *resource_ == *rhs.resource_; }
+
+private:
+    std::pmr::memory_resource* resource_;
+};
+#endif
+
+template <class T>
+struct is_basic_string : std::false_type {};
+
+template <class Policy>
+struct is_basic_string<basic_string<Policy>> : std::true_type {};
+
+// Operands other than strings that compare as std::string_view: C strings, std::string etc.
+template <class T>
+using enable_if_view =
+    std::enable_if_t<std::is_convertible<const T&, std::string_view>::value && !is_basic_string<T>::value, int>;
+
+} // namespace detail
+
+template <class Policy>
+class basic_string : private Policy {
+public:
+    using value_type = char;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = char&;
+    using const_reference = const char&;
+    using pointer = char*;
+    using const_pointer = const char*;
+    using iterator = char*;
+    using const_iterator = const char*;
+    using policy_type = Policy;
+
+    basic_string() noexcept { reset(); }
+
+    explicit basic_string(const Policy& policy) noexcept : Policy(policy) { reset(); }
+
+    basic_string(const char* str, const Policy& policy = Policy()) : basic_string(std::string_view(str), policy) {}
+
+    basic_string(const char* data, size_type count, const Policy& policy = Policy())
+        : basic_string(std::string_view(data, count), policy)
+    {}
+
+    explicit basic_string(std::string_view sv, const Policy& policy = Policy()) : Policy(policy)
+    {
+        const typename Policy::scope guard(*this);
+        detail::check(sos_init_from_range(&s_, sv.data(), sv.size()));
+    }
+
+    basic_string(const basic_string& rhs) : basic_string(rhs, rhs.policy().select_on_copy()) {}
+
+    basic_string(const basic_string& rhs, const Policy& policy) : Policy(policy)
+    {
+        const typename Policy::scope guard(*this);
+        detail::check(sos_init_by_copy(&s_, &rhs.s_));
+    }
+
+    basic_string(basic_string&& rhs) noexcept : Policy(rhs.policy())
+    {
+        std::memcpy(&s_, &rhs.s_, sizeof(Sos));
+        rhs.reset();
+    }
+
+    ~basic_string()
+    {
+        const typename Policy::scope guard(*this);
+        sos_finish(&s_);
+    }
+
+    basic_string& operator=(const basic_string& rhs)
+    {
+        if (this != &rhs) {
+            assign(rhs.view());
+        }
+        return *this;
+    }
+
+    basic_string& operator=(basic_string&& rhs) noexcept(std::is_empty<Policy>::value)
+    {
+        if (this == &rhs) {
+            return *this;
+        }
+        if (!(policy() == rhs.policy())) {
+            // Buffers cannot move between allocators
+            assign(rhs.view());
+            return *this;
+        }
+        {
+            const typename Policy::scope guard(*this);
+            sos_finish(&s_);
+        }
+        std::memcpy(&s_, &rhs.s_, sizeof(Sos));
+        rhs.reset();
+        return *this;
+    }
+
+    basic_string& operator=(std::string_view sv) { return assign(sv); }
+    basic_string& operator=(const char* str) { return assign(std::string_view(str)); }
+
+    basic_string& assign(std::string_view sv)
+    {
+        if (aliases(sv)) {
+            // Part of this string: move it to the front, as std::string does
+            std::memmove(data(), sv.data(), sv.size());
+            sos_resize(&s_, sv.size(), '\0'); // Shrinks, so never allocates
+            return *this;
+        }
+        const typename Policy::scope guard(*this);
+        sos_clear(&s_);
+        detail::check(sos_append_range(&s_, sv.data(), sv.size()));
+        return *this;
+    }
+
+    const Policy& policy() const noexcept { return *this; }
+
+    // Access
+
+    size_type size() const noexcept { return sos_len(&s_); }
+    size_type length() const noexcept { return sos_len(&s_); }
+    size_type capacity() const noexcept { return sos_cap(&s_); }
+    bool empty() const noexcept { return size() == 0; }
+
+    const char* c_str() const noexcept { return sos_cstr(&s_); }
+    const char* data() const noexcept { return sos_cstr(&s_); }
+    char* data() noexcept { return sos_cstr_mut(&s_); }
+
+    char& operator[](size_type i) noexcept { return data()[i]; }
+    const char& operator[](size_type i) const noexcept { return data()[i]; }
+    char& back() noexcept { return data()[size() - 1]; }
+    const char& back() const noexcept { return data()[size() - 1]; }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept
+    {
+        const SosViewMut v = sos_view_mut(&s_);
+        return v.data + v.len;
+    }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept
+    {
+        const SosView v = sos_view(&s_);
+        return v.data + v.len;
+    }
+
+    std::string_view view() const noexcept
+    {
+        const SosView v = sos_view(&s_);
+        return std::string_view(v.data, v.len);
+    }
+    operator std::string_view() const noexcept { return view(); }
+
+    // The underlying Sos, for use with the C API under the same allocation policy.
+    Sos* get() noexcept { return &s_; }
+    const Sos* get() const noexcept { return &s_; }
+
+    // Modifiers
+
+    void clear() noexcept { sos_clear(&s_); }
+
+    void reserve(size_type cap)
+    {
+        const typename Policy::scope guard(*this);
+        detail::check(sos_reserve(&s_, cap));
+    }
+
+    void resize(size_type len, char ch = '\0')
+    {
+        const typename Policy::scope guard(*this);
+        detail::check(sos_resize(&s_, len, ch));
+    }
+
+    void shrink_to_fit()
+    {
+        const typename Policy::scope guard(*this);
+        sos_shrink_to_fit(&s_);
+    }
+
+    void push_back(char c)
+    {
+        const typename Policy::scope guard(*this);
+        detail::check(sos_push(&s_, c));
+    }
+
+    void pop_back() noexcept { sos_pop(&s_); }
+
+    basic_string& append(std::string_view sv)
+    {
+        const typename Policy::scope guard(*this);
+        // Growing moves the buffer, so a view of this string is found again by its offset
+        const bool self = aliases(sv);
+        const size_type offset = self ? static_cast<size_type>(sv.data() - data()) : 0;
+        grow_for(sv.size());
+        detail::check(sos_append_range(&s_, self ? data() + offset : sv.data(), sv.size()));
+        return *this;
+    }
+
+    basic_string& append(const char* data, size_type count) { return append(std::string_view(data, count)); }
+
+    basic_string& operator+=(std::string_view sv) { return append(sv); }
+    basic_string& operator+=(const char* str) { return append(std::string_view(str)); }
+    basic_string& operator+=(char c)
+    {
+        push_back(c);
+        return *this;
+    }
+
+    void swap(basic_string& rhs) noexcept
+    {
+        using std::swap;
+        swap(static_cast<Policy&>(*this), static_cast<Policy&>(rhs));
+        sos_swap(&s_, &rhs.s_);
+    }
+    friend void swap(basic_string& lhs, basic_string& rhs) noexcept { lhs.swap(rhs); }
+
+    // Comparison, by bytes including embedded NULs
+
+    int compare(std::string_view sv) const noexcept { return view().compare(sv); }
+
+    std::uint64_t hash() const noexcept
+    {
+        const SosView v = sos_view(&s_);
+        return sos_hash_range(v.data, v.len);
+    }
+
+#define SOS_HPP_COMPARE(op)                                                                                   \
+    friend bool operator op(const basic_string& lhs, const basic_string& rhs) noexcept                          \
+    {                                                                                                           \
+        return lhs.view() op rhs.view();                                                                        \
+    }                                                                                                           \
+    template <class T, detail::enable_if_view<T> = 0>                                                          \
+    friend bool operator op(const basic_string& lhs, const T& rhs) noexcept                                     \
+    {                                                                                                           \
+        return lhs.view() op std::string_view(rhs);                                                             \
+    }                                                                                                           \
+    template <class T, detail::enable_if_view<T> = 0>                                                          \
+    friend bool operator op(const T& lhs, const basic_string& rhs) noexcept                                     \
+    {                                                                                                           \
+        return std::string_view(lhs) op rhs.view();                                                             \
+    }
+
+    SOS_HPP_COMPARE(==)
+    SOS_HPP_COMPARE(!=)
+    SOS_HPP_COMPARE(<)
+    SOS_HPP_COMPARE(>)
+    SOS_HPP_COMPARE(<=)
+    SOS_HPP_COMPARE(>=)
+#undef SOS_HPP_COMPARE
+
+private:
+    // Whether a view points into the buffer of this string
+    bool aliases(std::string_view sv) const noexcept
+    {
+        const std::less_equal<const char*> le;
+        return sv.data() && le(data(), sv.data()) && le(sv.data(), data() + capacity());
+    }
+
+    // Reserve room for `count` more chars, growing geometrically so that repeated appends take amortized O(1) time
+    void grow_for(size_type count)
+    {
+        const size_type len = size();
+        const size_type cap = capacity();
+        if (count <= cap - len) {
+            return;
+        }
+        if (count > SIZE_MAX / 2 - len) {
+            detail::check(SOS_ERROR_MAX_CAP);
+        }
+        detail::check(sos_reserve(&s_, len + count > 2 * cap ? len + count : 2 * cap));
+    }
+
+    // Empty short string, without a call into the library
+    void reset() noexcept
+    {
+        s_.repr.s.len = 0;
+        s_.repr.s.data[0] = 0;
+    }
+
+    Sos s_;
+};
+
+using string = basic_string<detail::default_policy>;
+
+static_assert(sizeof(string) == sizeof(Sos), "sos::string adds no storage");
+
+#ifdef SOS_HAVE_PMR
+namespace pmr {
+using string = basic_string<detail::resource_policy>;
+} // namespace pmr
+#endif
+
+// Whether T can be moved to new storage with memcpy, dropping the source without destroying it.
+// Containers may specialize on this to grow with memcpy or realloc.
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <class Policy>
+struct is_trivially_relocatable<basic_string<Policy>> : std::true_type {};
+
+template <class T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+/**
+ * Move-construct [first, last) into uninitialized storage at `dest`, and destroy the sources.
+ *
+ * @pre The ranges do not overlap.
+ */
+template <class T>
+T* relocate(T* first, T* last, T* dest) noexcept
+{
+    static_assert(is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible<T>::value,
+                  "relocation must not throw");
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (first != last) {
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), sizeof(T) * (last - first));
+        }
+        return dest + (last - first);
+    } else {
+        for (; first != last; ++first, ++dest) {
+            ::new (static_cast<void*>(dest)) T(std::move(*first));
+            first->~T();
+        }
+        return dest;
+    }
+}
+
+// Transparent hash, agreeing with sos_hash() and the std::hash specializations
+struct hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view sv) const noexcept
+    {
+        return static_cast<std::size_t>(sos_hash_range(sv.data(), sv.size()));
+    }
+};
+
+} // namespace sos
+
+namespace std {
+template <class Policy>
+struct hash<sos::basic_string<Policy>> {
+    size_t operator()(const sos::basic_string<Policy>& s) const noexcept { return static_cast<size_t>(s.hash()); }
+};
+} // namespace std
+
+#endif // SOS_HPP
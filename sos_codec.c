@@ -0,0 +1,496 @@
+#include "sos_codec.h"
+#include <stdint.h>
+#include <string.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SOS_CODEC_X86 1
+#include <immintrin.h>
+#define SOS_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+static const char hex_lower[] = "0123456789abcdef";
+static const char b64_std[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char b64_url[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+static const signed char b64_std_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+static const signed char b64_url_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, 63,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+static int
+hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c = (char)(c | 0x20);
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+// The SIMD kernels process whole blocks and return the number of input bytes consumed.
+// Decoders stop before a block with an invalid char, leaving it to the scalar code to report.
+
+#ifdef SOS_CODEC_X86
+// 0: scalar, 1: SSSE3, 2: AVX2
+static int
+simd_level(void)
+{
+    if (__builtin_cpu_supports("avx2")) {
+        return 2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return 1;
+    }
+    return 0;
+}
+
+SOS_TARGET("ssse3") static size_t
+hex_encode_ssse3(const unsigned char* in, size_t n, char* out)
+{
+    const __m128i lut = _mm_loadu_si128((const __m128i*)hex_lower);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i*)(in + i));
+        const __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 4), nibble));
+        const __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(x, nibble));
+        _mm_storeu_si128((__m128i*)(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+SOS_TARGET("avx2") static size_t
+hex_encode_avx2(const unsigned char* in, size_t n, char* out)
+{
+    const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)hex_lower));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*)(in + i));
+        const __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+        const __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(x, nibble));
+        // Unpacking is per 128-bit lane: a = bytes 0-7 | 16-23, b = bytes 8-15 | 24-31
+        const __m256i a = _mm256_unpacklo_epi8(hi, lo);
+        const __m256i b = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i*)(out + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i*)(out + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    return i;
+}
+
+// Values of hex chars, with invalid chars flagged in `bad`
+SOS_TARGET("ssse3") static __m128i
+hex_values_ssse3(__m128i c, __m128i* bad)
+{
+    const __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+    const __m128i l = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(l, _mm_set1_epi8(5)), l);
+    *bad = _mm_or_si128(*bad, _mm_andnot_si128(_mm_or_si128(is_digit, is_alpha), _mm_set1_epi8(-1)));
+    return _mm_or_si128(_mm_and_si128(is_digit, d), _mm_and_si128(is_alpha, _mm_add_epi8(l, _mm_set1_epi8(10))));
+}
+
+SOS_TARGET("ssse3") static size_t
+hex_decode_ssse3(const char* in, size_t n, unsigned char* out)
+{
+    const __m128i weights = _mm_set1_epi16(0x0110); // high nibble * 16 + low nibble
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m128i bad = _mm_setzero_si128();
+        const __m128i v0 = hex_values_ssse3(_mm_loadu_si128((const __m128i*)(in + i)), &bad);
+        const __m128i v1 = hex_values_ssse3(_mm_loadu_si128((const __m128i*)(in + i + 16)), &bad);
+        if (_mm_movemask_epi8(bad)) {
+            break;
+        }
+        const __m128i b = _mm_packus_epi16(_mm_maddubs_epi16(v0, weights), _mm_maddubs_epi16(v1, weights));
+        _mm_storeu_si128((__m128i*)(out + i / 2), b);
+    }
+    return i;
+}
+
+SOS_TARGET("avx2") static __m256i
+hex_values_avx2(__m256i c, __m256i* bad)
+{
+    const __m256i d = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+    const __m256i l = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    const __m256i is_alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(l, _mm256_set1_epi8(5)), l);
+    *bad = _mm256_or_si256(*bad, _mm256_andnot_si256(_mm256_or_si256(is_digit, is_alpha), _mm256_set1_epi8(-1)));
+    return _mm256_or_si256(_mm256_and_si256(is_digit, d), _mm256_and_si256(is_alpha, _mm256_add_epi8(l, _mm256_set1_epi8(10))));
+}
+
+SOS_TARGET("avx2") static size_t
+hex_decode_avx2(const char* in, size_t n, unsigned char* out)
+{
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m256i bad = _mm256_setzero_si256();
+        const __m256i v0 = hex_values_avx2(_mm256_loadu_si256((const __m256i*)(in + i)), &bad);
+        const __m256i v1 = hex_values_avx2(_mm256_loadu_si256((const __m256i*)(in + i + 32)), &bad);
+        if (_mm256_movemask_epi8(bad)) {
+            break;
+        }
+        // Packing is per 128-bit lane, restore the order of 64-bit quarters
+        const __m256i b = _mm256_packus_epi16(_mm256_maddubs_epi16(v0, weights), _mm256_maddubs_epi16(v1, weights));
+        _mm256_storeu_si256((__m256i*)(out + i / 2), _mm256_permute4x64_epi64(b, 0xd8));
+    }
+    return i;
+}
+
+// Base64 kernels after Wojciech Muła's SSE/AVX2 base64 algorithms.
+
+// Split 12 bytes (of 16) into 16 6-bit indices
+SOS_TARGET("ssse3") static __m128i
+b64_indices_ssse3(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+// Map indices to chars: classify into ranges, then add the range's offset
+SOS_TARGET("ssse3") static __m128i
+b64_chars_ssse3(__m128i idx, __m128i offsets)
+{
+    __m128i r = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+    r = _mm_or_si128(r, _mm_and_si128(less, _mm_set1_epi8(13)));
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets, r), idx);
+}
+
+static const signed char*
+b64_offsets(const char* alphabet)
+{
+    static const signed char std[16] = {'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0};
+    static const signed char url[16] = {'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0};
+    return alphabet == b64_url ? url : std;
+}
+
+SOS_TARGET("ssse3") static size_t
+b64_encode_ssse3(const unsigned char* in, size_t n, char* out, const char* alphabet)
+{
+    const __m128i offsets = _mm_loadu_si128((const __m128i*)b64_offsets(alphabet));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 12, out += 16) {
+        const __m128i idx = b64_indices_ssse3(_mm_loadu_si128((const __m128i*)(in + i)));
+        _mm_storeu_si128((__m128i*)out, b64_chars_ssse3(idx, offsets));
+    }
+    return i;
+}
+
+SOS_TARGET("avx2") static size_t
+b64_encode_avx2(const unsigned char* in, size_t n, char* out, const char* alphabet)
+{
+    const __m256i offsets = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)b64_offsets(alphabet)));
+    const __m256i shuf = _mm256_broadcastsi128_si256(_mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    size_t i = 0;
+    for (; i + 28 <= n; i += 24, out += 32) {
+        // 12 bytes into each lane
+        __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(in + i))),
+                                            _mm_loadu_si128((const __m128i*)(in + i + 12)), 1);
+        x = _mm256_shuffle_epi8(x, shuf);
+        const __m256i t0 = _mm256_and_si256(x, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(x, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const __m256i idx = _mm256_or_si256(t1, t3);
+
+        __m256i r = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx);
+        r = _mm256_or_si256(r, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        _mm256_storeu_si256((__m256i*)out, _mm256_add_epi8(_mm256_shuffle_epi8(offsets, r), idx));
+    }
+    return i;
+}
+
+// Per high nibble: range of valid chars, and the offset from char to value.
+// `/` is the one char that does not fit this scheme and is handled on its own.
+static const signed char b64_lower_bound[16] = {1, 1, 0x2b, 0x30, 0x41, 0x50, 0x61, 0x70, 1, 1, 1, 1, 1, 1, 1, 1};
+static const signed char b64_upper_bound[16] = {0, 0, 0x2b, 0x39, 0x4f, 0x5a, 0x6f, 0x7a, 0, 0, 0, 0, 0, 0, 0, 0};
+static const signed char b64_shift[16] = {0, 0, 0x3e - 0x2b, 0x34 - 0x30, 0x00 - 0x41, 0x0f - 0x50, 0x1a - 0x61, 0x29 - 0x70,
+                                          0, 0, 0, 0, 0, 0, 0, 0};
+
+SOS_TARGET("ssse3") static size_t
+b64_decode_ssse3(const char* in, size_t n, unsigned char* out, size_t room, bool url)
+{
+    const __m128i lower_lut = _mm_loadu_si128((const __m128i*)b64_lower_bound);
+    const __m128i upper_lut = _mm_loadu_si128((const __m128i*)b64_upper_bound);
+    const __m128i shift_lut = _mm_loadu_si128((const __m128i*)b64_shift);
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 16 <= n && o + 16 <= room; i += 16, o += 12) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i bad = _mm_setzero_si128();
+        if (url) {
+            // Map to the standard alphabet
+            bad = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('+')), _mm_cmpeq_epi8(x, _mm_set1_epi8('/')));
+            x = _mm_add_epi8(x, _mm_and_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('-')), _mm_set1_epi8('+' - '-')));
+            x = _mm_add_epi8(x, _mm_and_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('_')), _mm_set1_epi8('/' - '_')));
+        }
+        const __m128i hi = _mm_and_si128(_mm_srli_epi32(x, 4), _mm_set1_epi8(0x0f));
+        const __m128i below = _mm_cmpgt_epi8(_mm_shuffle_epi8(lower_lut, hi), x);
+        const __m128i above = _mm_cmpgt_epi8(x, _mm_shuffle_epi8(upper_lut, hi));
+        const __m128i slash = _mm_cmpeq_epi8(x, _mm_set1_epi8('/'));
+        bad = _mm_or_si128(bad, _mm_andnot_si128(slash, _mm_or_si128(below, above)));
+        if (_mm_movemask_epi8(bad)) {
+            break;
+        }
+        __m128i v = _mm_add_epi8(x, _mm_shuffle_epi8(shift_lut, hi));
+        v = _mm_add_epi8(v, _mm_and_si128(slash, _mm_set1_epi8(-3)));
+
+        // Merge 4 6-bit values into 3 bytes per 32-bit lane
+        const __m128i ab_cd = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+        const __m128i abcd = _mm_madd_epi16(ab_cd, _mm_set1_epi32(0x00011000));
+        const __m128i b = _mm_shuffle_epi8(abcd, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128((__m128i*)(out + o), b);
+    }
+    return i;
+}
+
+SOS_TARGET("avx2") static size_t
+b64_decode_avx2(const char* in, size_t n, unsigned char* out, size_t room, bool url)
+{
+    const __m256i lower_lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)b64_lower_bound));
+    const __m256i upper_lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)b64_upper_bound));
+    const __m256i shift_lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)b64_shift));
+    const __m256i pack = _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 32 <= n && o + 32 <= room; i += 32, o += 24) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i bad = _mm256_setzero_si256();
+        if (url) {
+            bad = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('+')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('/')));
+            x = _mm256_add_epi8(x, _mm256_and_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('-')), _mm256_set1_epi8('+' - '-')));
+            x = _mm256_add_epi8(x, _mm256_and_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('_')), _mm256_set1_epi8('/' - '_')));
+        }
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi32(x, 4), _mm256_set1_epi8(0x0f));
+        const __m256i below = _mm256_cmpgt_epi8(_mm256_shuffle_epi8(lower_lut, hi), x);
+        const __m256i above = _mm256_cmpgt_epi8(x, _mm256_shuffle_epi8(upper_lut, hi));
+        const __m256i slash = _mm256_cmpeq_epi8(x, _mm256_set1_epi8('/'));
+        bad = _mm256_or_si256(bad, _mm256_andnot_si256(slash, _mm256_or_si256(below, above)));
+        if (_mm256_movemask_epi8(bad)) {
+            break;
+        }
+        __m256i v = _mm256_add_epi8(x, _mm256_shuffle_epi8(shift_lut, hi));
+        v = _mm256_add_epi8(v, _mm256_and_si256(slash, _mm256_set1_epi8(-3)));
+
+        const __m256i ab_cd = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+        const __m256i abcd = _mm256_madd_epi16(ab_cd, _mm256_set1_epi32(0x00011000));
+        // 12 bytes at the start of each lane, then join the lanes
+        const __m256i b = _mm256_shuffle_epi8(abcd, pack);
+        _mm256_storeu_si256((__m256i*)(out + o), _mm256_permutevar8x32_epi32(b, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7)));
+    }
+    return i;
+}
+#endif
+
+SosStatus sos_append_hex(Sos* restrict self, const void* restrict data, size_t count)
+{
+    if (count > SIZE_MAX / 2) {
+        return SOS_ERROR_MAX_CAP;
+    }
+    const SosStatusAndBuf ret = sos_expand_for_overwrite(self, 2 * count);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    const unsigned char* const in = data;
+    char* const out = ret.str;
+    size_t i = 0;
+#ifdef SOS_CODEC_X86
+    const int level = simd_level();
+    if (level >= 2) {
+        i += hex_encode_avx2(in, count, out);
+    }
+    if (level >= 1) {
+        i += hex_encode_ssse3(in + i, count - i, out + 2 * i);
+    }
+#endif
+    for (; i < count; ++i) {
+        out[2 * i] = hex_lower[in[i] >> 4];
+        out[2 * i + 1] = hex_lower[in[i] & 0xf];
+    }
+    return SOS_OK;
+}
+
+SosStatus sos_append_hex_decoded(Sos* restrict self, const char* restrict begin, size_t count)
+{
+    if (count % 2 != 0) {
+        return SOS_ERROR_INVALID;
+    }
+    const size_t old_len = sos_len(self);
+    const SosStatusAndBuf ret = sos_expand_for_overwrite(self, count / 2);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    unsigned char* const out = (unsigned char*)ret.str;
+    size_t i = 0;
+#ifdef SOS_CODEC_X86
+    const int level = simd_level();
+    if (level >= 2) {
+        i += hex_decode_avx2(begin, count, out);
+    }
+    if (level >= 1) {
+        i += hex_decode_ssse3(begin + i, count - i, out + i / 2);
+    }
+#endif
+    for (; i < count; i += 2) {
+        const int hi = hex_value(begin[i]);
+        const int lo = hex_value(begin[i + 1]);
+        if (hi < 0 || lo < 0) {
+            sos_resize(self, old_len, 0);
+            return SOS_ERROR_INVALID;
+        }
+        out[i / 2] = (unsigned char)(hi << 4 | lo);
+    }
+    return SOS_OK;
+}
+
+SosStatus sos_append_base64(Sos* restrict self, const void* restrict data, size_t count, SosBase64Alphabet alphabet)
+{
+    if (count / 3 >= SIZE_MAX / 4 - 1) {
+        return SOS_ERROR_MAX_CAP;
+    }
+    const bool pad = alphabet == SOS_BASE64_STANDARD;
+    const char* const chars = pad ? b64_std : b64_url;
+    const size_t rem = count % 3;
+    const size_t out_len = count / 3 * 4 + (rem == 0 ? 0 : pad ? 4 : rem + 1);
+    const SosStatusAndBuf ret = sos_expand_for_overwrite(self, out_len);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    const unsigned char* const in = data;
+    char* out = ret.str;
+    size_t i = 0;
+#ifdef SOS_CODEC_X86
+    const int level = simd_level();
+    if (level >= 2) {
+        i += b64_encode_avx2(in, count, out, chars);
+    }
+    if (level >= 1) {
+        i += b64_encode_ssse3(in + i, count - i, out + i / 3 * 4, chars);
+    }
+    out += i / 3 * 4;
+#endif
+    for (; i + 3 <= count; i += 3, out += 4) {
+        const uint32_t v = (uint32_t)in[i] << 16 | (uint32_t)in[i + 1] << 8 | in[i + 2];
+        out[0] = chars[v >> 18];
+        out[1] = chars[v >> 12 & 0x3f];
+        out[2] = chars[v >> 6 & 0x3f];
+        out[3] = chars[v & 0x3f];
+    }
+    if (rem != 0) {
+        const uint32_t v = (uint32_t)in[i] << 16 | (rem == 2 ? (uint32_t)in[i + 1] << 8 : 0);
+        out[0] = chars[v >> 18];
+        out[1] = chars[v >> 12 & 0x3f];
+        if (rem == 2) {
+            out[2] = chars[v >> 6 & 0x3f];
+        } else if (pad) {
+            out[2] = '=';
+        }
+        if (pad) {
+            out[3] = '=';
+        }
+    }
+    return SOS_OK;
+}
+
+SosStatus sos_append_base64_decoded(Sos* restrict self, const char* restrict begin, size_t count, SosBase64Alphabet alphabet)
+{
+    if (count % 4 == 0 && count > 0 && begin[count - 1] == '=') {
+        count -= begin[count - 2] == '=' ? 2 : 1;
+    }
+    if (count % 4 == 1) {
+        return SOS_ERROR_INVALID;
+    }
+    const bool url = alphabet == SOS_BASE64_URL;
+    const signed char* const values = url ? b64_url_values : b64_std_values;
+    const size_t out_len = count / 4 * 3 + (count % 4 == 0 ? 0 : count % 4 - 1);
+
+    const size_t old_len = sos_len(self);
+    const SosStatusAndBuf ret = sos_expand_for_overwrite(self, out_len);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    unsigned char* out = (unsigned char*)ret.str;
+    size_t i = 0;
+#ifdef SOS_CODEC_X86
+    const int level = simd_level();
+    if (level >= 2) {
+        i += b64_decode_avx2(begin, count, out, out_len, url);
+    }
+    if (level >= 1) {
+        i += b64_decode_ssse3(begin + i, count - i, out + i / 4 * 3, out_len - i / 4 * 3, url);
+    }
+    out += i / 4 * 3;
+#endif
+    int32_t v = 0;
+    for (; i + 4 <= count; i += 4, out += 3) {
+        v = values[(unsigned char)begin[i]] * (1 << 18) | values[(unsigned char)begin[i + 1]] * (1 << 12) |
+            values[(unsigned char)begin[i + 2]] * (1 << 6) | values[(unsigned char)begin[i + 3]];
+        if (v < 0) {
+            break;
+        }
+        out[0] = (unsigned char)(v >> 16);
+        out[1] = (unsigned char)(v >> 8);
+        out[2] = (unsigned char)v;
+    }
+    if (v >= 0 && i < count && i + 4 > count) {
+        const size_t rem = count - i;
+        v = values[(unsigned char)begin[i]] * (1 << 18) | values[(unsigned char)begin[i + 1]] * (1 << 12) |
+            (rem == 3 ? values[(unsigned char)begin[i + 2]] * (1 << 6) : 0);
+        if (v >= 0) {
+            out[0] = (unsigned char)(v >> 16);
+            if (rem == 3) {
+                out[1] = (unsigned char)(v >> 8);
+            }
+        }
+    }
+    if (v < 0) {
+        sos_resize(self, old_len, 0);
+        return SOS_ERROR_INVALID;
+    }
+    return SOS_OK;
+}
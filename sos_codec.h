@@ -0,0 +1,53 @@
+#ifndef SOS_CODEC_H
+#define SOS_CODEC_H
+
+// Hex and base64 encoding and decoding
+//
+// On x86 with GCC or Clang, SSSE3 and AVX2 kernels are selected at runtime. Other targets use the scalar code.
+
+#include "sos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SOS_BASE64_STANDARD, // RFC 4648 section 4: `+` and `/`, padded with `=`
+    SOS_BASE64_URL,      // RFC 4648 section 5: `-` and `_`, not padded
+} SosBase64Alphabet;
+
+/**
+ * Append bytes encoded as lowercase hex.
+ *
+ * @pre The range does not overlap the string.
+ */
+SosStatus sos_append_hex(Sos* SOS_RESTRICT self, const void* SOS_RESTRICT data, size_t count);
+
+/**
+ * Append the bytes of a hex-encoded char range. Both cases are accepted.
+ *
+ * @pre The range does not overlap the string.
+ * @return SOS_ERROR_INVALID on an odd length or a non-hex char. The string is unchanged on failure.
+ */
+SosStatus sos_append_hex_decoded(Sos* SOS_RESTRICT self, const char* SOS_RESTRICT begin, size_t count);
+
+/**
+ * Append bytes encoded as base64.
+ *
+ * @pre The range does not overlap the string.
+ */
+SosStatus sos_append_base64(Sos* SOS_RESTRICT self, const void* SOS_RESTRICT data, size_t count, SosBase64Alphabet alphabet);
+
+/**
+ * Append the bytes of a base64-encoded char range. Padding is optional for either alphabet.
+ *
+ * @pre The range does not overlap the string.
+ * @return SOS_ERROR_INVALID on a char outside the alphabet or a bad length. The string is unchanged on failure.
+ */
+SosStatus sos_append_base64_decoded(Sos* SOS_RESTRICT self, const char* SOS_RESTRICT begin, size_t count, SosBase64Alphabet alphabet);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_CODEC_H
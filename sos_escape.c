@@ -0,0 +1,401 @@
+#include "sos_escape.h"
+#include "sos_internal.h"
+#include <stdint.h>
+#include <string.h>
+
+typedef enum {
+    SPECIAL_JSON,    // `"`, `\` and control characters
+    SPECIAL_QUOTE,   // `"`
+    SPECIAL_URL,     // Anything but unreserved characters
+    SPECIAL_PERCENT, // `%`
+} SpecialKind;
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+static bool
+is_unreserved(unsigned char c)
+{
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') || c == '-' || c == '.' || c == '_' || c == '~';
+}
+
+static bool
+is_special(SpecialKind kind, unsigned char c)
+{
+    switch (kind) {
+    case SPECIAL_JSON: return c < 0x20 || c == '"' || c == '\\';
+    case SPECIAL_QUOTE: return c == '"';
+    case SPECIAL_URL: return !is_unreserved(c);
+    case SPECIAL_PERCENT: return c == '%';
+    }
+    return false;
+}
+
+#ifdef SOS_HAVE_SSE2
+// Bytes of `x` in [lo, hi], as a byte mask
+static __m128i
+in_range(__m128i x, unsigned char lo, unsigned char hi)
+{
+    const __m128i d = _mm_sub_epi8(x, _mm_set1_epi8((char)lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8((char)(hi - lo))), d);
+}
+
+static unsigned
+special_mask(SpecialKind kind, __m128i x)
+{
+    switch (kind) {
+    case SPECIAL_JSON: {
+        const __m128i ctrl = in_range(x, 0, 0x1f);
+        const __m128i quote = _mm_cmpeq_epi8(x, _mm_set1_epi8('"'));
+        const __m128i bslash = _mm_cmpeq_epi8(x, _mm_set1_epi8('\\'));
+        return (unsigned)_mm_movemask_epi8(_mm_or_si128(ctrl, _mm_or_si128(quote, bslash)));
+    }
+    case SPECIAL_QUOTE:
+        return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('"')));
+    case SPECIAL_URL: {
+        __m128i ok = in_range(x, '0', '9');
+        ok = _mm_or_si128(ok, in_range(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 'z'));
+        ok = _mm_or_si128(ok, _mm_cmpeq_epi8(x, _mm_set1_epi8('-')));
+        ok = _mm_or_si128(ok, _mm_cmpeq_epi8(x, _mm_set1_epi8('.')));
+        ok = _mm_or_si128(ok, _mm_cmpeq_epi8(x, _mm_set1_epi8('_')));
+        ok = _mm_or_si128(ok, _mm_cmpeq_epi8(x, _mm_set1_epi8('~')));
+        return ~(unsigned)_mm_movemask_epi8(ok) & 0xffffu;
+    }
+    case SPECIAL_PERCENT:
+        return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('%')));
+    }
+    return 0;
+}
+#endif
+
+/**
+ * Find the first special byte in [p, end).
+ *
+ * @return Pointer to the byte, or `end`
+ */
+static const char*
+scan(SpecialKind kind, const char* p, const char* end)
+{
+#ifdef SOS_HAVE_SSE2
+    while (end - p >= 16) {
+        const unsigned mask = special_mask(kind, _mm_loadu_si128((const __m128i*)p));
+        if (mask) {
+            return p + count_trailing_zeros(mask);
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && !is_special(kind, (unsigned char)*p)) {
+        ++p;
+    }
+    return p;
+}
+
+static size_t
+json_escape_len(unsigned char c)
+{
+    switch (c) {
+    case '"': case '\\': case '\b': case '\f': case '\n': case '\r': case '\t':
+        return 2;
+    default:
+        return 6; // \u00XX
+    }
+}
+
+static char*
+json_escape(unsigned char c, char* out)
+{
+    *out++ = '\\';
+    switch (c) {
+    case '"': *out++ = '"'; break;
+    case '\\': *out++ = '\\'; break;
+    case '\b': *out++ = 'b'; break;
+    case '\f': *out++ = 'f'; break;
+    case '\n': *out++ = 'n'; break;
+    case '\r': *out++ = 'r'; break;
+    case '\t': *out++ = 't'; break;
+    default:
+        memcpy(out, "u00", 3);
+        out[3] = hex_digits[c >> 4];
+        out[4] = hex_digits[c & 0xf];
+        out += 5;
+    }
+    return out;
+}
+
+static int
+hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c = (char)(c | 0x20);
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+// Parse 4 hex digits. Returns -1 on failure.
+static long
+parse_hex4(const char* p, const char* end)
+{
+    if (end - p < 4) {
+        return -1;
+    }
+    long value = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int d = hex_value(p[i]);
+        if (d < 0) {
+            return -1;
+        }
+        value = value << 4 | d;
+    }
+    return value;
+}
+
+static char*
+put_utf8(unsigned long cp, char* out)
+{
+    if (cp < 0x80) {
+        *out++ = (char)cp;
+    } else if (cp < 0x800) {
+        *out++ = (char)(0xc0 | cp >> 6);
+        *out++ = (char)(0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+        *out++ = (char)(0xe0 | cp >> 12);
+        *out++ = (char)(0x80 | (cp >> 6 & 0x3f));
+        *out++ = (char)(0x80 | (cp & 0x3f));
+    } else {
+        *out++ = (char)(0xf0 | cp >> 18);
+        *out++ = (char)(0x80 | (cp >> 12 & 0x3f));
+        *out++ = (char)(0x80 | (cp >> 6 & 0x3f));
+        *out++ = (char)(0x80 | (cp & 0x3f));
+    }
+    return out;
+}
+
+/**
+ * Expand the string for a decoder, whose output is never longer than its input.
+ * The decoder then returns its end pointer, or NULL on failure, and finish_decode() settles the length.
+ */
+static SosStatus
+finish_decode(Sos* self, size_t old_len, const char* begin, const char* end)
+{
+    if (!end) {
+        sos_resize(self, old_len, 0);
+        return SOS_ERROR_INVALID;
+    }
+    sos_resize(self, old_len + (size_t)(end - begin), 0);
+    return SOS_OK;
+}
+
+SosStatus sos_append_json_escaped(Sos* restrict self, const char* restrict begin, size_t count)
+{
+    if (count > SIZE_MAX / 6) {
+        return SOS_ERROR_MAX_CAP;
+    }
+    const char* const end = begin + count;
+    size_t out_len = count;
+    for (const char* p = scan(SPECIAL_JSON, begin, end); p != end; p = scan(SPECIAL_JSON, p + 1, end)) {
+        out_len += json_escape_len((unsigned char)*p) - 1;
+    }
+
+    const SosStatusAndBuf ret = sos_expand_for_overwrite(self, out_len);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    char* out = ret.str;
+    for (const char* p = begin;;) {
+        const char* const q = scan(SPECIAL_JSON, p, end);
+        memcpy(out, p, (size_t)(q - p));
+        out += q - p;
+        if (q == end) {
+            break;
+        }
+        out = json_escape((unsigned char)*q, out);
+        p = q + 1;
+    }
+    return SOS_OK;
+}
+
+SosStatus sos_append_json_unescaped(Sos* restrict self, const char* restrict begin, size_t count)
+{
+    const size_t old_len = sos_len(self);
+    const SosStatusAndBuf ret = sos_expand_for_overwrite(self, count);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    char* out = ret.str;
+    const char* const end = begin + count;
+    for (const char* p = begin;;) {
+        const char* const q = scan(SPECIAL_JSON, p, end);
+        memcpy(out, p, (size_t)(q - p));
+        out += q - p;
+        if (q == end) {
+            break;
+        }
+        if (*q != '\\' || end - q < 2) {
+            return finish_decode(self, old_len, ret.str, NULL);
+        }
+        p = q + 2;
+        switch (q[1]) {
+        case '"': *out++ = '"'; break;
+        case '\\': *out++ = '\\'; break;
+        case '/': *out++ = '/'; break;
+        case 'b': *out++ = '\b'; break;
+        case 'f': *out++ = '\f'; break;
+        case 'n': *out++ = '\n'; break;
+        case 'r': *out++ = '\r'; break;
+        case 't': *out++ = '\t'; break;
+        case 'u': {
+            long cp = parse_hex4(p, end);
+            p += 4;
+            if (cp >= 0xdc00 && cp <= 0xdfff) {
+                cp = -1; // Lone low surrogate
+            } else if (cp >= 0xd800 && cp <= 0xdbff) {
+                const long low = end - p >= 2 && p[0] == '\\' && p[1] == 'u' ? parse_hex4(p + 2, end) : -1;
+                if (low >= 0xdc00 && low <= 0xdfff) {
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                    p += 6;
+                } else {
+                    cp = -1;
+                }
+            }
+            if (cp < 0) {
+                return finish_decode(self, old_len, ret.str, NULL);
+            }
+            out = put_utf8((unsigned long)cp, out);
+            break;
+        }
+        default:
+            return finish_decode(self, old_len, ret.str, NULL);
+        }
+    }
+    return finish_decode(self, old_len, ret.str, out);
+}
+
+SosStatus sos_append_csv_quoted(Sos* restrict self, const char* restrict begin, size_t count)
+{
+    if (count > (SIZE_MAX - 2) / 2) {
+        return SOS_ERROR_MAX_CAP;
+    }
+    const char* const end = begin + count;
+    size_t out_len = count + 2;
+    for (const char* p = scan(SPECIAL_QUOTE, begin, end); p != end; p = scan(SPECIAL_QUOTE, p + 1, end)) {
+        out_len += 1;
+    }
+
+    const SosStatusAndBuf ret = sos_expand_for_overwrite(self, out_len);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    char* out = ret.str;
+    *out++ = '"';
+    for (const char* p = begin;;) {
+        const char* const q = scan(SPECIAL_QUOTE, p, end);
+        memcpy(out, p, (size_t)(q - p));
+        out += q - p;
+        if (q == end) {
+            break;
+        }
+        *out++ = '"';
+        *out++ = '"';
+        p = q + 1;
+    }
+    *out = '"';
+    return SOS_OK;
+}
+
+SosStatus sos_append_csv_unquoted(Sos* restrict self, const char* restrict begin, size_t count)
+{
+    const char* const end = begin + count;
+    if (count == 0 || *begin != '"') {
+        // Unquoted fields may not contain quotes
+        return scan(SPECIAL_QUOTE, begin, end) == end ? sos_append_range(self, begin, count) : SOS_ERROR_INVALID;
+    }
+    if (count < 2 || end[-1] != '"') {
+        return SOS_ERROR_INVALID;
+    }
+
+    const size_t old_len = sos_len(self);
+    const SosStatusAndBuf ret = sos_expand_for_overwrite(self, count - 2);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    char* out = ret.str;
+    const char* const inner_end = end - 1;
+    for (const char* p = begin + 1;;) {
+        const char* const q = scan(SPECIAL_QUOTE, p, inner_end);
+        memcpy(out, p, (size_t)(q - p));
+        out += q - p;
+        if (q == inner_end) {
+            break;
+        }
+        if (q + 1 == inner_end || q[1] != '"') {
+            return finish_decode(self, old_len, ret.str, NULL);
+        }
+        *out++ = '"';
+        p = q + 2;
+    }
+    return finish_decode(self, old_len, ret.str, out);
+}
+
+SosStatus sos_append_url_encoded(Sos* restrict self, const char* restrict begin, size_t count)
+{
+    if (count > SIZE_MAX / 3) {
+        return SOS_ERROR_MAX_CAP;
+    }
+    const char* const end = begin + count;
+    size_t out_len = count;
+    for (const char* p = scan(SPECIAL_URL, begin, end); p != end; p = scan(SPECIAL_URL, p + 1, end)) {
+        out_len += 2;
+    }
+
+    const SosStatusAndBuf ret = sos_expand_for_overwrite(self, out_len);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    char* out = ret.str;
+    for (const char* p = begin;;) {
+        const char* const q = scan(SPECIAL_URL, p, end);
+        memcpy(out, p, (size_t)(q - p));
+        out += q - p;
+        if (q == end) {
+            break;
+        }
+        const unsigned char c = (unsigned char)*q;
+        out[0] = '%';
+        out[1] = hex_digits[c >> 4];
+        out[2] = hex_digits[c & 0xf];
+        out += 3;
+        p = q + 1;
+    }
+    return SOS_OK;
+}
+
+SosStatus sos_append_url_decoded(Sos* restrict self, const char* restrict begin, size_t count)
+{
+    const size_t old_len = sos_len(self);
+    const SosStatusAndBuf ret = sos_expand_for_overwrite(self, count);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    char* out = ret.str;
+    const char* const end = begin + count;
+    for (const char* p = begin;;) {
+        const char* const q = scan(SPECIAL_PERCENT, p, end);
+        memcpy(out, p, (size_t)(q - p));
+        out += q - p;
+        if (q == end) {
+            break;
+        }
+        const int hi = end - q >= 3 ? hex_value(q[1]) : -1;
+        const int lo = hi >= 0 ? hex_value(q[2]) : -1;
+        if (lo < 0) {
+            return finish_decode(self, old_len, ret.str, NULL);
+        }
+        *out++ = (char)(hi << 4 | lo);
+        p = q + 3;
+    }
+    return finish_decode(self, old_len, ret.str, out);
+}
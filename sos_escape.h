@@ -0,0 +1,68 @@
+#ifndef SOS_ESCAPE_H
+#define SOS_ESCAPE_H
+
+// Escaping and unescaping of JSON string contents, CSV fields and URL components
+//
+// Runs of bytes that need no escaping are found with a SIMD scan and copied in bulk.
+// The output size is computed up front, so the string grows at-most once per call.
+
+#include "sos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Append a char range, escaped as the contents of a JSON string (without the surrounding quotes).
+ * `"`, `\` and control characters are escaped. Other bytes, including UTF-8 sequences, are copied as is.
+ *
+ * @pre The range does not overlap the string.
+ */
+SosStatus sos_append_json_escaped(Sos* SOS_RESTRICT self, const char* SOS_RESTRICT begin, size_t count);
+
+/**
+ * Append a char range, unescaping the contents of a JSON string (without the surrounding quotes).
+ * `\uXXXX` escapes, including surrogate pairs, are written as UTF-8.
+ *
+ * @pre The range does not overlap the string.
+ * @return SOS_ERROR_INVALID on a malformed escape, an unescaped `"` or a control character.
+ *         The string is unchanged on failure.
+ */
+SosStatus sos_append_json_unescaped(Sos* SOS_RESTRICT self, const char* SOS_RESTRICT begin, size_t count);
+
+/**
+ * Append a char range as a quoted CSV field (RFC 4180): wrapped in `"`, with `"` doubled.
+ *
+ * @pre The range does not overlap the string.
+ */
+SosStatus sos_append_csv_quoted(Sos* SOS_RESTRICT self, const char* SOS_RESTRICT begin, size_t count);
+
+/**
+ * Append the value of a CSV field. Quoted fields are unquoted, unquoted fields are copied.
+ *
+ * @pre The range does not overlap the string.
+ * @return SOS_ERROR_INVALID on unbalanced or undoubled quotes. The string is unchanged on failure.
+ */
+SosStatus sos_append_csv_unquoted(Sos* SOS_RESTRICT self, const char* SOS_RESTRICT begin, size_t count);
+
+/**
+ * Append a char range percent-encoded as a URL component (RFC 3986).
+ * All bytes except unreserved characters (`A-Z a-z 0-9 - . _ ~`) are encoded.
+ *
+ * @pre The range does not overlap the string.
+ */
+SosStatus sos_append_url_encoded(Sos* SOS_RESTRICT self, const char* SOS_RESTRICT begin, size_t count);
+
+/**
+ * Append a char range with percent-encoding decoded.
+ *
+ * @pre The range does not overlap the string.
+ * @return SOS_ERROR_INVALID on a malformed `%XX` sequence. The string is unchanged on failure.
+ */
+SosStatus sos_append_url_decoded(Sos* SOS_RESTRICT self, const char* SOS_RESTRICT begin, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_ESCAPE_H
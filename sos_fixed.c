@@ -0,0 +1,155 @@
+#include "sos_fixed.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// The char buffer directly follows the header, as char arrays need no alignment padding.
+static char*
+fixed_data(SosFixed* self)
+{
+    return (char*)(self + 1);
+}
+
+static const char*
+fixed_data_const(const SosFixed* self)
+{
+    return (const char*)(self + 1);
+}
+
+void sos_fixed_init(SosFixed* self, size_t cap)
+{
+    self->cap = cap;
+    self->len = 0;
+    fixed_data(self)[0] = 0;
+}
+
+size_t sos_fixed_len(const SosFixed* self)
+{
+    return self->len;
+}
+
+size_t sos_fixed_cap(const SosFixed* self)
+{
+    return self->cap;
+}
+
+const char* sos_fixed_cstr(const SosFixed* self)
+{
+    return fixed_data_const(self);
+}
+
+SosView sos_fixed_view(const SosFixed* self)
+{
+    return (SosView) { .data = fixed_data_const(self), .len = self->len };
+}
+
+void sos_fixed_clear(SosFixed* self)
+{
+    self->len = 0;
+    fixed_data(self)[0] = 0;
+}
+
+SosStatus sos_fixed_resize(SosFixed* self, size_t len, char ch)
+{
+    if (len > self->cap) {
+        return SOS_ERROR_MAX_CAP;
+    }
+    char* const data = fixed_data(self);
+    if (len > self->len) {
+        memset(data + self->len, ch, len - self->len);
+    }
+    self->len = len;
+    data[len] = 0;
+    return SOS_OK;
+}
+
+SosStatus sos_fixed_push(SosFixed* self, char c)
+{
+    if (self->len == self->cap) {
+        return SOS_ERROR_MAX_CAP;
+    }
+    char* const data = fixed_data(self);
+    data[self->len] = c;
+    data[self->len + 1] = 0;
+    self->len += 1;
+    return SOS_OK;
+}
+
+char sos_fixed_pop(SosFixed* self)
+{
+    char* const data = fixed_data(self);
+    self->len -= 1;
+    const char c = data[self->len];
+    data[self->len] = 0;
+    return c;
+}
+
+SosStatus sos_fixed_append_range(SosFixed* restrict self, const char* restrict begin, size_t count)
+{
+    if (count > self->cap - self->len) {
+        return SOS_ERROR_MAX_CAP;
+    }
+    char* const data = fixed_data(self);
+    memcpy(data + self->len, begin, count);
+    self->len += count;
+    data[self->len] = 0;
+    return SOS_OK;
+}
+
+SosStatus sos_fixed_append_cstr(SosFixed* restrict self, const char* restrict str)
+{
+    return sos_fixed_append_range(self, str, strlen(str));
+}
+
+SosStatus sos_fixed_append_format(SosFixed* self, const char* fmt, ...)
+{
+    char* const data = fixed_data(self);
+    const size_t room = self->cap - self->len;
+    va_list args;
+    va_start(args, fmt);
+    const int n = vsnprintf(data + self->len, room + 1, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n > room) {
+        // Drop the truncated output
+        data[self->len] = 0;
+        return SOS_ERROR_MAX_CAP;
+    }
+    self->len += (size_t)n;
+    return SOS_OK;
+}
+
+static int
+view_cmp(SosView lhs, SosView rhs)
+{
+    const size_t len = lhs.len < rhs.len ? lhs.len : rhs.len;
+    const int c = memcmp(lhs.data, rhs.data, len);
+    if (c != 0) {
+        return c;
+    }
+    return (lhs.len > rhs.len) - (lhs.len < rhs.len);
+}
+
+int sos_fixed_cmp(const SosFixed* lhs, const SosFixed* rhs)
+{
+    return view_cmp(sos_fixed_view(lhs), sos_fixed_view(rhs));
+}
+
+int sos_fixed_cmp_cstr(const SosFixed* lhs, const char* str)
+{
+    return view_cmp(sos_fixed_view(lhs), (SosView) { .data = str, .len = strlen(str) });
+}
+
+bool sos_fixed_eq(const SosFixed* lhs, const SosFixed* rhs)
+{
+    return lhs->len == rhs->len && memcmp(fixed_data_const(lhs), fixed_data_const(rhs), lhs->len) == 0;
+}
+
+uint64_t sos_fixed_hash(const SosFixed* self)
+{
+    return sos_hash_range(fixed_data_const(self), self->len);
+}
+
+SosStatus sos_fixed_to_sos(const SosFixed* self, Sos* out)
+{
+    return sos_init_from_range(out, fixed_data_const(self), self->len);
+}
@@ -0,0 +1,137 @@
+#ifndef SOS_FIXED_H
+#define SOS_FIXED_H
+
+// Fixed-capacity strings, which never allocate
+//
+// SOS_FIXED(N) is a struct type holding up to N chars inline, for the stack or inside other structs.
+// Functions take a pointer to its `hdr` member; the chars follow the header.
+// Operations that would exceed the capacity return SOS_ERROR_MAX_CAP and leave the string unchanged.
+//
+//     SOS_FIXED(128) name = SOS_FIXED_INIT(128);
+//     sos_fixed_append_cstr(&name.hdr, "http.requests");
+
+#include "sos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    size_t cap;
+    size_t len;
+} SosFixed;
+
+#define SOS_FIXED(N) struct { SosFixed hdr; char buf[(N) + 1]; }
+
+/**
+ * Initializer of an empty SOS_FIXED(N).
+ */
+#define SOS_FIXED_INIT(N) { { (N), 0 }, { 0 } }
+
+/**
+ * Initialize an empty fixed string.
+ *
+ * @pre `self` is the `hdr` of a SOS_FIXED(`cap`).
+ */
+void sos_fixed_init(SosFixed* self, size_t cap);
+
+/**
+ * Get current length of string (not including the null character).
+ *
+ * @pre `self` is the `hdr` of a SOS_FIXED(N), as are all `SosFixed` arguments below.
+ */
+size_t sos_fixed_len(const SosFixed* self);
+
+/**
+ * Get capacity, the N of SOS_FIXED(N) (not including the null character).
+ */
+size_t sos_fixed_cap(const SosFixed* self);
+
+/**
+ * Get the null-terminated C string.
+ */
+const char* sos_fixed_cstr(const SosFixed* self);
+
+/**
+ * Get an immutable string view.
+ */
+SosView sos_fixed_view(const SosFixed* self);
+
+/**
+ * Set length of string to zero.
+ */
+void sos_fixed_clear(SosFixed* self);
+
+/**
+ * Set length of string.
+ * If `len` is greater than current length, append `ch`.
+ *
+ * @return SOS_ERROR_MAX_CAP if `len` is greater than capacity, in which case the string is unchanged.
+ */
+SosStatus sos_fixed_resize(SosFixed* self, size_t len, char ch);
+
+/**
+ * Push-back a character.
+ */
+SosStatus sos_fixed_push(SosFixed* self, char c);
+
+/**
+ * Pop-back a character.
+ *
+ * @pre `self` is not empty.
+ * @return The character that was popped out.
+ */
+char sos_fixed_pop(SosFixed* self);
+
+/**
+ * Append a contiguous range of chars.
+ */
+SosStatus sos_fixed_append_range(SosFixed* SOS_RESTRICT self, const char* SOS_RESTRICT begin, size_t count);
+
+/**
+ * Append a C string.
+ */
+SosStatus sos_fixed_append_cstr(SosFixed* SOS_RESTRICT self, const char* SOS_RESTRICT str);
+
+/**
+ * Append formatted chars.
+ */
+SosStatus sos_fixed_append_format(SosFixed* self, const char* fmt, ...);
+
+/**
+ * Compare two strings by their bytes as unsigned chars, a proper prefix ordering first.
+ *
+ * @note Unlike sos_cmp(), which stops at the first null byte, embedded null bytes are compared as any other byte.
+ * @return Negative, zero or positive, as memcmp
+ */
+int sos_fixed_cmp(const SosFixed* lhs, const SosFixed* rhs);
+
+/**
+ * Compare string with C string, as sos_fixed_cmp() with the chars of `str` before its null byte.
+ */
+int sos_fixed_cmp_cstr(const SosFixed* lhs, const char* str);
+
+/**
+ * Test if two strings are equal, including the bytes after embedded null bytes.
+ *
+ * @note Strings that are equal have equal hashes, which does not hold for sos_eq() and embedded null bytes.
+ */
+bool sos_fixed_eq(const SosFixed* lhs, const SosFixed* rhs);
+
+/**
+ * Hash the content. Equal to sos_hash() of an Sos with the same content.
+ */
+uint64_t sos_fixed_hash(const SosFixed* self);
+
+/**
+ * Initialize an Sos with a copy of the content, which allocates if it does not fit the small buffer.
+ *
+ * @pre `out` is not initialized.
+ */
+SosStatus sos_fixed_to_sos(const SosFixed* self, Sos* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_FIXED_H
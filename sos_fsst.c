@@ -0,0 +1,449 @@
+#include "sos_fsst.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SOS_FSST_ROUNDS       5
+#define SOS_FSST_SAMPLE_BYTES 65536
+#define SOS_FSST_SAMPLE_COUNT 4096
+// Compressed strings of up to SOS_FSST_SCRATCH / 8 bytes are decoded in one pass into a stack buffer
+#define SOS_FSST_SCRATCH 4096
+
+// During training, ids 0-254 are codes of the current table, ids 256-511 are literal bytes.
+#define SOS_FSST_IDS 512
+
+static uint64_t
+symbol_mask(unsigned len)
+{
+    uint64_t mask = 0;
+    memset(&mask, 0xff, len);
+    return mask;
+}
+
+static uint64_t
+load_word(const unsigned char* in, size_t avail)
+{
+    uint64_t word = 0;
+    memcpy(&word, in, avail < 8 ? avail : 8);
+    return word;
+}
+
+/**
+ * Find the longest symbol matching at `in`.
+ *
+ * @return The code, or SOS_FSST_ESCAPE if no symbol matches.
+ */
+static unsigned
+match(const SosFsstTable* t, const unsigned char* in, size_t avail)
+{
+    const uint64_t word = load_word(in, avail);
+    for (unsigned k = t->bucket_begin[in[0]]; k < t->bucket_begin[in[0] + 1]; ++k) {
+        const unsigned code = t->bucket_codes[k];
+        const unsigned len = t->lens[code];
+        if (len <= avail && (word & symbol_mask(len)) == t->symbols[code]) {
+            return code;
+        }
+    }
+    return SOS_FSST_ESCAPE;
+}
+
+/**
+ * @param[out] out Room for 2 * `len` bytes
+ * @return Number of bytes written
+ */
+static size_t
+encode(const SosFsstTable* t, const unsigned char* in, size_t len, unsigned char* out)
+{
+    unsigned char* const out_begin = out;
+    size_t pos = 0;
+    while (pos < len) {
+        const unsigned code = match(t, in + pos, len - pos);
+        *out++ = (unsigned char)code;
+        if (code == SOS_FSST_ESCAPE) {
+            *out++ = in[pos++];
+        } else {
+            pos += t->lens[code];
+        }
+    }
+    return (size_t)(out - out_begin);
+}
+
+static size_t
+decoded_len(const SosFsstTable* t, const unsigned char* in, size_t len)
+{
+    size_t total = 0;
+    for (size_t pos = 0; pos < len; ++pos) {
+        if (in[pos] == SOS_FSST_ESCAPE) {
+            ++pos;
+            total += 1;
+        } else {
+            total += t->lens[in[pos]];
+        }
+    }
+    return total;
+}
+
+/**
+ * @param[out] out Room for `size` bytes, which must fit the decoded string
+ * @return Length of the decoded string
+ */
+static size_t
+decode(const SosFsstTable* t, const unsigned char* in, size_t len, char* out, size_t size)
+{
+    char* const begin = out;
+    char* const end = out + size;
+    size_t pos = 0;
+    // Fast path: copy whole 8-byte symbols while there is room
+    while (pos < len && end - out >= 9) {
+        const unsigned code = in[pos++];
+        if (code == SOS_FSST_ESCAPE) {
+            *out++ = (char)in[pos++];
+        } else {
+            memcpy(out, &t->symbols[code], 8);
+            out += t->lens[code];
+        }
+    }
+    while (pos < len) {
+        const unsigned code = in[pos++];
+        if (code == SOS_FSST_ESCAPE) {
+            *out++ = (char)in[pos++];
+        } else {
+            memcpy(out, &t->symbols[code], t->lens[code]);
+            out += t->lens[code];
+        }
+    }
+    return (size_t)(out - begin);
+}
+
+/**
+ * Build the encoder index of a table with symbols filled in.
+ */
+static void
+build_index(SosFsstTable* t)
+{
+    unsigned counts[257] = {0};
+    for (unsigned code = 0; code < t->count; ++code) {
+        unsigned char first;
+        memcpy(&first, &t->symbols[code], 1);
+        counts[first + 1] += 1;
+    }
+    for (unsigned b = 0; b < 256; ++b) {
+        counts[b + 1] += counts[b];
+    }
+    for (unsigned b = 0; b < 257; ++b) {
+        t->bucket_begin[b] = (unsigned short)counts[b];
+    }
+    for (unsigned code = 0; code < t->count; ++code) {
+        unsigned char first;
+        memcpy(&first, &t->symbols[code], 1);
+        t->bucket_codes[counts[first]++] = (unsigned char)code;
+    }
+    // Longest first within each bucket (insertion sort, buckets are small)
+    for (unsigned b = 0; b < 256; ++b) {
+        for (unsigned i = t->bucket_begin[b] + 1u; i < t->bucket_begin[b + 1]; ++i) {
+            const unsigned char code = t->bucket_codes[i];
+            unsigned j = i;
+            for (; j > t->bucket_begin[b] && t->lens[code] > t->lens[t->bucket_codes[j - 1]]; --j) {
+                t->bucket_codes[j] = t->bucket_codes[j - 1];
+            }
+            t->bucket_codes[j] = code;
+        }
+    }
+}
+
+typedef struct {
+    uint64_t symbol;
+    unsigned len;
+    uint64_t gain;
+} Candidate;
+
+static int
+candidate_symbol_cmp(const void* lhs, const void* rhs)
+{
+    const Candidate* const a = lhs;
+    const Candidate* const b = rhs;
+    if (a->len != b->len) {
+        return a->len < b->len ? -1 : 1;
+    }
+    return (a->symbol > b->symbol) - (a->symbol < b->symbol);
+}
+
+static int
+candidate_gain_cmp(const void* lhs, const void* rhs)
+{
+    const Candidate* const a = lhs;
+    const Candidate* const b = rhs;
+    if (a->gain != b->gain) {
+        return a->gain > b->gain ? -1 : 1;
+    }
+    return candidate_symbol_cmp(lhs, rhs);
+}
+
+static void
+id_symbol(const SosFsstTable* t, unsigned id, uint64_t* symbol, unsigned* len)
+{
+    if (id >= 256) {
+        const unsigned char byte = (unsigned char)(id - 256);
+        *symbol = 0;
+        memcpy(symbol, &byte, 1);
+        *len = 1;
+    } else {
+        *symbol = t->symbols[id];
+        *len = t->lens[id];
+    }
+}
+
+SosStatus sos_fsst_train(SosFsstTable* table, const Sos* sample, size_t n)
+{
+    uint32_t* const count1 = calloc(SOS_FSST_IDS, sizeof(uint32_t));
+    uint32_t* const count2 = calloc((size_t)SOS_FSST_IDS * SOS_FSST_IDS, sizeof(uint32_t));
+    Candidate* const candidates = malloc(((size_t)SOS_FSST_IDS * SOS_FSST_IDS + SOS_FSST_IDS) * sizeof(Candidate));
+    if (!count1 || !count2 || !candidates) {
+        free(count1);
+        free(count2);
+        free(candidates);
+        return SOS_ERROR_ALLOC;
+    }
+
+    memset(table, 0, sizeof(*table));
+    build_index(table);
+
+    for (int round = 0; round < SOS_FSST_ROUNDS; ++round) {
+        memset(count1, 0, SOS_FSST_IDS * sizeof(uint32_t));
+        memset(count2, 0, (size_t)SOS_FSST_IDS * SOS_FSST_IDS * sizeof(uint32_t));
+
+        // Count symbols and adjacent pairs, as parsed by the current table
+        size_t sampled = 0;
+        for (size_t i = 0; i < n && sampled < SOS_FSST_SAMPLE_BYTES; ++i) {
+            const SosView v = sos_view(&sample[i]);
+            const unsigned char* const in = (const unsigned char*)v.data;
+            sampled += v.len;
+            unsigned prev = SOS_FSST_IDS;
+            for (size_t pos = 0; pos < v.len;) {
+                const unsigned code = match(table, in + pos, v.len - pos);
+                unsigned id;
+                if (code == SOS_FSST_ESCAPE) {
+                    id = 256 + in[pos];
+                    pos += 1;
+                } else {
+                    id = code;
+                    pos += table->lens[code];
+                }
+                count1[id] += 1;
+                if (prev != SOS_FSST_IDS) {
+                    count2[prev * SOS_FSST_IDS + id] += 1;
+                }
+                prev = id;
+            }
+        }
+
+        // Candidates: current symbols, and concatenations of frequent pairs
+        size_t num = 0;
+        for (unsigned a = 0; a < SOS_FSST_IDS; ++a) {
+            if (count1[a] == 0) {
+                continue;
+            }
+            uint64_t sa;
+            unsigned la;
+            id_symbol(table, a, &sa, &la);
+            candidates[num++] = (Candidate) {.symbol = sa, .len = la, .gain = (uint64_t)count1[a] * la};
+            for (unsigned b = 0; b < SOS_FSST_IDS; ++b) {
+                const uint32_t c = count2[a * SOS_FSST_IDS + b];
+                if (c == 0) {
+                    continue;
+                }
+                uint64_t sb;
+                unsigned lb;
+                id_symbol(table, b, &sb, &lb);
+                if (la + lb > 8) {
+                    continue;
+                }
+                uint64_t concat = sa;
+                memcpy((unsigned char*)&concat + la, &sb, lb);
+                candidates[num++] = (Candidate) {.symbol = concat, .len = la + lb, .gain = (uint64_t)c * (la + lb)};
+            }
+        }
+
+        // Merge duplicates, then keep the ones with the highest gain
+        qsort(candidates, num, sizeof(Candidate), candidate_symbol_cmp);
+        size_t unique = 0;
+        for (size_t i = 0; i < num; ++i) {
+            if (unique > 0 && candidates[unique - 1].len == candidates[i].len && candidates[unique - 1].symbol == candidates[i].symbol) {
+                candidates[unique - 1].gain += candidates[i].gain;
+            } else {
+                candidates[unique++] = candidates[i];
+            }
+        }
+        qsort(candidates, unique, sizeof(Candidate), candidate_gain_cmp);
+
+        table->count = unique < SOS_FSST_MAX_SYMBOLS ? (unsigned)unique : SOS_FSST_MAX_SYMBOLS;
+        for (unsigned code = 0; code < table->count; ++code) {
+            table->symbols[code] = candidates[code].symbol;
+            table->lens[code] = (unsigned char)candidates[code].len;
+        }
+        build_index(table);
+    }
+
+    free(count1);
+    free(count2);
+    free(candidates);
+    return SOS_OK;
+}
+
+SosStatus sos_fsst_compress(const SosFsstTable* table, const char* begin, size_t count, Sos* out)
+{
+    sos_clear(out);
+    const SosStatusAndBuf ret = sos_expand_for_overwrite(out, 2 * count);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    const size_t len = encode(table, (const unsigned char*)begin, count, (unsigned char*)ret.str);
+    sos_resize(out, len, 0);
+    return SOS_OK;
+}
+
+SosStatus sos_fsst_column_build(SosFsstColumn* self, const Sos* arr, size_t n)
+{
+    // One string picked pseudo-randomly in each of evenly spaced windows, so that periodic data is not aliased
+    const size_t step = n > SOS_FSST_SAMPLE_COUNT ? n / SOS_FSST_SAMPLE_COUNT : 1;
+    const size_t sample_n = (n + step - 1) / step;
+    Sos* const sample = malloc(sample_n * sizeof(Sos) + 1);
+    if (!sample) {
+        return SOS_ERROR_ALLOC;
+    }
+    uint64_t x = 0x9E3779B97F4A7C15u;
+    for (size_t i = 0; i < sample_n; ++i) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+        const size_t begin = i * step;
+        const size_t window = n - begin < step ? n - begin : step;
+        // Shallow copies, only read by training
+        memcpy(&sample[i], &arr[begin + (size_t)(x % window)], sizeof(Sos));
+    }
+    SosStatus ret = sos_fsst_train(&self->table, sample, sample_n);
+    free(sample);
+    if (ret != SOS_OK) {
+        return ret;
+    }
+
+    size_t raw = 0;
+    size_t max_len = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const size_t len = sos_len(&arr[i]);
+        raw += len;
+        if (len > max_len) {
+            max_len = len;
+        }
+    }
+
+    self->count = n;
+    self->offsets = malloc((n + 1) * sizeof(size_t));
+    unsigned char* const scratch = malloc(2 * max_len + 1);
+    // Compressed size is unknown until encoded, start with the raw size and grow.
+    size_t cap = raw + 16;
+    self->data = malloc(cap);
+    if (!self->offsets || !scratch || !self->data) {
+        free(self->offsets);
+        free(scratch);
+        free(self->data);
+        return SOS_ERROR_ALLOC;
+    }
+
+    size_t used = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const SosView v = sos_view(&arr[i]);
+        const size_t len = encode(&self->table, (const unsigned char*)v.data, v.len, scratch);
+        if (used + len > cap) {
+            cap = (used + len) * 2;
+            unsigned char* const data = realloc(self->data, cap);
+            if (!data) {
+                free(self->offsets);
+                free(scratch);
+                free(self->data);
+                return SOS_ERROR_ALLOC;
+            }
+            self->data = data;
+        }
+        self->offsets[i] = used;
+        memcpy(self->data + used, scratch, len);
+        used += len;
+    }
+    self->offsets[n] = used;
+    free(scratch);
+
+    // Give back the unused part
+    unsigned char* const data = realloc(self->data, used + 1);
+    if (data) {
+        self->data = data;
+    }
+    return SOS_OK;
+}
+
+void sos_fsst_column_finish(SosFsstColumn* self)
+{
+    free(self->data);
+    free(self->offsets);
+    self->data = NULL;
+    self->offsets = NULL;
+    self->count = 0;
+}
+
+size_t sos_fsst_column_count(const SosFsstColumn* self)
+{
+    return self->count;
+}
+
+size_t sos_fsst_column_memory(const SosFsstColumn* self)
+{
+    return sizeof(*self) + self->offsets[self->count] + (self->count + 1) * sizeof(size_t);
+}
+
+size_t sos_fsst_column_len(const SosFsstColumn* self, size_t i)
+{
+    return decoded_len(&self->table, self->data + self->offsets[i], self->offsets[i + 1] - self->offsets[i]);
+}
+
+SosStatus sos_fsst_column_get(const SosFsstColumn* self, size_t i, Sos* out)
+{
+    const unsigned char* const in = self->data + self->offsets[i];
+    const size_t in_len = self->offsets[i + 1] - self->offsets[i];
+    if (in_len <= SOS_FSST_SCRATCH / 8) {
+        // Every code decodes to at-most 8 bytes, so the scratch fits the string
+        char scratch[SOS_FSST_SCRATCH];
+        const size_t len = decode(&self->table, in, in_len, scratch, sizeof(scratch));
+        return sos_init_from_range(out, scratch, len);
+    }
+    const size_t len = decoded_len(&self->table, in, in_len);
+
+    const SosStatusAndBuf ret = sos_init_for_overwrite(out, len);
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    // The buffer holds capacity + 1 bytes, the slack is used by the fast path of decode.
+    decode(&self->table, in, in_len, ret.str, sos_cap(out) + 1);
+    ret.str[len] = 0;
+    return SOS_OK;
+}
+
+size_t sos_fsst_column_get_into(const SosFsstColumn* self, size_t i, char* buf, size_t size)
+{
+    const unsigned char* const in = self->data + self->offsets[i];
+    const size_t in_len = self->offsets[i + 1] - self->offsets[i];
+    if (in_len < size / 8) {
+        // Room for 8 bytes per code and the null byte, decode in one pass
+        const size_t len = decode(&self->table, in, in_len, buf, size);
+        buf[len] = 0;
+        return len;
+    }
+    const size_t len = decoded_len(&self->table, in, in_len);
+    if (len < size) {
+        decode(&self->table, in, in_len, buf, size);
+        buf[len] = 0;
+    }
+    return len;
+}
+
+bool sos_fsst_column_eq(const SosFsstColumn* self, size_t i, const Sos* compressed_needle)
+{
+    const SosView needle = sos_view(compressed_needle);
+    const size_t len = self->offsets[i + 1] - self->offsets[i];
+    return len == needle.len && memcmp(self->data + self->offsets[i], needle.data, len) == 0;
+}
@@ -0,0 +1,102 @@
+#ifndef SOS_FSST_H
+#define SOS_FSST_H
+
+// Compressed string columns, in the style of FSST (Fast Static Symbol Table)
+//
+// A symbol table of up to 255 symbols, 1 to 8 bytes each, is trained from a sample of strings.
+// Strings are compressed to one byte code per symbol, with code 255 escaping a literal byte.
+// Decompression is a table lookup and an 8-byte copy per code.
+// Compression is deterministic, so equal strings compress to equal bytes, and a compressed needle
+// can be compared against compressed strings directly.
+
+#include <stdint.h>
+#include "sos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SOS_FSST_MAX_SYMBOLS 255
+#define SOS_FSST_ESCAPE      255
+
+typedef struct {
+    uint64_t      symbols[SOS_FSST_MAX_SYMBOLS]; // Symbol bytes, zero-padded
+    unsigned char lens[SOS_FSST_MAX_SYMBOLS];
+    unsigned      count;
+    // Encoder index: codes grouped by first byte, longest symbol first
+    unsigned short bucket_begin[257];
+    unsigned char  bucket_codes[SOS_FSST_MAX_SYMBOLS];
+} SosFsstTable;
+
+typedef struct {
+    SosFsstTable   table;
+    unsigned char* data;    // Compressed strings, back to back
+    size_t*        offsets; // `count` + 1 offsets into `data`
+    size_t         count;
+} SosFsstColumn;
+
+/**
+ * Train a symbol table from a sample of strings.
+ * At-most 64 KiB of the sample is used.
+ */
+SosStatus sos_fsst_train(SosFsstTable* table, const Sos* sample, size_t n);
+
+/**
+ * Compress a char range with a symbol table, replacing the content of `out`.
+ * The compressed bytes may contain null bytes.
+ */
+SosStatus sos_fsst_compress(const SosFsstTable* table, const char* begin, size_t count, Sos* out);
+
+/**
+ * Build a compressed column from an array of strings.
+ * The symbol table is trained on an evenly spaced sample of the array.
+ *
+ * @pre `self` is not initialized.
+ */
+SosStatus sos_fsst_column_build(SosFsstColumn* self, const Sos* arr, size_t n);
+
+/**
+ * Destroy a column.
+ */
+void sos_fsst_column_finish(SosFsstColumn* self);
+
+/**
+ * Get number of strings in the column.
+ */
+size_t sos_fsst_column_count(const SosFsstColumn* self);
+
+/**
+ * Get memory held by the column, in bytes.
+ */
+size_t sos_fsst_column_memory(const SosFsstColumn* self);
+
+/**
+ * Get the length of the `i`-th string when decompressed.
+ */
+size_t sos_fsst_column_len(const SosFsstColumn* self, size_t i);
+
+/**
+ * Decompress the `i`-th string into `out`.
+ *
+ * @pre `out` is not initialized.
+ */
+SosStatus sos_fsst_column_get(const SosFsstColumn* self, size_t i, Sos* out);
+
+/**
+ * Decompress the `i`-th string into a caller buffer, followed by a null byte.
+ *
+ * @return Length of the string. If it is not less than `size`, nothing is written.
+ */
+size_t sos_fsst_column_get_into(const SosFsstColumn* self, size_t i, char* buf, size_t size);
+
+/**
+ * Test if the `i`-th string is equal to a needle compressed with sos_fsst_compress() and the column's table.
+ * No decompression is done.
+ */
+bool sos_fsst_column_eq(const SosFsstColumn* self, size_t i, const Sos* compressed_needle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_FSST_H
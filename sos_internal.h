@@ -0,0 +1,39 @@
+#ifndef SOS_INTERNAL_H
+#define SOS_INTERNAL_H
+
+// Helpers shared by the library sources, not part of the public API
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOS_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * Count trailing zero bits, such as the position of the first match in a byte mask.
+ *
+ * @pre `x` is not zero.
+ */
+static inline unsigned
+count_trailing_zeros(unsigned x)
+{
+#if defined(__GNUC__)
+    return (unsigned)__builtin_ctz(x);
+#elif defined(_MSC_VER)
+    unsigned long n;
+    _BitScanForward(&n, x);
+    return (unsigned)n;
+#else
+    unsigned n = 0;
+    while ((x & 1u) == 0) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+#endif // SOS_INTERNAL_H
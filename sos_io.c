@@ -0,0 +1,210 @@
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "sos_io.h"
+#include <string.h>
+#include <stdint.h> // SIZE_MAX
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+
+// Number of iovec entries passed to one writev()
+#if defined(IOV_MAX) && IOV_MAX < 1024
+#define SOS_IOV_BATCH IOV_MAX
+#else
+#define SOS_IOV_BATCH 1024
+#endif
+
+#define SOS_READ_CHUNK 65536
+
+/**
+ * Read into `buf` until it is full or end of file.
+ *
+ * @return Number of bytes read, or -1 on error.
+ */
+static ssize_t
+read_full(int fd, char* buf, size_t count)
+{
+    size_t done = 0;
+    while (done < count) {
+        const ssize_t ret = read(fd, buf + done, count - done);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (ret == 0) {
+            break;
+        }
+        done += (size_t)ret;
+    }
+    return (ssize_t)done;
+}
+
+SosStatus sos_read_fd(Sos* self, int fd)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        return SOS_ERROR_IO;
+    }
+
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        // Also accounts for the file offset, which may not be at the beginning.
+        const off_t pos = lseek(fd, 0, SEEK_CUR);
+        const off_t remaining = (pos >= 0 && pos < st.st_size) ? st.st_size - pos : 0;
+        if ((unsigned long long)remaining > SIZE_MAX - 2) {
+            return SOS_ERROR_MAX_CAP;
+        }
+
+        const SosStatusAndBuf ret = sos_init_for_overwrite(self, (size_t)remaining);
+        if (ret.status != SOS_OK) {
+            return ret.status;
+        }
+        const ssize_t n = read_full(fd, ret.str, (size_t)remaining);
+        if (n < 0) {
+            sos_finish(self);
+            return SOS_ERROR_IO;
+        }
+        // The file could have been truncated meanwhile
+        sos_resize(self, (size_t)n, 0);
+        return SOS_OK;
+    }
+
+    // Size is unknown: pipes, sockets, special files
+    sos_init(self);
+    for (;;) {
+        const size_t len = sos_len(self);
+        if (sos_cap(self) - len < SOS_READ_CHUNK && len <= SIZE_MAX / 4) {
+            // Grow geometrically, so that reading a long stream copies each byte O(1) times
+            const size_t cap = sos_cap(self);
+            const SosStatus status = sos_reserve(self, 2 * cap > len + SOS_READ_CHUNK ? 2 * cap + 1 : len + SOS_READ_CHUNK);
+            if (status != SOS_OK) {
+                sos_finish(self);
+                return status;
+            }
+        }
+        const SosStatusAndBuf ret = sos_expand_for_overwrite(self, SOS_READ_CHUNK);
+        if (ret.status != SOS_OK) {
+            sos_finish(self);
+            return ret.status;
+        }
+        const ssize_t n = read_full(fd, ret.str, SOS_READ_CHUNK);
+        if (n < 0) {
+            sos_finish(self);
+            return SOS_ERROR_IO;
+        }
+        sos_resize(self, len + (size_t)n, 0);
+        if ((size_t)n < SOS_READ_CHUNK) {
+            return SOS_OK;
+        }
+    }
+}
+
+SosStatus sos_read_file(Sos* self, const char* path)
+{
+    int fd;
+    do {
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) {
+        return SOS_ERROR_IO;
+    }
+
+    const SosStatus ret = sos_read_fd(self, fd);
+    const int saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
+    return ret;
+}
+
+SosStatus sos_getline(Sos* self, FILE* stream)
+{
+    sos_clear(self);
+
+    SosStatus ret = SOS_OK;
+    flockfile(stream);
+    for (;;) {
+        const size_t len = sos_len(self);
+        size_t spare = sos_cap(self) - len;
+        if (spare == 0) {
+            ret = sos_reserve(self, len < 127 ? 127 : len * 2 + 1);
+            if (ret != SOS_OK) {
+                break;
+            }
+            spare = sos_cap(self) - len;
+        }
+
+        // Read byte by byte, so that null bytes are kept and the line length is known
+        char* const buf = sos_cstr_mut(self) + len;
+        size_t count = 0;
+        int ch = 0;
+        while (count < spare && (ch = getc_unlocked(stream)) != EOF) {
+            buf[count++] = (char)ch;
+            if (ch == '\n') {
+                break;
+            }
+        }
+        // Commit the chars read. They lie within capacity, so the buffer is not reallocated.
+        sos_expand_for_overwrite(self, count);
+        if (ch == EOF) {
+            ret = ferror(stream) ? SOS_ERROR_IO : SOS_OK;
+            break;
+        }
+        if (ch == '\n') {
+            break;
+        }
+    }
+    funlockfile(stream);
+    return ret;
+}
+
+SosStatus sos_writev_fd(int fd, const Sos* strs, size_t n)
+{
+    struct iovec iov[SOS_IOV_BATCH];
+
+    size_t next = 0; // next string to be put into iov
+    while (next < n) {
+        int count = 0;
+        for (; next < n && count < SOS_IOV_BATCH; ++next) {
+            const SosView v = sos_view(&strs[next]);
+            if (v.len == 0) {
+                continue;
+            }
+            iov[count].iov_base = (void*)v.data;
+            iov[count].iov_len = v.len;
+            ++count;
+        }
+
+        struct iovec* cur = iov;
+        while (count > 0) {
+            ssize_t written = writev(fd, cur, count);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return SOS_ERROR_IO;
+            }
+            // Skip what has been written, resume from a partially written entry
+            while (count > 0 && (size_t)written >= cur->iov_len) {
+                written -= (ssize_t)cur->iov_len;
+                ++cur;
+                --count;
+            }
+            if (count > 0) {
+                cur->iov_base = (char*)cur->iov_base + written;
+                cur->iov_len -= (size_t)written;
+            }
+        }
+    }
+
+    return SOS_OK;
+}
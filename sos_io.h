@@ -0,0 +1,52 @@
+#ifndef SOS_IO_H
+#define SOS_IO_H
+
+// File and file descriptor I/O for Sos strings. Only available on POSIX platforms.
+
+#include <stdio.h>
+#include "sos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialize by reading everything from a file descriptor, until end of file.
+ * For regular files, the buffer is sized with fstat() and data is read straight into it, in one allocation.
+ * The file is read as of the time of the call, data appended later might not be included.
+ *
+ * @pre `self` is not initialized.
+ * @post On success, `self` is initialized with the content read.
+ *       On failure, `self` is not initialized. SOS_ERROR_IO is returned if a system call fails.
+ */
+SosStatus sos_read_fd(Sos* self, int fd);
+
+/**
+ * Initialize by reading a whole file.
+ *
+ * @pre `self` is not initialized.
+ * @see sos_read_fd
+ */
+SosStatus sos_read_file(Sos* self, const char* path);
+
+/**
+ * Read the next line from `stream`, replacing the content of `self`.
+ * The line is read directly into the managed buffer, so capacity is reused across calls.
+ *
+ * @post On success, `self` holds the line including the trailing newline, if any.
+ *       `self` is empty if and only if the end of stream has been reached.
+ *       Null bytes are kept as part of the line.
+ */
+SosStatus sos_getline(Sos* self, FILE* stream);
+
+/**
+ * Write an array of strings to a file descriptor, using vectored writes with no staging copy.
+ * Partial writes are resumed, so all strings are written unless an error occurs.
+ */
+SosStatus sos_writev_fd(int fd, const Sos* strs, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_IO_H
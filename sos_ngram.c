@@ -0,0 +1,740 @@
+#include "sos_ngram.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SOS_NGRAM_BLOCK 128
+
+// Trigrams are split into partitions by hash, each with its own table, so that a parallel build
+// appends to posting lists of different partitions on different threads with no locking.
+#define SOS_NGRAM_PARTITION_BITS 6
+#define SOS_NGRAM_PARTITIONS     (1u << SOS_NGRAM_PARTITION_BITS)
+
+// Strings per round of a parallel build, bounding the memory of extracted trigrams, and per extraction task
+#define SOS_NGRAM_BATCH ((size_t)1 << 18)
+#define SOS_NGRAM_CHUNK ((size_t)4096)
+
+// Candidates are verified directly rather than intersected further once they are few, or once the next posting list
+// has more than this many ids per candidate, as decoding it would cost more than the verification it saves.
+#define SOS_NGRAM_VERIFY      64
+#define SOS_NGRAM_MAX_DENSITY 16
+
+typedef struct {
+    uint32_t first;  // First id of the block
+    uint32_t offset; // Offset of the deltas of the following ids
+} Skip;
+
+typedef struct {
+    uint32_t       key; // Trigram + 1, zero if the slot is free
+    uint32_t       count;
+    uint32_t       last;
+    uint32_t       size; // Bytes of deltas
+    uint32_t       cap;
+    uint32_t       skip_cap;
+    unsigned char* data;
+    Skip*          skips; // One per block
+} Posting;
+
+typedef struct {
+    Posting* slots; // Open addressing with linear probing, NULL until the first trigram
+    size_t   mask;
+    size_t   used;
+} Partition;
+
+struct SosNgramIndex {
+    Partition parts[SOS_NGRAM_PARTITIONS];
+
+    // Strings, null-terminated and back to back. String i spans [offsets[i], offsets[i + 1] - 1).
+    char*   chars;
+    size_t  chars_len;
+    size_t  chars_cap;
+    size_t* offsets;
+    size_t  offsets_cap;
+    size_t  count;
+};
+
+static uint32_t
+trigram_at(const char* p)
+{
+    const unsigned char* const u = (const unsigned char*)p;
+    return (uint32_t)u[0] << 16 | (uint32_t)u[1] << 8 | u[2];
+}
+
+static uint64_t
+trigram_hash(uint32_t t)
+{
+    return (uint64_t)t * 0x9E3779B97F4A7C15u;
+}
+
+static unsigned
+partition_of(uint64_t hash)
+{
+    return (unsigned)(hash >> (64 - SOS_NGRAM_PARTITION_BITS));
+}
+
+static size_t
+slot_of(uint64_t hash, size_t mask)
+{
+    return (size_t)(hash >> 20) & mask;
+}
+
+static unsigned char*
+put_varint(unsigned char* p, uint32_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+static const unsigned char*
+get_varint(const unsigned char* p, uint32_t* v)
+{
+    uint32_t x = 0;
+    unsigned shift = 0;
+    for (;;) {
+        const unsigned char b = *p++;
+        x |= (uint32_t)(b & 0x7F) << shift;
+        if (b < 0x80) {
+            break;
+        }
+        shift += 7;
+    }
+    *v = x;
+    return p;
+}
+
+static uint32_t
+posting_blocks(const Posting* p)
+{
+    return (p->count + SOS_NGRAM_BLOCK - 1) / SOS_NGRAM_BLOCK;
+}
+
+/**
+ * Append an id, greater than or equal to the last one. Repeated ids are stored once.
+ *
+ * @post On failure, the list is unchanged.
+ */
+static SosStatus
+posting_append(Posting* p, uint32_t id)
+{
+    if (p->count > 0 && id == p->last) {
+        return SOS_OK;
+    }
+    if (p->count % SOS_NGRAM_BLOCK == 0) {
+        const uint32_t nblocks = p->count / SOS_NGRAM_BLOCK;
+        if (nblocks == p->skip_cap) {
+            const uint32_t cap = p->skip_cap ? 2 * p->skip_cap : 1;
+            Skip* const skips = realloc(p->skips, cap * sizeof(Skip));
+            if (!skips) {
+                return SOS_ERROR_ALLOC;
+            }
+            p->skips = skips;
+            p->skip_cap = cap;
+        }
+        p->skips[nblocks].first = id;
+        p->skips[nblocks].offset = p->size;
+    } else {
+        if (p->cap - p->size < 5) {
+            if (p->cap > UINT32_MAX / 2) {
+                return SOS_ERROR_MAX_CAP;
+            }
+            const uint32_t cap = p->cap ? 2 * p->cap : 16;
+            unsigned char* const data = realloc(p->data, cap);
+            if (!data) {
+                return SOS_ERROR_ALLOC;
+            }
+            p->data = data;
+            p->cap = cap;
+        }
+        p->size = (uint32_t)(put_varint(p->data + p->size, id - p->last) - p->data);
+    }
+    p->last = id;
+    p->count += 1;
+    return SOS_OK;
+}
+
+/**
+ * Remove ids not less than `first_id`.
+ */
+static void
+posting_truncate(Posting* p, uint32_t first_id)
+{
+    if (p->count == 0 || p->last < first_id) {
+        return;
+    }
+    uint32_t b = posting_blocks(p);
+    while (b > 0 && p->skips[b - 1].first >= first_id) {
+        --b;
+    }
+    if (b == 0) {
+        p->count = 0;
+        p->size = 0;
+        return;
+    }
+
+    // Keep the ids of the last remaining block that are below `first_id`
+    --b;
+    const uint32_t in_block = p->count - b * SOS_NGRAM_BLOCK < SOS_NGRAM_BLOCK ? p->count - b * SOS_NGRAM_BLOCK : SOS_NGRAM_BLOCK;
+    uint32_t id = p->skips[b].first;
+    uint32_t offset = p->skips[b].offset;
+    uint32_t k = 1;
+    for (; k < in_block; ++k) {
+        uint32_t delta;
+        const unsigned char* const next = get_varint(p->data + offset, &delta);
+        if (id + delta >= first_id) {
+            break;
+        }
+        id += delta;
+        offset = (uint32_t)(next - p->data);
+    }
+    p->count = b * SOS_NGRAM_BLOCK + k;
+    p->size = offset;
+    p->last = id;
+}
+
+/**
+ * Decode block `b` into `ids`.
+ *
+ * @return Number of ids in the block.
+ */
+static uint32_t
+decode_block(const Posting* p, uint32_t b, uint32_t* ids)
+{
+    const uint32_t left = p->count - b * SOS_NGRAM_BLOCK;
+    const uint32_t n = left < SOS_NGRAM_BLOCK ? left : SOS_NGRAM_BLOCK;
+    uint32_t id = p->skips[b].first;
+    ids[0] = id;
+    if (n > 1) {
+        const unsigned char* q = p->data + p->skips[b].offset;
+        for (uint32_t k = 1; k < n; ++k) {
+            uint32_t delta;
+            q = get_varint(q, &delta);
+            id += delta;
+            ids[k] = id;
+        }
+    }
+    return n;
+}
+
+/**
+ * Keep the candidates, in ascending order, that are in the list.
+ * Blocks are found by binary search of the skip table, and decoded only if a candidate may be in them.
+ *
+ * @return Number of candidates kept.
+ */
+static size_t
+posting_intersect(const Posting* p, uint32_t* cand, size_t m)
+{
+    uint32_t ids[SOS_NGRAM_BLOCK];
+    const uint32_t nblocks = posting_blocks(p);
+    uint32_t decoded = UINT32_MAX;
+    uint32_t b = 0;
+    uint32_t n = 0;
+    uint32_t k = 0;
+    size_t out = 0;
+    for (size_t i = 0; i < m; ++i) {
+        const uint32_t c = cand[i];
+        if (p->skips[b].first > c) {
+            continue;
+        }
+        // Last block starting at or before `c`
+        uint32_t lo = b;
+        uint32_t hi = nblocks;
+        while (hi - lo > 1) {
+            const uint32_t mid = lo + (hi - lo) / 2;
+            if (p->skips[mid].first <= c) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo != decoded) {
+            n = decode_block(p, lo, ids);
+            k = 0;
+            decoded = lo;
+            b = lo;
+        }
+        while (k < n && ids[k] < c) {
+            ++k;
+        }
+        if (k < n && ids[k] == c) {
+            cand[out++] = c;
+        }
+    }
+    return out;
+}
+
+static const Posting*
+partition_find(const Partition* part, uint32_t trigram, uint64_t hash)
+{
+    if (!part->slots) {
+        return NULL;
+    }
+    for (size_t i = slot_of(hash, part->mask);; i = (i + 1) & part->mask) {
+        const Posting* const slot = &part->slots[i];
+        if (slot->key == trigram + 1) {
+            return slot;
+        }
+        if (slot->key == 0) {
+            return NULL;
+        }
+    }
+}
+
+static SosStatus
+partition_grow(Partition* part)
+{
+    const size_t cap = part->slots ? 2 * (part->mask + 1) : 16;
+    Posting* const slots = calloc(cap, sizeof(Posting));
+    if (!slots) {
+        return SOS_ERROR_ALLOC;
+    }
+    if (part->slots) {
+        for (size_t i = 0; i <= part->mask; ++i) {
+            const Posting* const old = &part->slots[i];
+            if (old->key == 0) {
+                continue;
+            }
+            size_t j = slot_of(trigram_hash(old->key - 1), cap - 1);
+            while (slots[j].key != 0) {
+                j = (j + 1) & (cap - 1);
+            }
+            slots[j] = *old;
+        }
+        free(part->slots);
+    }
+    part->slots = slots;
+    part->mask = cap - 1;
+    return SOS_OK;
+}
+
+/**
+ * Find the posting list of a trigram, adding an empty one if there is none.
+ *
+ * @return The list, or NULL if allocation fails.
+ */
+static Posting*
+partition_get(Partition* part, uint32_t trigram, uint64_t hash)
+{
+    if (!part->slots || (part->used + 1) * 2 > part->mask + 1) {
+        if (partition_grow(part) != SOS_OK) {
+            return NULL;
+        }
+    }
+    for (size_t i = slot_of(hash, part->mask);; i = (i + 1) & part->mask) {
+        Posting* const slot = &part->slots[i];
+        if (slot->key == trigram + 1) {
+            return slot;
+        }
+        if (slot->key == 0) {
+            slot->key = trigram + 1;
+            part->used += 1;
+            return slot;
+        }
+    }
+}
+
+static SosStatus
+index_trigram(SosNgramIndex* index, uint32_t trigram, uint32_t id)
+{
+    const uint64_t hash = trigram_hash(trigram);
+    Posting* const p = partition_get(&index->parts[partition_of(hash)], trigram, hash);
+    return p ? posting_append(p, id) : SOS_ERROR_ALLOC;
+}
+
+static SosStatus
+index_string(SosNgramIndex* index, size_t id)
+{
+    const SosView str = sos_ngram_index_get(index, id);
+    for (size_t i = 0; i + 3 <= str.len; ++i) {
+        const SosStatus status = index_trigram(index, trigram_at(str.data + i), (uint32_t)id);
+        if (status != SOS_OK) {
+            return status;
+        }
+    }
+    return SOS_OK;
+}
+
+static SosStatus
+reserve_strings(SosNgramIndex* index, size_t n, size_t bytes)
+{
+    if (n > SIZE_MAX / sizeof(size_t) / 2 - index->count - 1 || bytes > SIZE_MAX / 2 - index->chars_len) {
+        return SOS_ERROR_MAX_CAP;
+    }
+    if (index->count + 1 + n > index->offsets_cap) {
+        size_t cap = 2 * index->offsets_cap;
+        if (cap < index->count + 1 + n) {
+            cap = index->count + 1 + n;
+        }
+        size_t* const offsets = realloc(index->offsets, cap * sizeof(size_t));
+        if (!offsets) {
+            return SOS_ERROR_ALLOC;
+        }
+        index->offsets = offsets;
+        index->offsets_cap = cap;
+    }
+    if (index->chars_len + bytes > index->chars_cap) {
+        size_t cap = 2 * index->chars_cap;
+        if (cap < index->chars_len + bytes) {
+            cap = index->chars_len + bytes;
+        }
+        char* const chars = realloc(index->chars, cap);
+        if (!chars) {
+            return SOS_ERROR_ALLOC;
+        }
+        index->chars = chars;
+        index->chars_cap = cap;
+    }
+    return SOS_OK;
+}
+
+// @pre Space is reserved.
+static void
+push_string(SosNgramIndex* index, SosView str)
+{
+    char* const dst = index->chars + index->chars_len;
+    if (str.len) {
+        memcpy(dst, str.data, str.len);
+    }
+    dst[str.len] = 0;
+    index->chars_len += str.len + 1;
+    index->count += 1;
+    index->offsets[index->count] = index->chars_len;
+}
+
+/**
+ * Remove strings from `first_id` on, with their postings.
+ */
+static void
+rollback(SosNgramIndex* index, size_t first_id)
+{
+    for (unsigned i = 0; i < SOS_NGRAM_PARTITIONS; ++i) {
+        const Partition* const part = &index->parts[i];
+        for (size_t j = 0; part->slots && j <= part->mask; ++j) {
+            posting_truncate(&part->slots[j], (uint32_t)first_id);
+        }
+    }
+    index->count = first_id;
+    index->chars_len = index->offsets[first_id];
+}
+
+SosNgramIndex* sos_ngram_index_create(void)
+{
+    SosNgramIndex* const index = calloc(1, sizeof(SosNgramIndex));
+    if (!index) {
+        return NULL;
+    }
+    index->offsets = malloc(16 * sizeof(size_t));
+    if (!index->offsets) {
+        free(index);
+        return NULL;
+    }
+    index->offsets_cap = 16;
+    index->offsets[0] = 0;
+    return index;
+}
+
+void sos_ngram_index_destroy(SosNgramIndex* index)
+{
+    if (!index) {
+        return;
+    }
+    for (unsigned i = 0; i < SOS_NGRAM_PARTITIONS; ++i) {
+        Partition* const part = &index->parts[i];
+        for (size_t j = 0; part->slots && j <= part->mask; ++j) {
+            free(part->slots[j].data);
+            free(part->slots[j].skips);
+        }
+        free(part->slots);
+    }
+    free(index->chars);
+    free(index->offsets);
+    free(index);
+}
+
+size_t sos_ngram_index_count(const SosNgramIndex* index)
+{
+    return index->count;
+}
+
+size_t sos_ngram_index_memory(const SosNgramIndex* index)
+{
+    size_t bytes = sizeof(SosNgramIndex) + index->chars_cap + index->offsets_cap * sizeof(size_t);
+    for (unsigned i = 0; i < SOS_NGRAM_PARTITIONS; ++i) {
+        const Partition* const part = &index->parts[i];
+        if (!part->slots) {
+            continue;
+        }
+        bytes += (part->mask + 1) * sizeof(Posting);
+        for (size_t j = 0; j <= part->mask; ++j) {
+            bytes += part->slots[j].cap + part->slots[j].skip_cap * sizeof(Skip);
+        }
+    }
+    return bytes;
+}
+
+SosView sos_ngram_index_get(const SosNgramIndex* index, size_t id)
+{
+    const size_t begin = index->offsets[id];
+    return (SosView) {.data = index->chars + begin, .len = index->offsets[id + 1] - begin - 1};
+}
+
+SosStatus sos_ngram_index_insert(SosNgramIndex* index, SosView str)
+{
+    if (index->count >= UINT32_MAX) {
+        return SOS_ERROR_MAX_CAP;
+    }
+    SosStatus status = reserve_strings(index, 1, str.len + 1);
+    if (status != SOS_OK) {
+        return status;
+    }
+    const size_t id = index->count;
+    push_string(index, str);
+    status = index_string(index, id);
+    if (status != SOS_OK) {
+        rollback(index, id);
+    }
+    return status;
+}
+
+typedef struct {
+    uint32_t trigram;
+    uint32_t id;
+} Occurrence;
+
+// Occurrences extracted from a chunk of strings, grouped by partition in order of ids
+typedef struct {
+    Occurrence* occs;
+    size_t      offsets[SOS_NGRAM_PARTITIONS + 1];
+    SosStatus   status;
+} ExtractChunk;
+
+typedef struct {
+    SosNgramIndex* index;
+    size_t         first; // Id of the first string of the batch
+    ExtractChunk*  chunks;
+    size_t         nchunks;
+    SosStatus      statuses[SOS_NGRAM_PARTITIONS];
+} BuildJob;
+
+static void
+extract_task(void* ctx, size_t begin, size_t end)
+{
+    BuildJob* const job = ctx;
+    ExtractChunk* const chunk = &job->chunks[begin / SOS_NGRAM_CHUNK];
+
+    size_t counts[SOS_NGRAM_PARTITIONS] = {0};
+    for (size_t i = begin; i < end; ++i) {
+        const SosView str = sos_ngram_index_get(job->index, job->first + i);
+        for (size_t k = 0; k + 3 <= str.len; ++k) {
+            counts[partition_of(trigram_hash(trigram_at(str.data + k)))] += 1;
+        }
+    }
+    chunk->offsets[0] = 0;
+    for (unsigned p = 0; p < SOS_NGRAM_PARTITIONS; ++p) {
+        chunk->offsets[p + 1] = chunk->offsets[p] + counts[p];
+        counts[p] = chunk->offsets[p];
+    }
+    const size_t total = chunk->offsets[SOS_NGRAM_PARTITIONS];
+    chunk->occs = total ? malloc(total * sizeof(Occurrence)) : NULL;
+    if (total && !chunk->occs) {
+        chunk->status = SOS_ERROR_ALLOC;
+        return;
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+        const SosView str = sos_ngram_index_get(job->index, job->first + i);
+        for (size_t k = 0; k + 3 <= str.len; ++k) {
+            const uint32_t trigram = trigram_at(str.data + k);
+            Occurrence* const occ = &chunk->occs[counts[partition_of(trigram_hash(trigram))]++];
+            occ->trigram = trigram;
+            occ->id = (uint32_t)(job->first + i);
+        }
+    }
+    chunk->status = SOS_OK;
+}
+
+static void
+append_task(void* ctx, size_t begin, size_t end)
+{
+    BuildJob* const job = ctx;
+    for (size_t p = begin; p < end; ++p) {
+        Partition* const part = &job->index->parts[p];
+        SosStatus status = SOS_OK;
+        for (size_t c = 0; c < job->nchunks && status == SOS_OK; ++c) {
+            const ExtractChunk* const chunk = &job->chunks[c];
+            for (size_t k = chunk->offsets[p]; k < chunk->offsets[p + 1]; ++k) {
+                const Occurrence* const occ = &chunk->occs[k];
+                Posting* const posting = partition_get(part, occ->trigram, trigram_hash(occ->trigram));
+                status = posting ? posting_append(posting, occ->id) : SOS_ERROR_ALLOC;
+                if (status != SOS_OK) {
+                    break;
+                }
+            }
+        }
+        job->statuses[p] = status;
+    }
+}
+
+static SosStatus
+build_parallel(SosNgramIndex* index, SosPool* pool, size_t first, size_t end)
+{
+    BuildJob job = {.index = index};
+    job.chunks = calloc(SOS_NGRAM_BATCH / SOS_NGRAM_CHUNK, sizeof(ExtractChunk));
+    if (!job.chunks) {
+        return SOS_ERROR_ALLOC;
+    }
+    SosStatus status = SOS_OK;
+    for (size_t batch = first; batch < end && status == SOS_OK; batch += SOS_NGRAM_BATCH) {
+        const size_t n = end - batch < SOS_NGRAM_BATCH ? end - batch : SOS_NGRAM_BATCH;
+        job.first = batch;
+        job.nchunks = (n + SOS_NGRAM_CHUNK - 1) / SOS_NGRAM_CHUNK;
+        sos_pool_run(pool, n, SOS_NGRAM_CHUNK, extract_task, &job);
+        for (size_t c = 0; c < job.nchunks; ++c) {
+            if (job.chunks[c].status != SOS_OK) {
+                status = job.chunks[c].status;
+            }
+        }
+        if (status == SOS_OK) {
+            sos_pool_run(pool, SOS_NGRAM_PARTITIONS, 1, append_task, &job);
+            for (unsigned p = 0; p < SOS_NGRAM_PARTITIONS; ++p) {
+                if (job.statuses[p] != SOS_OK) {
+                    status = job.statuses[p];
+                }
+            }
+        }
+        for (size_t c = 0; c < job.nchunks; ++c) {
+            free(job.chunks[c].occs);
+            job.chunks[c].occs = NULL;
+        }
+    }
+    free(job.chunks);
+    return status;
+}
+
+SosStatus sos_ngram_index_add(SosNgramIndex* index, SosPool* pool, const Sos* strs, size_t n)
+{
+    if (n > UINT32_MAX - index->count) {
+        return SOS_ERROR_MAX_CAP;
+    }
+    size_t bytes = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const size_t len = sos_len(&strs[i]);
+        if (len >= SIZE_MAX / 2 - bytes) {
+            return SOS_ERROR_MAX_CAP;
+        }
+        bytes += len + 1;
+    }
+    SosStatus status = reserve_strings(index, n, bytes);
+    if (status != SOS_OK) {
+        return status;
+    }
+    const size_t first = index->count;
+    for (size_t i = 0; i < n; ++i) {
+        push_string(index, sos_view(&strs[i]));
+    }
+
+    if (sos_pool_size(pool) == 1) {
+        for (size_t id = first; id < first + n && status == SOS_OK; ++id) {
+            status = index_string(index, id);
+        }
+    } else {
+        status = build_parallel(index, pool, first, first + n);
+    }
+    if (status != SOS_OK) {
+        rollback(index, first);
+    }
+    return status;
+}
+
+static bool
+contains(SosView hay, SosView needle)
+{
+    if (needle.len == 0) {
+        return true;
+    }
+    if (hay.len < needle.len) {
+        return false;
+    }
+    const char* p = hay.data;
+    const char* const end = hay.data + hay.len - needle.len + 1;
+    for (;;) {
+        p = memchr(p, needle.data[0], (size_t)(end - p));
+        if (!p) {
+            return false;
+        }
+        if (memcmp(p + 1, needle.data + 1, needle.len - 1) == 0) {
+            return true;
+        }
+        ++p;
+    }
+}
+
+static int
+rarest_first(const void* lhs, const void* rhs)
+{
+    const Posting* const a = *(const Posting* const*)lhs;
+    const Posting* const b = *(const Posting* const*)rhs;
+    if (a->count != b->count) {
+        return a->count < b->count ? -1 : 1;
+    }
+    // Same lists next to each other
+    return ((uintptr_t)a > (uintptr_t)b) - ((uintptr_t)a < (uintptr_t)b);
+}
+
+SosStatus sos_ngram_index_search(const SosNgramIndex* index, SosView needle, SosNgramVisitor fn, void* ctx)
+{
+    if (needle.len < 3) {
+        for (size_t id = 0; id < index->count; ++id) {
+            const SosView str = sos_ngram_index_get(index, id);
+            if (contains(str, needle) && !fn(id, str, ctx)) {
+                break;
+            }
+        }
+        return SOS_OK;
+    }
+
+    const size_t ntrigrams = needle.len - 2;
+    const Posting** const lists = malloc(ntrigrams * sizeof(*lists));
+    if (!lists) {
+        return SOS_ERROR_ALLOC;
+    }
+    for (size_t i = 0; i < ntrigrams; ++i) {
+        const uint32_t trigram = trigram_at(needle.data + i);
+        const uint64_t hash = trigram_hash(trigram);
+        lists[i] = partition_find(&index->parts[partition_of(hash)], trigram, hash);
+        if (!lists[i] || lists[i]->count == 0) {
+            free(lists);
+            return SOS_OK;
+        }
+    }
+    qsort(lists, ntrigrams, sizeof(*lists), rarest_first);
+
+    const Posting* const rarest = lists[0];
+    uint32_t* const cand = malloc(rarest->count * sizeof(uint32_t));
+    if (!cand) {
+        free(lists);
+        return SOS_ERROR_ALLOC;
+    }
+    size_t m = 0;
+    for (uint32_t b = 0; b < posting_blocks(rarest); ++b) {
+        m += decode_block(rarest, b, cand + m);
+    }
+    for (size_t i = 1; i < ntrigrams && m > SOS_NGRAM_VERIFY && lists[i]->count / SOS_NGRAM_MAX_DENSITY <= m; ++i) {
+        if (lists[i] != lists[i - 1]) {
+            m = posting_intersect(lists[i], cand, m);
+        }
+    }
+    free(lists);
+
+    for (size_t i = 0; i < m; ++i) {
+        const SosView str = sos_ngram_index_get(index, cand[i]);
+        if (contains(str, needle) && !fn(cand[i], str, ctx)) {
+            break;
+        }
+    }
+    free(cand);
+    return SOS_OK;
+}
@@ -0,0 +1,86 @@
+#ifndef SOS_NGRAM_H
+#define SOS_NGRAM_H
+
+// Substring index: trigram posting lists over a collection of strings
+//
+// Each string gets the next id, and each of its trigrams (3 consecutive bytes) lists the ids of the strings containing it.
+// A search intersects the lists of the needle's trigrams, rarest first, and verifies the remaining candidates
+// against the stored strings, so results are exact. Needles shorter than 3 bytes have no trigram and scan all strings.
+//
+// Posting lists hold ascending ids as varint-encoded deltas, in blocks of 128 ids, with the first id and offset
+// of each block in a skip table. Intersections decode only the blocks that may hold a candidate.
+
+#include <stdint.h>
+#include "sos.h"
+#include "sos_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SosNgramIndex SosNgramIndex;
+
+/**
+ * Visitor of search results, called on matching strings in ascending order of ids. Returning false stops the search.
+ */
+typedef bool (*SosNgramVisitor)(size_t id, SosView str, void* ctx);
+
+/**
+ * Create an empty index.
+ *
+ * @return The index, or NULL if allocation fails.
+ */
+SosNgramIndex* sos_ngram_index_create(void);
+
+/**
+ * Destroy an index.
+ */
+void sos_ngram_index_destroy(SosNgramIndex* index);
+
+/**
+ * Get number of strings.
+ */
+size_t sos_ngram_index_count(const SosNgramIndex* index);
+
+/**
+ * Get number of bytes allocated by the index, including the copies of strings.
+ */
+size_t sos_ngram_index_memory(const SosNgramIndex* index);
+
+/**
+ * Get the string with id `id`. The view is null-terminated.
+ *
+ * @pre `id` < sos_ngram_index_count(index)
+ */
+SosView sos_ngram_index_get(const SosNgramIndex* index, size_t id);
+
+/**
+ * Add a copy of a string, with the next id.
+ *
+ * @post On failure, the index is unchanged. SOS_ERROR_MAX_CAP is returned beyond UINT32_MAX strings.
+ */
+SosStatus sos_ngram_index_insert(SosNgramIndex* index, SosView str);
+
+/**
+ * Add copies of `n` strings, with consecutive ids in array order.
+ * With a pool, trigrams are extracted from chunks of strings in parallel, then posting lists are appended to
+ * in parallel, each thread owning a partition of trigrams.
+ *
+ * @param[in] pool The pool, or NULL to build on the calling thread.
+ * @post On failure, the index is unchanged.
+ */
+SosStatus sos_ngram_index_add(SosNgramIndex* index, SosPool* pool, const Sos* strs, size_t n);
+
+/**
+ * Visit the strings containing `needle`. An empty needle matches all strings.
+ * The index must not be modified during the search.
+ *
+ * @return SOS_OK, or SOS_ERROR_ALLOC if scratch memory cannot be allocated, in which case nothing is visited.
+ */
+SosStatus sos_ngram_index_search(const SosNgramIndex* index, SosView needle, SosNgramVisitor fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_NGRAM_H
@@ -0,0 +1,341 @@
+#if defined(SOS_HAVE_PTHREADS) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "sos_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef SOS_HAVE_PTHREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define SOS_CACHE_LINE 64
+
+// Chunks [begin, end) owned by a worker
+typedef struct {
+#ifdef SOS_HAVE_PTHREADS
+    pthread_mutex_t lock;
+#endif
+    size_t begin;
+    size_t end;
+    char   pad[SOS_CACHE_LINE]; // Keep locks of different workers apart
+} SosPoolWorker;
+
+struct SosPool {
+    unsigned       size;
+    size_t         chunk; // Used by bulk operations
+    SosPoolWorker* workers;
+
+    // Current job
+    SosPoolTask task;
+    void*       ctx;
+    size_t      n;
+    size_t      job_chunk;
+
+#ifdef SOS_HAVE_PTHREADS
+    pthread_t*      threads;
+    pthread_mutex_t lock;
+    pthread_cond_t  start_cv;
+    pthread_cond_t  done_cv;
+    unsigned long   generation;
+    unsigned        running;
+    bool            stop;
+#endif
+};
+
+#ifdef SOS_HAVE_PTHREADS
+
+/**
+ * Take the next chunk, from own share or by stealing.
+ *
+ * @return false if no work is left.
+ */
+static bool
+take_chunk(SosPool* pool, unsigned self, size_t* chunk_idx)
+{
+    SosPoolWorker* const own = &pool->workers[self];
+    pthread_mutex_lock(&own->lock);
+    if (own->begin < own->end) {
+        *chunk_idx = own->begin++;
+        pthread_mutex_unlock(&own->lock);
+        return true;
+    }
+    pthread_mutex_unlock(&own->lock);
+
+    for (unsigned k = 1; k < pool->size; ++k) {
+        SosPoolWorker* const victim = &pool->workers[(self + k) % pool->size];
+        pthread_mutex_lock(&victim->lock);
+        const size_t remaining = victim->end - victim->begin;
+        if (remaining == 0) {
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+        // Steal the back half, rounded up
+        const size_t mid = victim->end - (remaining + 1) / 2;
+        const size_t stolen_end = victim->end;
+        victim->end = mid;
+        pthread_mutex_unlock(&victim->lock);
+
+        pthread_mutex_lock(&own->lock);
+        own->begin = mid + 1;
+        own->end = stolen_end;
+        pthread_mutex_unlock(&own->lock);
+        *chunk_idx = mid;
+        return true;
+    }
+    return false;
+}
+
+static void
+work(SosPool* pool, unsigned self)
+{
+    size_t chunk_idx;
+    while (take_chunk(pool, self, &chunk_idx)) {
+        const size_t begin = chunk_idx * pool->job_chunk;
+        const size_t end = pool->n - begin < pool->job_chunk ? pool->n : begin + pool->job_chunk;
+        pool->task(pool->ctx, begin, end);
+    }
+}
+
+typedef struct {
+    SosPool* pool;
+    unsigned idx;
+} ThreadArg;
+
+static void*
+thread_main(void* arg)
+{
+    SosPool* const pool = ((ThreadArg*)arg)->pool;
+    const unsigned idx = ((ThreadArg*)arg)->idx;
+    free(arg);
+
+    unsigned long seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->stop) {
+            pthread_cond_wait(&pool->start_cv, &pool->lock);
+        }
+        if (pool->stop) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        work(pool, idx);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->running == 0) {
+            pthread_cond_signal(&pool->done_cv);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+#endif // SOS_HAVE_PTHREADS
+
+SosPool* sos_pool_create(unsigned threads)
+{
+#ifdef SOS_HAVE_PTHREADS
+    if (threads == 0) {
+        const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned)cpus : 1;
+    }
+#else
+    threads = 1;
+#endif
+
+    SosPool* const pool = calloc(1, sizeof(SosPool));
+    if (!pool) {
+        return NULL;
+    }
+    pool->size = threads;
+    pool->chunk = SOS_POOL_DEFAULT_CHUNK;
+    pool->workers = calloc(threads, sizeof(SosPoolWorker));
+    if (!pool->workers) {
+        free(pool);
+        return NULL;
+    }
+
+#ifdef SOS_HAVE_PTHREADS
+    pool->threads = calloc(threads, sizeof(pthread_t));
+    if (!pool->threads) {
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        pthread_mutex_init(&pool->workers[i].lock, NULL);
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+
+    // Thread 0 is the caller of sos_pool_run
+    for (unsigned i = 1; i < threads; ++i) {
+        ThreadArg* const arg = malloc(sizeof(ThreadArg));
+        if (arg) {
+            arg->pool = pool;
+            arg->idx = i;
+        }
+        if (!arg || pthread_create(&pool->threads[i], NULL, thread_main, arg) != 0) {
+            free(arg);
+            // Run with the threads created so far
+            pool->size = i;
+            break;
+        }
+    }
+#endif
+    return pool;
+}
+
+void sos_pool_destroy(SosPool* pool)
+{
+    if (!pool) {
+        return;
+    }
+#ifdef SOS_HAVE_PTHREADS
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start_cv);
+    pthread_mutex_unlock(&pool->lock);
+    for (unsigned i = 1; i < pool->size; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (unsigned i = 0; i < pool->size; ++i) {
+        pthread_mutex_destroy(&pool->workers[i].lock);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start_cv);
+    pthread_cond_destroy(&pool->done_cv);
+    free(pool->threads);
+#endif
+    free(pool->workers);
+    free(pool);
+}
+
+unsigned sos_pool_size(const SosPool* pool)
+{
+    return pool ? pool->size : 1;
+}
+
+void sos_pool_set_chunk(SosPool* pool, size_t chunk)
+{
+    pool->chunk = chunk ? chunk : SOS_POOL_DEFAULT_CHUNK;
+}
+
+void sos_pool_run(SosPool* pool, size_t n, size_t chunk, SosPoolTask task, void* ctx)
+{
+    if (chunk == 0) {
+        chunk = SOS_POOL_DEFAULT_CHUNK;
+    }
+    if (!pool || pool->size == 1 || n <= chunk) {
+        for (size_t begin = 0; begin < n; begin += chunk) {
+            task(ctx, begin, n - begin < chunk ? n : begin + chunk);
+        }
+        return;
+    }
+
+#ifdef SOS_HAVE_PTHREADS
+    pool->task = task;
+    pool->ctx = ctx;
+    pool->n = n;
+    pool->job_chunk = chunk;
+
+    // Even initial shares
+    const size_t chunks = (n + chunk - 1) / chunk;
+    for (unsigned i = 0; i < pool->size; ++i) {
+        pool->workers[i].begin = chunks * i / pool->size;
+        pool->workers[i].end = chunks * (i + 1) / pool->size;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->generation += 1;
+    pool->running = pool->size - 1;
+    pthread_cond_broadcast(&pool->start_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->running > 0) {
+        pthread_cond_wait(&pool->done_cv, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+#endif
+}
+
+static size_t
+bulk_chunk(const SosPool* pool)
+{
+    return pool ? pool->chunk : SOS_POOL_DEFAULT_CHUNK;
+}
+
+typedef struct {
+    Sos* arr;
+    void (*fn)(Sos*, void*);
+    void* ctx;
+} ForEachJob;
+
+static void
+for_each_task(void* ctx, size_t begin, size_t end)
+{
+    const ForEachJob* const job = ctx;
+    for (size_t i = begin; i < end; ++i) {
+        job->fn(&job->arr[i], job->ctx);
+    }
+}
+
+void sos_parallel_for_each(SosPool* pool, Sos* arr, size_t n, void (*fn)(Sos* str, void* ctx), void* ctx)
+{
+    ForEachJob job = {.arr = arr, .fn = fn, .ctx = ctx};
+    sos_pool_run(pool, n, bulk_chunk(pool), for_each_task, &job);
+}
+
+typedef struct {
+    const Sos* arr;
+    uint64_t*  out;
+} HashJob;
+
+static void
+hash_task(void* ctx, size_t begin, size_t end)
+{
+    const HashJob* const job = ctx;
+    for (size_t i = begin; i < end; ++i) {
+        job->out[i] = sos_hash(&job->arr[i]);
+    }
+}
+
+void sos_parallel_hash(SosPool* pool, const Sos* arr, size_t n, uint64_t* out)
+{
+    HashJob job = {.arr = arr, .out = out};
+    sos_pool_run(pool, n, bulk_chunk(pool), hash_task, &job);
+}
+
+typedef struct {
+    const Sos*     arr;
+    unsigned char* bitmap;
+} Utf8Job;
+
+static void
+utf8_task(void* ctx, size_t begin, size_t end)
+{
+    const Utf8Job* const job = ctx;
+    // Chunks are multiples of 8 elements, so each byte of the bitmap is written by one task.
+    for (size_t i = begin; i < end; i += 8) {
+        unsigned char bits = 0;
+        for (size_t k = 0; k < 8 && i + k < end; ++k) {
+            bits |= (unsigned char)(sos_is_utf8(&job->arr[i + k]) << k);
+        }
+        job->bitmap[i / 8] = bits;
+    }
+}
+
+void sos_parallel_utf8_validate(SosPool* pool, const Sos* arr, size_t n, unsigned char* bitmap)
+{
+    Utf8Job job = {.arr = arr, .bitmap = bitmap};
+    const size_t chunk = (bulk_chunk(pool) + 7) & ~(size_t)7;
+    sos_pool_run(pool, n, chunk, utf8_task, &job);
+}
@@ -0,0 +1,81 @@
+#ifndef SOS_POOL_H
+#define SOS_POOL_H
+
+// Thread pool and parallel bulk operations over arrays of strings
+//
+// Work is split into chunks of consecutive elements. Each worker starts with an even share of chunks,
+// and steals half of the remaining chunks from another worker once its own share is done.
+// Without pthreads, a pool runs everything on the calling thread.
+
+#include <stdint.h>
+#include "sos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SOS_POOL_DEFAULT_CHUNK 1024
+
+typedef struct SosPool SosPool;
+
+/**
+ * Task run by the pool, on elements [begin, end).
+ */
+typedef void (*SosPoolTask)(void* ctx, size_t begin, size_t end);
+
+/**
+ * Create a thread pool.
+ *
+ * @param[in] threads Number of threads running tasks, including the calling thread. Zero means the number of online CPUs.
+ * @return The pool, or NULL if allocation fails.
+ */
+SosPool* sos_pool_create(unsigned threads);
+
+/**
+ * Destroy a thread pool, joining its threads.
+ */
+void sos_pool_destroy(SosPool* pool);
+
+/**
+ * Get number of threads running tasks, including the calling thread.
+ */
+unsigned sos_pool_size(const SosPool* pool);
+
+/**
+ * Set number of elements per chunk used by bulk operations. Zero restores the default.
+ */
+void sos_pool_set_chunk(SosPool* pool, size_t chunk);
+
+/**
+ * Run `task` over [0, n) in chunks of `chunk` elements, and wait for completion.
+ * The calling thread takes part in the work.
+ *
+ * @param[in] pool The pool, or NULL to run on the calling thread only.
+ * @note A pool runs one job at a time. It must not be used by several threads concurrently.
+ */
+void sos_pool_run(SosPool* pool, size_t n, size_t chunk, SosPoolTask task, void* ctx);
+
+// Bulk operations. `pool` may be NULL in all of them.
+
+/**
+ * Apply `fn` to each string.
+ */
+void sos_parallel_for_each(SosPool* pool, Sos* arr, size_t n, void (*fn)(Sos* str, void* ctx), void* ctx);
+
+/**
+ * Hash each string with sos_hash() into `out`.
+ */
+void sos_parallel_hash(SosPool* pool, const Sos* arr, size_t n, uint64_t* out);
+
+/**
+ * Validate each string as UTF-8 with sos_is_utf8().
+ *
+ * @param[out] bitmap Bit (i % 8) of byte (i / 8) is set if the i-th string is valid. Must hold (n + 7) / 8 bytes.
+ */
+void sos_parallel_utf8_validate(SosPool* pool, const Sos* arr, size_t n, unsigned char* bitmap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_POOL_H
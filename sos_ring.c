@@ -0,0 +1,177 @@
+#include "sos_ring.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include "sos_io.h"
+#endif
+
+#define SOS_CACHE_LINE 64
+
+// Strings moved out per vectored write of sos_ring_write_fd()
+#define SOS_RING_WRITE_BATCH 256
+
+// Atomic operations on slot sequences and the enqueue position
+#if defined(_MSC_VER)
+#include <intrin.h>
+// Volatile accesses have acquire/release semantics on x86 and x64
+#define ring_load_relaxed(p) (*(const volatile size_t*)(p))
+#define ring_load_acquire(p) (*(const volatile size_t*)(p))
+#define ring_store_release(p, v) (*(volatile size_t*)(p) = (v))
+
+static bool
+ring_cas(size_t* p, size_t* expected, size_t desired)
+{
+#ifdef _WIN64
+    const size_t prev = (size_t)_InterlockedCompareExchange64((volatile __int64*)p, (__int64)desired, (__int64)*expected);
+#else
+    const size_t prev = (size_t)_InterlockedCompareExchange((volatile long*)p, (long)desired, (long)*expected);
+#endif
+    if (prev == *expected) {
+        return true;
+    }
+    *expected = prev;
+    return false;
+}
+#else
+#define ring_load_relaxed(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define ring_load_acquire(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ring_store_release(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ring_cas(p, expected, desired) \
+    __atomic_compare_exchange_n((p), (expected), (desired), true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#endif
+
+// A slot is free for the push at position `pos` when seq == pos,
+// and holds the string of that push once seq == pos + 1.
+typedef struct {
+    size_t seq;
+    Sos    str;
+} SosRingSlot;
+
+struct SosRing {
+    SosRingSlot* slots;
+    size_t       mask;
+    char         pad0[SOS_CACHE_LINE - sizeof(SosRingSlot*) - sizeof(size_t)];
+    size_t       tail; // Next push position, shared by producers
+    char         pad1[SOS_CACHE_LINE - sizeof(size_t)];
+    size_t       head; // Next pop position, owned by the consumer
+    char         pad2[SOS_CACHE_LINE - sizeof(size_t)];
+};
+
+SosRing* sos_ring_create(size_t cap)
+{
+    size_t n = 2;
+    while (n < cap) {
+        if (n > SIZE_MAX / 2 / sizeof(SosRingSlot)) {
+            return NULL;
+        }
+        n *= 2;
+    }
+
+    SosRing* const ring = malloc(sizeof(SosRing));
+    if (!ring) {
+        return NULL;
+    }
+    ring->slots = malloc(n * sizeof(SosRingSlot));
+    if (!ring->slots) {
+        free(ring);
+        return NULL;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        ring->slots[i].seq = i;
+    }
+    ring->mask = n - 1;
+    ring->tail = 0;
+    ring->head = 0;
+    return ring;
+}
+
+void sos_ring_destroy(SosRing* ring)
+{
+    if (!ring) {
+        return;
+    }
+    Sos str;
+    while (sos_ring_pop_batch(ring, &str, 1) == 1) {
+        sos_finish(&str);
+    }
+    free(ring->slots);
+    free(ring);
+}
+
+size_t sos_ring_cap(const SosRing* ring)
+{
+    return ring->mask + 1;
+}
+
+SosStatus sos_ring_push(SosRing* ring, Sos* str)
+{
+    size_t pos = ring_load_relaxed(&ring->tail);
+    SosRingSlot* slot;
+    for (;;) {
+        slot = &ring->slots[pos & ring->mask];
+        const size_t seq = ring_load_acquire(&slot->seq);
+        const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            // The slot is free, claim the position. On failure, pos is reloaded.
+            if (ring_cas(&ring->tail, &pos, pos + 1)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The slot still holds the string from one lap ago
+            return SOS_ERROR_MAX_CAP;
+        } else {
+            // Another producer took the position
+            pos = ring_load_relaxed(&ring->tail);
+        }
+    }
+    sos_init_by_move(&slot->str, str);
+    ring_store_release(&slot->seq, pos + 1);
+    return SOS_OK;
+}
+
+size_t sos_ring_pop_batch(SosRing* ring, Sos* out, size_t max)
+{
+    size_t pos = ring->head;
+    size_t count = 0;
+    for (; count < max; ++count, ++pos) {
+        SosRingSlot* const slot = &ring->slots[pos & ring->mask];
+        if (ring_load_acquire(&slot->seq) != pos + 1) {
+            // Empty, or the next push has claimed the slot but not published yet
+            break;
+        }
+        sos_init_by_move(&out[count], &slot->str);
+        // Free the slot for the push one lap later
+        ring_store_release(&slot->seq, pos + ring->mask + 1);
+    }
+    ring->head = pos;
+    return count;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+SosStatus sos_ring_write_fd(SosRing* ring, int fd, size_t max, size_t* count)
+{
+    Sos batch[SOS_RING_WRITE_BATCH];
+    SosStatus status = SOS_OK;
+    size_t total = 0;
+    while (total < max) {
+        const size_t want = max - total < SOS_RING_WRITE_BATCH ? max - total : SOS_RING_WRITE_BATCH;
+        const size_t n = sos_ring_pop_batch(ring, batch, want);
+        if (n == 0) {
+            break;
+        }
+        status = sos_writev_fd(fd, batch, n);
+        for (size_t i = 0; i < n; ++i) {
+            sos_finish(&batch[i]);
+        }
+        total += n;
+        if (status != SOS_OK || n < want) {
+            break;
+        }
+    }
+    if (count) {
+        *count = total;
+    }
+    return status;
+}
+#endif
@@ -0,0 +1,71 @@
+#ifndef SOS_RING_H
+#define SOS_RING_H
+
+// Bounded multi-producer, single-consumer queue of strings
+//
+// Producers hand over strings without locks, moving them in with no copy of their content.
+// The consumer takes them out in batches, e.g. to write many log lines with one vectored write.
+// Based on Dmitry Vyukov's bounded MPMC queue: each slot carries a sequence number,
+// so producers only contend on one counter, and a slot is published with a release store.
+
+#include "sos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SosRing SosRing;
+
+/**
+ * Create a ring.
+ *
+ * @param[in] cap Number of slots, rounded up to a power of two, and at-least 2.
+ * @return The ring, or NULL if allocation fails.
+ */
+SosRing* sos_ring_create(size_t cap);
+
+/**
+ * Destroy a ring, finishing the strings still queued.
+ *
+ * @pre No other thread is using the ring.
+ */
+void sos_ring_destroy(SosRing* ring);
+
+/**
+ * Get number of slots.
+ */
+size_t sos_ring_cap(const SosRing* ring);
+
+/**
+ * Move a string into the ring. Lock-free, may be called from any number of threads.
+ *
+ * @post On success, `str` is moved-from, and must be re-initialized before use.
+ *       SOS_ERROR_MAX_CAP is returned if the ring is full, and `str` is left untouched.
+ */
+SosStatus sos_ring_push(SosRing* ring, Sos* str);
+
+/**
+ * Move up to `max` strings out of the ring, in the order they were pushed.
+ * Only one thread may consume at a time.
+ *
+ * @param[out] out Receives the strings. Elements are not initialized beforehand, and are owned by the caller afterwards.
+ * @return Number of strings moved out, zero if the ring is empty.
+ */
+size_t sos_ring_pop_batch(SosRing* ring, Sos* out, size_t max);
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * Drain up to `max` strings to a file descriptor with vectored writes, and finish them.
+ * Only one thread may consume at a time. Only available on POSIX platforms.
+ *
+ * @param[out] count Receives the number of strings drained, which are finished even if writing fails. May be NULL.
+ * @see sos_writev_fd
+ */
+SosStatus sos_ring_write_fd(SosRing* ring, int fd, size_t max, size_t* count);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_RING_H
@@ -0,0 +1,409 @@
+#include "sos_rope.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+struct SosRopeNode {
+    SosRopeNode* left;
+    SosRopeNode* right;
+    size_t       total; // Length of the subtree
+    uint32_t     prio;  // Max-heap ordered
+    Sos          chunk;
+};
+
+static size_t
+total(const SosRopeNode* node)
+{
+    return node ? node->total : 0;
+}
+
+static void
+update(SosRopeNode* node)
+{
+    node->total = total(node->left) + sos_len(&node->chunk) + total(node->right);
+}
+
+static uint32_t
+next_prio(SosRope* self)
+{
+    // xorshift32
+    uint32_t x = self->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    self->seed = x;
+    return x;
+}
+
+static SosRopeNode*
+node_new(const char* begin, size_t count, uint32_t prio)
+{
+    SosRopeNode* const node = malloc(sizeof(SosRopeNode));
+    if (!node) {
+        return NULL;
+    }
+    if (sos_init_from_range(&node->chunk, begin, count) != SOS_OK) {
+        free(node);
+        return NULL;
+    }
+    node->left = NULL;
+    node->right = NULL;
+    node->total = count;
+    node->prio = prio;
+    return node;
+}
+
+static void
+node_free(SosRopeNode* node)
+{
+    while (node) {
+        node_free(node->left);
+        SosRopeNode* const right = node->right;
+        sos_finish(&node->chunk);
+        free(node);
+        node = right;
+    }
+}
+
+static SosRopeNode*
+merge(SosRopeNode* lhs, SosRopeNode* rhs)
+{
+    if (!lhs) {
+        return rhs;
+    }
+    if (!rhs) {
+        return lhs;
+    }
+    if (lhs->prio >= rhs->prio) {
+        lhs->right = merge(lhs->right, rhs);
+        update(lhs);
+        return lhs;
+    }
+    rhs->left = merge(lhs, rhs->left);
+    update(rhs);
+    return rhs;
+}
+
+/**
+ * Split a subtree into the first `pos` chars and the rest.
+ * A chunk straddling `pos` is divided, which is the only case that allocates.
+ *
+ * @post On failure, the subtree is not modified.
+ */
+static SosStatus
+split(SosRopeNode* node, size_t pos, SosRopeNode** lhs, SosRopeNode** rhs)
+{
+    if (!node) {
+        *lhs = NULL;
+        *rhs = NULL;
+        return SOS_OK;
+    }
+
+    const size_t left_len = total(node->left);
+    const size_t chunk_len = sos_len(&node->chunk);
+    SosRopeNode* sub;
+    SosStatus ret;
+
+    if (pos <= left_len) {
+        ret = split(node->left, pos, lhs, &sub);
+        if (ret != SOS_OK) {
+            return ret;
+        }
+        node->left = sub;
+        update(node);
+        *rhs = node;
+    } else if (pos >= left_len + chunk_len) {
+        ret = split(node->right, pos - left_len - chunk_len, &sub, rhs);
+        if (ret != SOS_OK) {
+            return ret;
+        }
+        node->right = sub;
+        update(node);
+        *lhs = node;
+    } else {
+        // The second half takes the same priority, so both halves remain valid treaps.
+        const size_t offset = pos - left_len;
+        SosRopeNode* const tail = node_new(sos_cstr(&node->chunk) + offset, chunk_len - offset, node->prio);
+        if (!tail) {
+            return SOS_ERROR_ALLOC;
+        }
+        sos_resize(&node->chunk, offset, 0);
+        tail->right = node->right;
+        node->right = NULL;
+        update(tail);
+        update(node);
+        *lhs = node;
+        *rhs = tail;
+    }
+    return SOS_OK;
+}
+
+/**
+ * Build a subtree from a char range, in chunks of at-most SOS_ROPE_CHUNK_MAX.
+ */
+static SosStatus
+build(SosRope* self, const char* begin, size_t count, SosRopeNode** out)
+{
+    SosRopeNode* root = NULL;
+    while (count > 0) {
+        const size_t n = count < SOS_ROPE_CHUNK_MAX ? count : SOS_ROPE_CHUNK_MAX;
+        SosRopeNode* const node = node_new(begin, n, next_prio(self));
+        if (!node) {
+            node_free(root);
+            return SOS_ERROR_ALLOC;
+        }
+        root = merge(root, node);
+        begin += n;
+        count -= n;
+    }
+    *out = root;
+    return SOS_OK;
+}
+
+/**
+ * Find the node whose chunk contains `*pos`, updating `*pos` to the offset within the chunk.
+ * With `inclusive`, a position at the end of a chunk also matches it.
+ */
+static SosRopeNode*
+find(SosRopeNode* node, size_t* pos, bool inclusive)
+{
+    while (node) {
+        const size_t left_len = total(node->left);
+        const size_t chunk_len = sos_len(&node->chunk);
+        if (*pos < left_len) {
+            node = node->left;
+        } else if (*pos < left_len + chunk_len || (inclusive && *pos == left_len + chunk_len)) {
+            *pos -= left_len;
+            return node;
+        } else {
+            *pos -= left_len + chunk_len;
+            node = node->right;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Add `delta` to totals along the path from root to the chunk found by find() with the same arguments.
+ */
+static void
+adjust_path(SosRopeNode* node, size_t pos, bool inclusive, size_t delta, bool negative)
+{
+    while (node) {
+        const size_t left_len = total(node->left);
+        const size_t chunk_len = sos_len(&node->chunk);
+        if (negative) {
+            node->total -= delta;
+        } else {
+            node->total += delta;
+        }
+        if (pos < left_len) {
+            node = node->left;
+        } else if (pos < left_len + chunk_len || (inclusive && pos == left_len + chunk_len)) {
+            return;
+        } else {
+            pos -= left_len + chunk_len;
+            node = node->right;
+        }
+    }
+}
+
+void sos_rope_init(SosRope* self)
+{
+    self->root = NULL;
+    self->seed = 2463534242u;
+}
+
+SosStatus sos_rope_init_from_range(SosRope* self, const char* begin, size_t count)
+{
+    sos_rope_init(self);
+    return build(self, begin, count, &self->root);
+}
+
+void sos_rope_finish(SosRope* self)
+{
+    node_free(self->root);
+    self->root = NULL;
+}
+
+size_t sos_rope_len(const SosRope* self)
+{
+    return total(self->root);
+}
+
+char sos_rope_at(const SosRope* self, size_t pos)
+{
+    assert(pos < sos_rope_len(self));
+    const SosRopeNode* const node = find(self->root, &pos, false);
+    return sos_cstr(&node->chunk)[pos];
+}
+
+SosStatus sos_rope_insert(SosRope* self, size_t pos, const char* begin, size_t count)
+{
+    assert(pos <= sos_rope_len(self));
+    if (count == 0) {
+        return SOS_OK;
+    }
+
+    // Small insertions go into an existing chunk if it has room.
+    size_t offset = pos;
+    SosRopeNode* const node = find(self->root, &offset, true);
+    if (node && sos_len(&node->chunk) + count <= SOS_ROPE_CHUNK_MAX) {
+        const size_t chunk_len = sos_len(&node->chunk);
+        const SosStatusAndBuf ret = sos_expand_for_overwrite(&node->chunk, count);
+        if (ret.status != SOS_OK) {
+            return ret.status;
+        }
+        char* const data = sos_cstr_mut(&node->chunk);
+        memmove(data + offset + count, data + offset, chunk_len - offset);
+        memcpy(data + offset, begin, count);
+        adjust_path(self->root, pos, true, count, false);
+        return SOS_OK;
+    }
+
+    SosRopeNode* mid;
+    SosStatus ret = build(self, begin, count, &mid);
+    if (ret != SOS_OK) {
+        return ret;
+    }
+    SosRopeNode *lhs, *rhs;
+    ret = split(self->root, pos, &lhs, &rhs);
+    if (ret != SOS_OK) {
+        node_free(mid);
+        return ret;
+    }
+    self->root = merge(merge(lhs, mid), rhs);
+    return SOS_OK;
+}
+
+SosStatus sos_rope_append(SosRope* self, const char* begin, size_t count)
+{
+    return sos_rope_insert(self, sos_rope_len(self), begin, count);
+}
+
+SosStatus sos_rope_erase(SosRope* self, size_t pos, size_t count)
+{
+    const size_t len = sos_rope_len(self);
+    assert(pos <= len);
+    if (count > len - pos) {
+        count = len - pos;
+    }
+    if (count == 0) {
+        return SOS_OK;
+    }
+
+    // Erasing inside a single chunk is done in place.
+    size_t offset = pos;
+    SosRopeNode* const node = find(self->root, &offset, false);
+    const size_t chunk_len = sos_len(&node->chunk);
+    if (offset + count <= chunk_len && count < chunk_len) {
+        char* const data = sos_cstr_mut(&node->chunk);
+        memmove(data + offset, data + offset + count, chunk_len - offset - count);
+        adjust_path(self->root, pos, false, count, true);
+        sos_resize(&node->chunk, chunk_len - count, 0);
+        return SOS_OK;
+    }
+
+    SosRopeNode *lhs, *mid, *rhs;
+    SosStatus ret = split(self->root, pos, &lhs, &rhs);
+    if (ret != SOS_OK) {
+        return ret;
+    }
+    ret = split(rhs, count, &mid, &rhs);
+    if (ret != SOS_OK) {
+        self->root = merge(lhs, rhs);
+        return ret;
+    }
+    node_free(mid);
+    self->root = merge(lhs, rhs);
+    return SOS_OK;
+}
+
+void sos_rope_concat(SosRope* self, SosRope* rhs)
+{
+    self->root = merge(self->root, rhs->root);
+    rhs->root = NULL;
+}
+
+SosStatus sos_rope_split(SosRope* self, size_t pos, SosRope* rest)
+{
+    assert(pos <= sos_rope_len(self));
+    SosRopeNode *lhs, *rhs;
+    const SosStatus ret = split(self->root, pos, &lhs, &rhs);
+    if (ret != SOS_OK) {
+        return ret;
+    }
+    self->root = lhs;
+    sos_rope_init(rest);
+    rest->seed = next_prio(self);
+    rest->root = rhs;
+    return SOS_OK;
+}
+
+SosStatus sos_rope_substr(const SosRope* self, size_t pos, size_t count, SosRope* out)
+{
+    const size_t len = sos_rope_len(self);
+    assert(pos <= len);
+    if (count > len - pos) {
+        count = len - pos;
+    }
+
+    sos_rope_init(out);
+    SosRopeIter iter;
+    SosView chunk;
+    sos_rope_iter_init(&iter, self, pos);
+    while (count > 0 && sos_rope_iter_next(&iter, &chunk)) {
+        const size_t n = chunk.len < count ? chunk.len : count;
+        SosRopeNode* const node = node_new(chunk.data, n, next_prio(out));
+        if (!node) {
+            sos_rope_finish(out);
+            return SOS_ERROR_ALLOC;
+        }
+        out->root = merge(out->root, node);
+        count -= n;
+    }
+    return SOS_OK;
+}
+
+static char*
+flatten(const SosRopeNode* node, char* dest)
+{
+    while (node) {
+        dest = flatten(node->left, dest);
+        const SosView chunk = sos_view(&node->chunk);
+        memcpy(dest, chunk.data, chunk.len);
+        dest += chunk.len;
+        node = node->right;
+    }
+    return dest;
+}
+
+SosStatus sos_rope_flatten(const SosRope* self, Sos* out)
+{
+    const SosStatusAndBuf ret = sos_init_for_overwrite(out, sos_rope_len(self));
+    if (ret.status != SOS_OK) {
+        return ret.status;
+    }
+    flatten(self->root, ret.str);
+    return SOS_OK;
+}
+
+void sos_rope_iter_init(SosRopeIter* iter, const SosRope* rope, size_t pos)
+{
+    iter->rope = rope;
+    iter->pos = pos;
+}
+
+bool sos_rope_iter_next(SosRopeIter* iter, SosView* chunk)
+{
+    size_t offset = iter->pos;
+    const SosRopeNode* const node = find(iter->rope->root, &offset, false);
+    if (!node) {
+        return false;
+    }
+    const SosView view = sos_view(&node->chunk);
+    chunk->data = view.data + offset;
+    chunk->len = view.len - offset;
+    iter->pos += chunk->len;
+    return true;
+}
@@ -0,0 +1,132 @@
+#ifndef SOS_ROPE_H
+#define SOS_ROPE_H
+
+// SosRope: chunked string for huge strings with frequent edits
+//
+// A rope is a balanced tree (treap keyed by position) of chunks, each chunk being an Sos of at-most SOS_ROPE_CHUNK_MAX chars.
+// Insertion, erasure, concatenation and splitting take O(log n) time plus the size of the inserted data,
+// instead of moving the whole tail of a flat string.
+
+#include <stdint.h>
+#include "sos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SOS_ROPE_CHUNK_MAX 1024
+
+typedef struct SosRopeNode SosRopeNode;
+
+typedef struct {
+    SosRopeNode* root;
+    uint32_t     seed; // State of the generator for node priorities
+} SosRope;
+
+// Iterator over the chunks of a rope
+typedef struct {
+    const SosRope* rope;
+    size_t         pos;
+} SosRopeIter;
+
+/**
+ * Initialize an empty rope.
+ *
+ * @pre `self` is not initialized.
+ */
+void sos_rope_init(SosRope* self);
+
+/**
+ * Initialize by copying the given char range.
+ *
+ * @pre `self` is not initialized.
+ * @post On success, `self` is initialized by copying the range.
+ */
+SosStatus sos_rope_init_from_range(SosRope* self, const char* begin, size_t count);
+
+/**
+ * Destroy a rope, releasing all chunks.
+ *
+ * @post `self` is uninitialized.
+ */
+void sos_rope_finish(SosRope* self);
+
+/**
+ * Get total length of the rope.
+ */
+size_t sos_rope_len(const SosRope* self);
+
+/**
+ * Get the char at `pos`.
+ *
+ * @pre `pos` < sos_rope_len(self)
+ */
+char sos_rope_at(const SosRope* self, size_t pos);
+
+/**
+ * Insert a range of chars before position `pos`.
+ *
+ * @pre `pos` <= sos_rope_len(self)
+ * @post On failure, `self` is not modified.
+ */
+SosStatus sos_rope_insert(SosRope* self, size_t pos, const char* begin, size_t count);
+
+/**
+ * Append a range of chars.
+ */
+SosStatus sos_rope_append(SosRope* self, const char* begin, size_t count);
+
+/**
+ * Erase `count` chars starting at `pos`. The range is clamped to the end of the rope.
+ *
+ * @pre `pos` <= sos_rope_len(self)
+ * @post On failure, `self` is not modified.
+ */
+SosStatus sos_rope_erase(SosRope* self, size_t pos, size_t count);
+
+/**
+ * Append `rhs` to `self`, moving its chunks. No chars are copied.
+ *
+ * @post `rhs` is uninitialized.
+ */
+void sos_rope_concat(SosRope* self, SosRope* rhs);
+
+/**
+ * Split the rope at `pos`. `self` keeps the first `pos` chars, and the rest is moved into `rest`.
+ *
+ * @pre `rest` is not initialized. `pos` <= sos_rope_len(self)
+ * @post On success, `rest` is initialized. On failure, `self` is not modified.
+ */
+SosStatus sos_rope_split(SosRope* self, size_t pos, SosRope* rest);
+
+/**
+ * Initialize `out` by copying `count` chars starting at `pos`. The range is clamped to the end of the rope.
+ *
+ * @pre `out` is not initialized. `pos` <= sos_rope_len(self)
+ */
+SosStatus sos_rope_substr(const SosRope* self, size_t pos, size_t count, SosRope* out);
+
+/**
+ * Initialize `out` with the content of the rope, with a single allocation.
+ *
+ * @pre `out` is not initialized.
+ */
+SosStatus sos_rope_flatten(const SosRope* self, Sos* out);
+
+/**
+ * Initialize an iterator, starting at `pos`.
+ */
+void sos_rope_iter_init(SosRopeIter* iter, const SosRope* rope, size_t pos);
+
+/**
+ * Get the next chunk. Views are invalidated by modifying the rope.
+ *
+ * @return false if the end of rope is reached.
+ */
+bool sos_rope_iter_next(SosRopeIter* iter, SosView* chunk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_ROPE_H
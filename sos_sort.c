@@ -0,0 +1,431 @@
+#include "sos_sort.h"
+#include "sos_pool.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Strings are sorted by an MSD pass over the first byte, then a multikey quicksort on each bucket,
+// where a "character" is an 8-byte big-endian word of the string. Words are cached in the sort entries,
+// so most comparisons do not touch the string data at all.
+
+#define SOS_SORT_INSERTION_MAX 16
+
+typedef struct {
+    uint64_t    key; // Bytes [depth, depth + 8) of the string, big-endian, zero-padded
+    const char* data;
+    size_t      len;
+    size_t      idx; // Position in the input array
+} SortEntry;
+
+static uint64_t
+to_big_endian(uint64_t x)
+{
+#ifdef SOS_BE
+    return x;
+#elif defined(__GNUC__)
+    return __builtin_bswap64(x);
+#else
+    x = ((x & 0x00ff00ff00ff00ffull) << 8) | ((x >> 8) & 0x00ff00ff00ff00ffull);
+    x = ((x & 0x0000ffff0000ffffull) << 16) | ((x >> 16) & 0x0000ffff0000ffffull);
+    return (x << 32) | (x >> 32);
+#endif
+}
+
+/**
+ * Load the key word at `depth`.
+ *
+ * @param[in] readable Number of bytes readable at `data`, which may exceed `len` (e.g. the inline buffer of a short string).
+ */
+static uint64_t
+load_key(const char* data, size_t len, size_t readable, size_t depth)
+{
+    uint64_t word = 0;
+    if (depth >= len) {
+        return 0;
+    }
+    const size_t avail = len - depth;
+    if (depth + 8 <= readable) {
+        memcpy(&word, data + depth, 8);
+        word = to_big_endian(word);
+        if (avail < 8) {
+            word &= ~(uint64_t)0 << (8 * (8 - avail));
+        }
+        return word;
+    }
+    memcpy(&word, data + depth, avail < 8 ? avail : 8);
+    return to_big_endian(word);
+}
+
+static void
+reload_keys(SortEntry* e, size_t n, size_t depth)
+{
+    for (size_t i = 0; i < n; ++i) {
+        e[i].key = load_key(e[i].data, e[i].len, e[i].len, depth);
+    }
+}
+
+static int
+entry_cmp(const SortEntry* lhs, const SortEntry* rhs, size_t depth)
+{
+    if (lhs->key != rhs->key) {
+        return lhs->key < rhs->key ? -1 : 1;
+    }
+    // Equal words, compare the rest
+    const size_t start = depth + 8;
+    const size_t lrest = lhs->len > start ? lhs->len - start : 0;
+    const size_t rrest = rhs->len > start ? rhs->len - start : 0;
+    const size_t common = lrest < rrest ? lrest : rrest;
+    if (common > 0) {
+        const int ret = memcmp(lhs->data + start, rhs->data + start, common);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    return (lrest > rrest) - (lrest < rrest);
+}
+
+static void
+swap_entries(SortEntry* a, SortEntry* b)
+{
+    const SortEntry t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static void
+insertion_sort(SortEntry* e, size_t n, size_t depth)
+{
+    for (size_t i = 1; i < n; ++i) {
+        const SortEntry t = e[i];
+        size_t j = i;
+        for (; j > 0 && entry_cmp(&t, &e[j - 1], depth) < 0; --j) {
+            e[j] = e[j - 1];
+        }
+        e[j] = t;
+    }
+}
+
+static uint64_t
+median3(uint64_t a, uint64_t b, uint64_t c)
+{
+    if (a < b) {
+        return b < c ? b : (a < c ? c : a);
+    }
+    return a < c ? a : (b < c ? c : b);
+}
+
+/**
+ * Multikey quicksort of entries that are equal before `depth`, with keys loaded at `depth`.
+ */
+static void
+mkqs(SortEntry* e, size_t n, size_t depth)
+{
+    while (n > SOS_SORT_INSERTION_MAX) {
+        const uint64_t pivot = median3(e[0].key, e[n / 2].key, e[n - 1].key);
+
+        // Dijkstra 3-way partition: [0, lt) < pivot, [lt, i) == pivot, (gt, n) > pivot
+        size_t lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            if (e[i].key < pivot) {
+                swap_entries(&e[lt++], &e[i++]);
+            } else if (e[i].key > pivot) {
+                swap_entries(&e[i], &e[--gt]);
+            } else {
+                ++i;
+            }
+        }
+
+        // Equal words: strings ending within this word go first, the rest continue at the next word.
+        // Strings ending here only differ in trailing null bytes, and are treated as equal.
+        SortEntry* const eq = e + lt;
+        const size_t eq_n = gt - lt;
+        size_t done = 0;
+        for (size_t k = 0; k < eq_n; ++k) {
+            if (eq[k].len <= depth + 8) {
+                swap_entries(&eq[k], &eq[done++]);
+            }
+        }
+        if (eq_n - done > 1) {
+            reload_keys(eq + done, eq_n - done, depth + 8);
+            mkqs(eq + done, eq_n - done, depth + 8);
+        }
+
+        // Recurse into the smaller side, loop on the larger one
+        if (lt < n - gt) {
+            mkqs(e, lt, depth);
+            e += gt;
+            n -= gt;
+        } else {
+            mkqs(e + gt, n - gt, depth);
+            n = lt;
+        }
+    }
+    insertion_sort(e, n, depth);
+}
+
+/**
+ * Sort entries with keys loaded at depth 0.
+ *
+ * @param[in] tmp Scratch space of `n` entries
+ */
+static void
+sort_entries(SortEntry* e, SortEntry* tmp, size_t n)
+{
+    // MSD pass on the first byte
+    size_t counts[257] = {0};
+    for (size_t i = 0; i < n; ++i) {
+        counts[(e[i].key >> 56) + 1] += 1;
+    }
+    for (int b = 0; b < 256; ++b) {
+        counts[b + 1] += counts[b];
+    }
+    size_t pos[256];
+    memcpy(pos, counts, sizeof(pos));
+    for (size_t i = 0; i < n; ++i) {
+        tmp[pos[e[i].key >> 56]++] = e[i];
+    }
+    memcpy(e, tmp, n * sizeof(SortEntry));
+
+    for (int b = 0; b < 256; ++b) {
+        mkqs(e + counts[b], counts[b + 1] - counts[b], 0);
+    }
+}
+
+static void
+init_entry(SortEntry* e, const Sos* str, size_t idx)
+{
+    const SosView v = sos_view(str);
+    // The inline buffer of a short string is readable past its length
+    const char* const end = (const char*)(str + 1);
+    const bool is_inline = v.data >= (const char*)str && v.data < end;
+    e->key = load_key(v.data, v.len, is_inline ? (size_t)(end - v.data) : v.len, 0);
+    e->data = v.data;
+    e->len = v.len;
+    e->idx = idx;
+}
+
+SosStatus sos_sort(Sos* arr, size_t n)
+{
+    if (n < 2) {
+        return SOS_OK;
+    }
+    SortEntry* const e = malloc(2 * n * sizeof(SortEntry));
+    if (!e) {
+        return SOS_ERROR_ALLOC;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        init_entry(&e[i], &arr[i], i);
+    }
+    sort_entries(e, e + n, n);
+
+    // Apply the permutation. The scratch entries are reused as storage for the strings.
+    Sos* const sorted = (Sos*)(void*)(e + n);
+    for (size_t i = 0; i < n; ++i) {
+        sos_init_by_move(&sorted[i], &arr[e[i].idx]);
+    }
+    memcpy(arr, sorted, n * sizeof(Sos));
+
+    free(e);
+    return SOS_OK;
+}
+
+SosStatus sos_view_sort(SosView* arr, size_t n)
+{
+    if (n < 2) {
+        return SOS_OK;
+    }
+    SortEntry* const e = malloc(2 * n * sizeof(SortEntry));
+    if (!e) {
+        return SOS_ERROR_ALLOC;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        e[i].key = load_key(arr[i].data, arr[i].len, arr[i].len, 0);
+        e[i].data = arr[i].data;
+        e[i].len = arr[i].len;
+        e[i].idx = i;
+    }
+    sort_entries(e, e + n, n);
+
+    for (size_t i = 0; i < n; ++i) {
+        arr[i].data = e[i].data;
+        arr[i].len = e[i].len;
+    }
+
+    free(e);
+    return SOS_OK;
+}
+
+// Parallel sort
+// Large buckets are split further by MSD passes, byte by byte, until they are small enough to be
+// independent tasks. Tasks are then sorted with mkqs by the pool.
+
+typedef struct {
+    size_t   begin;
+    size_t   n;
+    size_t   depth;
+    unsigned byte; // Next byte of the key word at `depth` to split on, for buckets still to split
+} SortTask;
+
+typedef struct {
+    SortTask* tasks;
+    size_t    count;
+    size_t    cap;
+} SortTaskList;
+
+static bool
+push_task(SortTaskList* list, size_t begin, size_t n, size_t depth, unsigned byte)
+{
+    if (list->count == list->cap) {
+        const size_t cap = list->cap ? list->cap * 2 : 256;
+        SortTask* const tasks = realloc(list->tasks, cap * sizeof(SortTask));
+        if (!tasks) {
+            return false;
+        }
+        list->tasks = tasks;
+        list->cap = cap;
+    }
+    list->tasks[list->count++] = (SortTask) {.begin = begin, .n = n, .depth = depth, .byte = byte};
+    return true;
+}
+
+/**
+ * Split entries [0, n) into tasks of at-most `limit` entries, by MSD passes over the bytes of the keys.
+ * Buckets still to split are kept on a stack rather than recursed into, as long common prefixes take a pass per byte.
+ * A bucket that a pass fails to split becomes a task as it is, since mkqs handles long common prefixes better.
+ */
+static bool
+split_tasks(SortEntry* e, SortEntry* tmp, size_t n, size_t limit, SortTaskList* list)
+{
+    SortTaskList pending = {0};
+    bool ok = push_task(&pending, 0, n, 0, 0);
+    while (ok && pending.count > 0) {
+        const SortTask t = pending.tasks[--pending.count];
+        if (t.n <= limit) {
+            ok = t.n < 2 || push_task(list, t.begin, t.n, t.depth, 0);
+            continue;
+        }
+        SortEntry* const part = e + t.begin;
+
+        if (t.byte == 8) {
+            // Equal words: strings ending here go first, the rest continue at the next word.
+            size_t done = 0;
+            for (size_t k = 0; k < t.n; ++k) {
+                if (part[k].len <= t.depth + 8) {
+                    swap_entries(&part[k], &part[done++]);
+                }
+            }
+            reload_keys(part + done, t.n - done, t.depth + 8);
+            ok = push_task(&pending, t.begin + done, t.n - done, t.depth + 8, 0);
+            continue;
+        }
+
+        const int shift = 56 - 8 * (int)t.byte;
+        size_t counts[257] = {0};
+        for (size_t i = 0; i < t.n; ++i) {
+            counts[((part[i].key >> shift) & 0xff) + 1] += 1;
+        }
+        bool split = true;
+        for (int b = 0; b < 256; ++b) {
+            split = split && counts[b + 1] != t.n;
+            counts[b + 1] += counts[b];
+        }
+        if (!split) {
+            ok = push_task(list, t.begin, t.n, t.depth, 0);
+            continue;
+        }
+        size_t pos[256];
+        memcpy(pos, counts, sizeof(pos));
+        for (size_t i = 0; i < t.n; ++i) {
+            tmp[pos[(part[i].key >> shift) & 0xff]++] = part[i];
+        }
+        memcpy(part, tmp, t.n * sizeof(SortEntry));
+
+        for (int b = 0; b < 256 && ok; ++b) {
+            const size_t m = counts[b + 1] - counts[b];
+            ok = m < 2 || push_task(&pending, t.begin + counts[b], m, t.depth, t.byte + 1);
+        }
+    }
+    free(pending.tasks);
+    return ok;
+}
+
+typedef struct {
+    Sos*            arr;
+    SortEntry*      e;
+    Sos*            sorted;
+    const SortTask* tasks;
+} ParallelSortJob;
+
+static void
+init_entries_task(void* ctx, size_t begin, size_t end)
+{
+    const ParallelSortJob* const job = ctx;
+    for (size_t i = begin; i < end; ++i) {
+        init_entry(&job->e[i], &job->arr[i], i);
+    }
+}
+
+static void
+mkqs_task(void* ctx, size_t begin, size_t end)
+{
+    const ParallelSortJob* const job = ctx;
+    for (size_t i = begin; i < end; ++i) {
+        const SortTask* const task = &job->tasks[i];
+        mkqs(job->e + task->begin, task->n, task->depth);
+    }
+}
+
+static void
+gather_task(void* ctx, size_t begin, size_t end)
+{
+    const ParallelSortJob* const job = ctx;
+    for (size_t i = begin; i < end; ++i) {
+        sos_init_by_move(&job->sorted[i], &job->arr[job->e[i].idx]);
+    }
+}
+
+static void
+scatter_task(void* ctx, size_t begin, size_t end)
+{
+    const ParallelSortJob* const job = ctx;
+    memcpy(job->arr + begin, job->sorted + begin, (end - begin) * sizeof(Sos));
+}
+
+SosStatus sos_sort_parallel(SosPool* pool, Sos* arr, size_t n)
+{
+    if (sos_pool_size(pool) == 1) {
+        return sos_sort(arr, n);
+    }
+    if (n < 2) {
+        return SOS_OK;
+    }
+    SortEntry* const e = malloc(2 * n * sizeof(SortEntry));
+    if (!e) {
+        return SOS_ERROR_ALLOC;
+    }
+    ParallelSortJob job = {.arr = arr, .e = e, .sorted = (Sos*)(void*)(e + n), .tasks = NULL};
+    sos_pool_run(pool, n, 0, init_entries_task, &job);
+
+    // Several tasks per thread, so that stealing can balance uneven ones
+    size_t limit = n / (sos_pool_size(pool) * 8);
+    if (limit < 4096) {
+        limit = 4096;
+    }
+    SortTaskList list = {0};
+    if (!split_tasks(e, e + n, n, limit, &list)) {
+        free(list.tasks);
+        free(e);
+        return SOS_ERROR_ALLOC;
+    }
+    job.tasks = list.tasks;
+    sos_pool_run(pool, list.count, 1, mkqs_task, &job);
+    free(list.tasks);
+
+    sos_pool_run(pool, n, 0, gather_task, &job);
+    sos_pool_run(pool, n, 0, scatter_task, &job);
+
+    free(e);
+    return SOS_OK;
+}
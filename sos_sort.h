@@ -0,0 +1,44 @@
+#ifndef SOS_SORT_H
+#define SOS_SORT_H
+
+// Sorting arrays of strings
+//
+// Strings are ordered by their bytes as unsigned chars, a proper prefix ordering first.
+// This is the same order as sos_cmp(), except that strings differing only in trailing null bytes may appear in any order.
+
+#include "sos.h"
+#include "sos_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Sort an array of strings in ascending order.
+ * The sort is not stable. Strings are moved, not copied.
+ *
+ * @return SOS_ERROR_ALLOC if the working memory cannot be allocated, in which case `arr` is not modified.
+ */
+SosStatus sos_sort(Sos* arr, size_t n);
+
+/**
+ * Sort an array of string views in ascending order.
+ *
+ * @see sos_sort
+ */
+SosStatus sos_view_sort(SosView* arr, size_t n);
+
+/**
+ * Sort an array of strings in ascending order, using a thread pool.
+ * Buckets of leading bytes are sorted by the threads of the pool independently.
+ *
+ * @param[in] pool The pool, or NULL to sort on the calling thread.
+ * @see sos_sort
+ */
+SosStatus sos_sort_parallel(SosPool* pool, Sos* arr, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_SORT_H
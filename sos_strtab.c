@@ -0,0 +1,318 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#if defined(_MSC_VER) && !defined(_CRT_SECURE_NO_WARNINGS)
+#define _CRT_SECURE_NO_WARNINGS // fopen
+#endif
+
+#include "sos_strtab.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SOS_STRTAB_MMAP 1
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+#endif
+
+#define SOS_STRTAB_ALIGN      64u
+#define SOS_STRTAB_BYTE_ORDER 0x01020304u
+
+enum {
+    OWNER_NONE,
+    OWNER_HEAP,
+    OWNER_MAP
+};
+
+static uint64_t
+align_up(uint64_t x)
+{
+    return (x + SOS_STRTAB_ALIGN - 1) & ~(uint64_t)(SOS_STRTAB_ALIGN - 1);
+}
+
+static int
+view_cmp(SosView lhs, SosView rhs)
+{
+    const size_t len = lhs.len < rhs.len ? lhs.len : rhs.len;
+    const int ret = memcmp(lhs.data, rhs.data, len);
+    if (ret != 0) {
+        return ret;
+    }
+    return (lhs.len > rhs.len) - (lhs.len < rhs.len);
+}
+
+typedef struct {
+    SosView  view;
+    uint64_t id;
+} IndexItem;
+
+static int
+index_item_cmp(const void* lhs, const void* rhs)
+{
+    return view_cmp(((const IndexItem*)lhs)->view, ((const IndexItem*)rhs)->view);
+}
+
+static bool
+write_padding(FILE* fp, uint64_t count)
+{
+    static const char zeros[SOS_STRTAB_ALIGN];
+    return fwrite(zeros, 1, (size_t)count, fp) == count;
+}
+
+SosStatus sos_strtab_write_file(const char* path, const Sos* strs, size_t n, bool sorted_index)
+{
+    SosStrtabHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SOS_STRTAB_MAGIC, sizeof(header.magic));
+    header.version = SOS_STRTAB_VERSION;
+    header.byte_order = SOS_STRTAB_BYTE_ORDER;
+    header.count = n;
+
+    SosStrtabEntry* const entries = malloc(n * sizeof(SosStrtabEntry) + 1);
+    if (!entries) {
+        return SOS_ERROR_ALLOC;
+    }
+    uint64_t payload_size = 0;
+    for (size_t i = 0; i < n; ++i) {
+        entries[i].offset = payload_size;
+        entries[i].len = sos_len(&strs[i]);
+        payload_size += entries[i].len + 1;
+    }
+
+    uint64_t* index = NULL;
+    if (sorted_index) {
+        IndexItem* const items = malloc(n * sizeof(IndexItem) + 1);
+        index = malloc(n * sizeof(uint64_t) + 1);
+        if (!items || !index) {
+            free(items);
+            free(index);
+            free(entries);
+            return SOS_ERROR_ALLOC;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            items[i].view = sos_view(&strs[i]);
+            items[i].id = i;
+        }
+        qsort(items, n, sizeof(IndexItem), index_item_cmp);
+        for (size_t i = 0; i < n; ++i) {
+            index[i] = items[i].id;
+        }
+        free(items);
+    }
+
+    header.entries_offset = align_up(sizeof(header));
+    uint64_t offset = align_up(header.entries_offset + n * sizeof(SosStrtabEntry));
+    if (sorted_index) {
+        header.index_offset = offset;
+        offset = align_up(offset + n * sizeof(uint64_t));
+    }
+    header.payload_offset = offset;
+    header.payload_size = payload_size;
+    header.file_size = offset + payload_size;
+
+    SosStatus ret = SOS_ERROR_IO;
+    FILE* const fp = fopen(path, "wb");
+    if (!fp) {
+        goto cleanup;
+    }
+    if (fwrite(&header, sizeof(header), 1, fp) != 1 || !write_padding(fp, header.entries_offset - sizeof(header))) {
+        goto close;
+    }
+    if (fwrite(entries, sizeof(SosStrtabEntry), n, fp) != n) {
+        goto close;
+    }
+    if (sorted_index) {
+        if (!write_padding(fp, header.index_offset - header.entries_offset - n * sizeof(SosStrtabEntry))) {
+            goto close;
+        }
+        if (fwrite(index, sizeof(uint64_t), n, fp) != n || !write_padding(fp, header.payload_offset - header.index_offset - n * sizeof(uint64_t))) {
+            goto close;
+        }
+    } else if (!write_padding(fp, header.payload_offset - header.entries_offset - n * sizeof(SosStrtabEntry))) {
+        goto close;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        // Strings are null-terminated already
+        if (fwrite(sos_cstr(&strs[i]), 1, entries[i].len + 1, fp) != entries[i].len + 1) {
+            goto close;
+        }
+    }
+    ret = SOS_OK;
+
+close:
+    if (fclose(fp) != 0) {
+        ret = SOS_ERROR_IO;
+    }
+cleanup:
+    free(index);
+    free(entries);
+    return ret;
+}
+
+SosStatus sos_strtab_open_buffer(SosStrtab* self, const void* data, size_t size)
+{
+    SosStrtabHeader header;
+    if (size < sizeof(header)) {
+        return SOS_ERROR_INVALID;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    // Only the header is validated, so that opening does not touch the whole file.
+    if (memcmp(header.magic, SOS_STRTAB_MAGIC, sizeof(header.magic)) != 0 || header.version != SOS_STRTAB_VERSION ||
+        header.byte_order != SOS_STRTAB_BYTE_ORDER || header.file_size != size) {
+        return SOS_ERROR_INVALID;
+    }
+    // Sections in order, each bounded by the next, checked with no sums that could wrap
+    const uint64_t entries_end = header.index_offset ? header.index_offset : header.payload_offset;
+    if (header.entries_offset < sizeof(header) || header.entries_offset > entries_end || entries_end > header.payload_offset ||
+        header.payload_offset > size || header.entries_offset % 8 != 0 || header.index_offset % 8 != 0 ||
+        header.count > (entries_end - header.entries_offset) / sizeof(SosStrtabEntry) ||
+        (header.index_offset && header.count > (header.payload_offset - header.index_offset) / sizeof(uint64_t)) ||
+        header.payload_size != size - header.payload_offset) {
+        return SOS_ERROR_INVALID;
+    }
+
+    const char* const base = data;
+    self->base = base;
+    self->size = size;
+    self->count = (size_t)header.count;
+    self->entries = (const SosStrtabEntry*)(const void*)(base + header.entries_offset);
+    self->index = header.index_offset ? (const uint64_t*)(const void*)(base + header.index_offset) : NULL;
+    self->payload = base + header.payload_offset;
+    self->owner = OWNER_NONE;
+    return SOS_OK;
+}
+
+SosStatus sos_strtab_open(SosStrtab* self, const char* path)
+{
+#ifdef SOS_STRTAB_MMAP
+    int fd;
+    do {
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) {
+        return SOS_ERROR_IO;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return SOS_ERROR_IO;
+    }
+    if ((size_t)st.st_size < sizeof(SosStrtabHeader)) {
+        close(fd);
+        return SOS_ERROR_INVALID;
+    }
+    const size_t size = (size_t)st.st_size;
+    void* const data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return SOS_ERROR_IO;
+    }
+    const SosStatus ret = sos_strtab_open_buffer(self, data, size);
+    if (ret != SOS_OK) {
+        munmap(data, size);
+        return ret;
+    }
+    self->owner = OWNER_MAP;
+    return SOS_OK;
+#else
+    // Without mmap, read the whole file into memory.
+    Sos content;
+    FILE* const fp = fopen(path, "rb");
+    if (!fp) {
+        return SOS_ERROR_IO;
+    }
+    sos_init(&content);
+    char buf[65536];
+    size_t count;
+    while ((count = fread(buf, 1, sizeof(buf), fp)) > 0) {
+        if (sos_append_range(&content, buf, count) != SOS_OK) {
+            fclose(fp);
+            sos_finish(&content);
+            return SOS_ERROR_ALLOC;
+        }
+    }
+    const bool failed = ferror(fp);
+    fclose(fp);
+    if (failed) {
+        sos_finish(&content);
+        return SOS_ERROR_IO;
+    }
+    // malloc'd memory is suitably aligned
+    const SosViewMut data = sos_release(&content);
+    if (!data.data) {
+        return SOS_ERROR_ALLOC;
+    }
+    const SosStatus ret = sos_strtab_open_buffer(self, data.data, data.len);
+    if (ret != SOS_OK) {
+        free(data.data);
+        return ret;
+    }
+    self->owner = OWNER_HEAP;
+    return SOS_OK;
+#endif
+}
+
+void sos_strtab_close(SosStrtab* self)
+{
+    switch (self->owner) {
+#ifdef SOS_STRTAB_MMAP
+    case OWNER_MAP: munmap((void*)self->base, self->size); break;
+#endif
+    case OWNER_HEAP: free((void*)self->base); break;
+    default: break;
+    }
+    self->base = NULL;
+    self->count = 0;
+    self->owner = OWNER_NONE;
+}
+
+size_t sos_strtab_count(const SosStrtab* self)
+{
+    return self->count;
+}
+
+SosView sos_strtab_get(const SosStrtab* self, size_t i)
+{
+    const SosStrtabEntry* const entry = &self->entries[i];
+    // Opening validates only the header, entries are bounds-checked here
+    const size_t payload_size = self->size - (size_t)(self->payload - self->base);
+    if (entry->offset >= payload_size || entry->len >= payload_size - entry->offset || self->payload[entry->offset + entry->len] != 0) {
+        return (SosView) {.data = "", .len = 0};
+    }
+    return (SosView) {.data = self->payload + entry->offset, .len = (size_t)entry->len};
+}
+
+size_t sos_strtab_find(const SosStrtab* self, SosView key)
+{
+    if (!self->index) {
+        return SOS_STRTAB_NPOS;
+    }
+
+    size_t lo = 0;
+    size_t hi = self->count;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        const uint64_t id = self->index[mid];
+        if (id >= self->count) {
+            return SOS_STRTAB_NPOS; // Corrupted index
+        }
+        const int ret = view_cmp(sos_strtab_get(self, (size_t)id), key);
+        if (ret == 0) {
+            return (size_t)id;
+        }
+        if (ret < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return SOS_STRTAB_NPOS;
+}
@@ -0,0 +1,108 @@
+#ifndef SOS_STRTAB_H
+#define SOS_STRTAB_H
+
+// Serialized, read-only string tables
+//
+// A string table stores an array of strings in one file, which can be memory-mapped and used in place,
+// with no parsing or allocation per string.
+//
+// Layout (all integers are in the byte order of the writer, sections are 64-byte aligned):
+//   header   SosStrtabHeader
+//   entries  SosStrtabEntry[count], offset and length of each string, relative to the payload section
+//   index    uint64_t[count], entry numbers in ascending order of strings (optional)
+//   payload  null-terminated strings, back to back
+
+#include <stdint.h>
+#include "sos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SOS_STRTAB_MAGIC   "SOSSTRTB"
+#define SOS_STRTAB_VERSION 1u
+#define SOS_STRTAB_NPOS    ((size_t)-1)
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order; // 0x01020304 as written by the writer
+    uint64_t count;
+    uint64_t entries_offset;
+    uint64_t index_offset; // Zero if there is no sorted index
+    uint64_t payload_offset;
+    uint64_t payload_size;
+    uint64_t file_size;
+} SosStrtabHeader;
+
+typedef struct {
+    uint64_t offset;
+    uint64_t len;
+} SosStrtabEntry;
+
+typedef struct {
+    const char*           base;
+    size_t                size;
+    size_t                count;
+    const SosStrtabEntry* entries;
+    const uint64_t*       index;
+    const char*           payload;
+    int                   owner; // How `base` is released by sos_strtab_close
+} SosStrtab;
+
+/**
+ * Write an array of strings as a string table to a file.
+ *
+ * @param[in] sorted_index Whether to include a sorted index, required by sos_strtab_find().
+ */
+SosStatus sos_strtab_write_file(const char* path, const Sos* strs, size_t n, bool sorted_index);
+
+/**
+ * Open a string table file.
+ * The file is memory-mapped where supported, otherwise it is read into memory.
+ * Only the header is validated, so that opening does not touch the whole file. Entries are bounds-checked on access.
+ *
+ * @pre `self` is not opened.
+ * @post On success, `self` is opened. SOS_ERROR_INVALID is returned if the header is not that of a valid string table.
+ */
+SosStatus sos_strtab_open(SosStrtab* self, const char* path);
+
+/**
+ * Open a string table that is already in memory. The memory is borrowed, and must outlive `self`.
+ *
+ * @param[in] data Address of the table, aligned to at-least 8 bytes.
+ * @pre `self` is not opened.
+ */
+SosStatus sos_strtab_open_buffer(SosStrtab* self, const void* data, size_t size);
+
+/**
+ * Close a string table. Views obtained from it are invalidated.
+ */
+void sos_strtab_close(SosStrtab* self);
+
+/**
+ * Get number of strings in the table.
+ */
+size_t sos_strtab_count(const SosStrtab* self);
+
+/**
+ * Get the `i`-th string. The view is null-terminated.
+ * An entry pointing outside of the payload, or to a string that is not null-terminated, reads as an empty string.
+ *
+ * @pre `i` < sos_strtab_count(self)
+ */
+SosView sos_strtab_get(const SosStrtab* self, size_t i);
+
+/**
+ * Binary search for a string, using the sorted index.
+ * Strings are ordered by their bytes as unsigned chars, a proper prefix ordering first.
+ *
+ * @return Number of a matching entry, or SOS_STRTAB_NPOS if there is none or the table has no index.
+ */
+size_t sos_strtab_find(const SosStrtab* self, SosView key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_STRTAB_H
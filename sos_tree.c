@@ -0,0 +1,775 @@
+#include "sos_tree.h"
+#include "sos_internal.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Prefix bytes stored in a node. Longer prefixes are skipped optimistically by lookups, which compare whole keys at leaves,
+// and are read from a leaf below the node where all bytes are needed.
+#define SOS_TREE_MAX_PREFIX 8
+
+enum {
+    NODE4,
+    NODE16,
+    NODE48,
+    NODE256
+};
+
+typedef struct {
+    uint8_t       type;
+    uint16_t      count; // Number of children
+    uint32_t      prefix_len;
+    unsigned char prefix[SOS_TREE_MAX_PREFIX];
+    SosTreeEntry* leaf; // Entry whose key ends at this node, if any
+} Node;
+
+// Children are tagged pointers, leaves have the lowest bit set.
+// Node4 and Node16 keep their keys sorted. Node48 maps a byte to a child slot + 1, zero if absent.
+
+typedef struct {
+    Node          n;
+    unsigned char keys[4];
+    void*         children[4];
+} Node4;
+
+typedef struct {
+    Node          n;
+    unsigned char keys[16];
+    void*         children[16];
+} Node16;
+
+typedef struct {
+    Node          n;
+    unsigned char index[256];
+    void*         children[48];
+} Node48;
+
+typedef struct {
+    Node  n;
+    void* children[256];
+} Node256;
+
+static const size_t node_sizes[] = {sizeof(Node4), sizeof(Node16), sizeof(Node48), sizeof(Node256)};
+
+static bool
+is_leaf(const void* ref)
+{
+    return ((uintptr_t)ref & 1u) != 0;
+}
+
+static SosTreeEntry*
+as_leaf(const void* ref)
+{
+    return (SosTreeEntry*)((uintptr_t)ref & ~(uintptr_t)1u);
+}
+
+static void*
+leaf_ref(SosTreeEntry* entry)
+{
+    return (void*)((uintptr_t)entry | 1u);
+}
+
+SosView sos_tree_entry_key(const SosTreeEntry* entry)
+{
+    return (SosView) {.data = (const char*)(entry + 1), .len = entry->key_len};
+}
+
+static int
+view_cmp(SosView lhs, SosView rhs)
+{
+    const size_t len = lhs.len < rhs.len ? lhs.len : rhs.len;
+    const int ret = len ? memcmp(lhs.data, rhs.data, len) : 0;
+    if (ret != 0) {
+        return ret;
+    }
+    return (lhs.len > rhs.len) - (lhs.len < rhs.len);
+}
+
+static bool
+view_eq(SosView lhs, SosView rhs)
+{
+    return lhs.len == rhs.len && (lhs.len == 0 || memcmp(lhs.data, rhs.data, lhs.len) == 0);
+}
+
+static SosTreeEntry*
+leaf_new(SosTree* tree, SosView key, void* value)
+{
+    const size_t size = sizeof(SosTreeEntry) + key.len + 1;
+    SosTreeEntry* const entry = malloc(size);
+    if (!entry) {
+        return NULL;
+    }
+    entry->value = value;
+    entry->key_len = key.len;
+    char* const data = (char*)(entry + 1);
+    if (key.len) {
+        memcpy(data, key.data, key.len);
+    }
+    data[key.len] = 0;
+    tree->bytes += size;
+    tree->count += 1;
+    return entry;
+}
+
+static void
+leaf_free(SosTree* tree, SosTreeEntry* entry)
+{
+    tree->bytes -= sizeof(SosTreeEntry) + entry->key_len + 1;
+    tree->count -= 1;
+    free(entry);
+}
+
+static Node*
+node_new(SosTree* tree, uint8_t type)
+{
+    Node* const node = calloc(1, node_sizes[type]);
+    if (node) {
+        node->type = type;
+        tree->bytes += node_sizes[type];
+    }
+    return node;
+}
+
+static void
+set_prefix(Node* node, const unsigned char* prefix, size_t len)
+{
+    node->prefix_len = (uint32_t)len;
+    memcpy(node->prefix, prefix, len < SOS_TREE_MAX_PREFIX ? len : SOS_TREE_MAX_PREFIX);
+}
+
+/**
+ * Iterate children in ascending order of bytes.
+ *
+ * @param[in,out] pos Iteration state, starting from zero.
+ * @return The next child, or NULL at the end.
+ */
+static void*
+next_child(const Node* node, unsigned* pos, unsigned char* byte)
+{
+    switch (node->type) {
+    case NODE4: {
+        const Node4* const n = (const Node4*)node;
+        if (*pos < node->count) {
+            *byte = n->keys[*pos];
+            return n->children[(*pos)++];
+        }
+        return NULL;
+    }
+    case NODE16: {
+        const Node16* const n = (const Node16*)node;
+        if (*pos < node->count) {
+            *byte = n->keys[*pos];
+            return n->children[(*pos)++];
+        }
+        return NULL;
+    }
+    case NODE48: {
+        const Node48* const n = (const Node48*)node;
+        for (; *pos < 256; ++*pos) {
+            if (n->index[*pos]) {
+                *byte = (unsigned char)*pos;
+                return n->children[n->index[(*pos)++] - 1];
+            }
+        }
+        return NULL;
+    }
+    default: {
+        const Node256* const n = (const Node256*)node;
+        for (; *pos < 256; ++*pos) {
+            if (n->children[*pos]) {
+                *byte = (unsigned char)*pos;
+                return n->children[(*pos)++];
+            }
+        }
+        return NULL;
+    }
+    }
+}
+
+/**
+ * Get the iteration state of next_child() skipping children of bytes less than `c`.
+ */
+static unsigned
+child_pos_from(const Node* node, unsigned char c)
+{
+    const unsigned char* keys;
+    switch (node->type) {
+    case NODE4:
+        keys = ((const Node4*)node)->keys;
+        break;
+    case NODE16:
+        keys = ((const Node16*)node)->keys;
+        break;
+    default:
+        return c;
+    }
+    unsigned pos = 0;
+    while (pos < node->count && keys[pos] < c) {
+        ++pos;
+    }
+    return pos;
+}
+
+static void**
+find_child(Node* node, unsigned char c)
+{
+    switch (node->type) {
+    case NODE4: {
+        Node4* const n = (Node4*)node;
+        for (unsigned i = 0; i < node->count; ++i) {
+            if (n->keys[i] == c) {
+                return &n->children[i];
+            }
+        }
+        return NULL;
+    }
+    case NODE16: {
+        Node16* const n = (Node16*)node;
+#ifdef SOS_HAVE_SSE2
+        const __m128i eq = _mm_cmpeq_epi8(_mm_set1_epi8((char)c), _mm_loadu_si128((const __m128i*)n->keys));
+        const unsigned mask = (unsigned)_mm_movemask_epi8(eq) & ((1u << node->count) - 1);
+        return mask ? &n->children[count_trailing_zeros(mask)] : NULL;
+#else
+        for (unsigned i = 0; i < node->count; ++i) {
+            if (n->keys[i] == c) {
+                return &n->children[i];
+            }
+        }
+        return NULL;
+#endif
+    }
+    case NODE48: {
+        Node48* const n = (Node48*)node;
+        return n->index[c] ? &n->children[n->index[c] - 1] : NULL;
+    }
+    default: {
+        Node256* const n = (Node256*)node;
+        return n->children[c] ? &n->children[c] : NULL;
+    }
+    }
+}
+
+/**
+ * Get the entry with the smallest key under `ref`.
+ */
+static const SosTreeEntry*
+minimum(const void* ref)
+{
+    while (!is_leaf(ref)) {
+        const Node* const node = ref;
+        if (node->leaf) {
+            return node->leaf;
+        }
+        unsigned pos = 0;
+        unsigned char byte;
+        ref = next_child(node, &pos, &byte);
+    }
+    return as_leaf(ref);
+}
+
+/**
+ * Get all prefix bytes of `node`, whose prefix starts at `depth` of keys.
+ */
+static const unsigned char*
+node_prefix(const Node* node, size_t depth)
+{
+    if (node->prefix_len <= SOS_TREE_MAX_PREFIX) {
+        return node->prefix;
+    }
+    return (const unsigned char*)sos_tree_entry_key(minimum(node)).data + depth;
+}
+
+/**
+ * Get number of leading prefix bytes of `node` that match `key` from `depth`.
+ */
+static size_t
+prefix_mismatch(const Node* node, SosView key, size_t depth)
+{
+    const size_t limit = node->prefix_len < key.len - depth ? node->prefix_len : key.len - depth;
+    const unsigned char* const prefix = node_prefix(node, depth);
+    const unsigned char* const k = (const unsigned char*)key.data + depth;
+    size_t i = 0;
+    while (i < limit && prefix[i] == k[i]) {
+        ++i;
+    }
+    return i;
+}
+
+/**
+ * Add a child to a node that has room for it, keeping keys sorted.
+ */
+static void
+add_child_fit(Node* node, unsigned char c, void* child)
+{
+    switch (node->type) {
+    case NODE4:
+    case NODE16: {
+        unsigned char* const keys = node->type == NODE4 ? ((Node4*)node)->keys : ((Node16*)node)->keys;
+        void** const children = node->type == NODE4 ? ((Node4*)node)->children : ((Node16*)node)->children;
+        const unsigned pos = child_pos_from(node, c);
+        memmove(keys + pos + 1, keys + pos, node->count - pos);
+        memmove(children + pos + 1, children + pos, (node->count - pos) * sizeof(void*));
+        keys[pos] = c;
+        children[pos] = child;
+        break;
+    }
+    case NODE48: {
+        Node48* const n = (Node48*)node;
+        n->children[node->count] = child;
+        n->index[c] = (unsigned char)(node->count + 1);
+        break;
+    }
+    default:
+        ((Node256*)node)->children[c] = child;
+        break;
+    }
+    node->count += 1;
+}
+
+/**
+ * Add a child, growing the node into the next size if full.
+ *
+ * @param[in,out] ref Where `node` is referenced from, updated if it grows.
+ */
+static SosStatus
+add_child(SosTree* tree, void** ref, Node* node, unsigned char c, void* child)
+{
+    static const unsigned caps[] = {4, 16, 48, 256};
+    if (node->count < caps[node->type]) {
+        add_child_fit(node, c, child);
+        return SOS_OK;
+    }
+
+    Node* const grown = node_new(tree, (uint8_t)(node->type + 1));
+    if (!grown) {
+        return SOS_ERROR_ALLOC;
+    }
+    const uint8_t type = grown->type;
+    *grown = *node;
+    grown->type = type;
+    grown->count = 0;
+    unsigned pos = 0;
+    unsigned char byte;
+    void* old;
+    while ((old = next_child(node, &pos, &byte)) != NULL) {
+        add_child_fit(grown, byte, old);
+    }
+    add_child_fit(grown, c, child);
+    tree->bytes -= node_sizes[node->type];
+    free(node);
+    *ref = grown;
+    return SOS_OK;
+}
+
+/**
+ * Put an entry into a new node, either as the node's own leaf or as a child.
+ */
+static void
+place_entry(Node* node, SosTreeEntry* entry, size_t depth)
+{
+    const SosView key = sos_tree_entry_key(entry);
+    if (key.len == depth) {
+        node->leaf = entry;
+    } else {
+        add_child_fit(node, (unsigned char)key.data[depth], leaf_ref(entry));
+    }
+}
+
+static void
+free_ref(void* ref)
+{
+    if (!ref) {
+        return;
+    }
+    if (is_leaf(ref)) {
+        free(as_leaf(ref));
+        return;
+    }
+    Node* const node = ref;
+    if (node->leaf) {
+        free_ref(leaf_ref(node->leaf));
+    }
+    unsigned pos = 0;
+    unsigned char byte;
+    void* child;
+    while ((child = next_child(node, &pos, &byte)) != NULL) {
+        free_ref(child);
+    }
+    free(node);
+}
+
+void sos_tree_init(SosTree* self)
+{
+    self->root = NULL;
+    self->count = 0;
+    self->bytes = 0;
+}
+
+void sos_tree_finish(SosTree* self)
+{
+    free_ref(self->root);
+    sos_tree_init(self);
+}
+
+size_t sos_tree_count(const SosTree* self)
+{
+    return self->count;
+}
+
+size_t sos_tree_memory(const SosTree* self)
+{
+    return self->bytes;
+}
+
+SosStatus sos_tree_insert(SosTree* self, SosView key, void* value)
+{
+    if (key.len > UINT32_MAX) {
+        return SOS_ERROR_MAX_CAP; // Prefix lengths are 32-bit
+    }
+
+    void** ref = &self->root;
+    size_t depth = 0;
+    for (;;) {
+        void* const cur = *ref;
+        if (!cur) {
+            SosTreeEntry* const entry = leaf_new(self, key, value);
+            if (!entry) {
+                return SOS_ERROR_ALLOC;
+            }
+            *ref = leaf_ref(entry);
+            return SOS_OK;
+        }
+
+        if (is_leaf(cur)) {
+            SosTreeEntry* const old = as_leaf(cur);
+            const SosView old_key = sos_tree_entry_key(old);
+            if (view_eq(old_key, key)) {
+                old->value = value;
+                return SOS_OK;
+            }
+            // Split into a node over the common prefix
+            const size_t limit = (old_key.len < key.len ? old_key.len : key.len) - depth;
+            size_t lcp = 0;
+            while (lcp < limit && old_key.data[depth + lcp] == key.data[depth + lcp]) {
+                ++lcp;
+            }
+            SosTreeEntry* const entry = leaf_new(self, key, value);
+            if (!entry) {
+                return SOS_ERROR_ALLOC;
+            }
+            Node* const node = node_new(self, NODE4);
+            if (!node) {
+                leaf_free(self, entry);
+                return SOS_ERROR_ALLOC;
+            }
+            set_prefix(node, (const unsigned char*)key.data + depth, lcp);
+            place_entry(node, old, depth + lcp);
+            place_entry(node, entry, depth + lcp);
+            *ref = node;
+            return SOS_OK;
+        }
+
+        Node* const node = cur;
+        if (node->prefix_len) {
+            const size_t mismatch = prefix_mismatch(node, key, depth);
+            if (mismatch < node->prefix_len) {
+                // Split the prefix, branching at the first mismatch
+                SosTreeEntry* const entry = leaf_new(self, key, value);
+                if (!entry) {
+                    return SOS_ERROR_ALLOC;
+                }
+                Node* const parent = node_new(self, NODE4);
+                if (!parent) {
+                    leaf_free(self, entry);
+                    return SOS_ERROR_ALLOC;
+                }
+                const unsigned char* const full = node_prefix(node, depth);
+                set_prefix(parent, full, mismatch);
+                const unsigned char branch = full[mismatch];
+                const size_t rest = node->prefix_len - mismatch - 1;
+                unsigned char kept[SOS_TREE_MAX_PREFIX];
+                memcpy(kept, full + mismatch + 1, rest < SOS_TREE_MAX_PREFIX ? rest : SOS_TREE_MAX_PREFIX);
+                set_prefix(node, kept, rest);
+                add_child_fit(parent, branch, node);
+                place_entry(parent, entry, depth + mismatch);
+                *ref = parent;
+                return SOS_OK;
+            }
+            depth += node->prefix_len;
+        }
+
+        if (key.len == depth) {
+            if (node->leaf) {
+                node->leaf->value = value;
+                return SOS_OK;
+            }
+            node->leaf = leaf_new(self, key, value);
+            return node->leaf ? SOS_OK : SOS_ERROR_ALLOC;
+        }
+
+        void** const child = find_child(node, (unsigned char)key.data[depth]);
+        if (!child) {
+            SosTreeEntry* const entry = leaf_new(self, key, value);
+            if (!entry) {
+                return SOS_ERROR_ALLOC;
+            }
+            const SosStatus status = add_child(self, ref, node, (unsigned char)key.data[depth], leaf_ref(entry));
+            if (status != SOS_OK) {
+                leaf_free(self, entry);
+            }
+            return status;
+        }
+        ref = child;
+        depth += 1;
+    }
+}
+
+SosTreeEntry* sos_tree_find(const SosTree* self, SosView key)
+{
+    const void* ref = self->root;
+    size_t depth = 0;
+    while (ref) {
+        if (is_leaf(ref)) {
+            SosTreeEntry* const entry = as_leaf(ref);
+            return view_eq(sos_tree_entry_key(entry), key) ? entry : NULL;
+        }
+        Node* const node = (Node*)ref;
+        if (node->prefix_len) {
+            if (key.len - depth < node->prefix_len) {
+                return NULL;
+            }
+            const size_t stored = node->prefix_len < SOS_TREE_MAX_PREFIX ? node->prefix_len : SOS_TREE_MAX_PREFIX;
+            if (memcmp(node->prefix, key.data + depth, stored) != 0) {
+                return NULL;
+            }
+            depth += node->prefix_len;
+        }
+        if (key.len == depth) {
+            return node->leaf && view_eq(sos_tree_entry_key(node->leaf), key) ? node->leaf : NULL;
+        }
+        void** const child = find_child(node, (unsigned char)key.data[depth]);
+        if (!child) {
+            return NULL;
+        }
+        ref = *child;
+        depth += 1;
+    }
+    return NULL;
+}
+
+/**
+ * Visit all entries under `ref`.
+ *
+ * @return false if the visitor stopped the scan.
+ */
+static bool
+visit_all(void* ref, SosTreeVisitor fn, void* ctx)
+{
+    if (is_leaf(ref)) {
+        return fn(as_leaf(ref), ctx);
+    }
+    const Node* const node = ref;
+    if (node->leaf && !fn(node->leaf, ctx)) {
+        return false;
+    }
+    unsigned pos = 0;
+    unsigned char byte;
+    void* child;
+    while ((child = next_child(node, &pos, &byte)) != NULL) {
+        if (!visit_all(child, fn, ctx)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Visit entries under `ref` with keys not less than `lo`, given that their first `depth` bytes equal those of `lo`.
+ *
+ * @return false if the visitor stopped the scan.
+ */
+static bool
+visit_from(void* ref, size_t depth, SosView lo, SosTreeVisitor fn, void* ctx)
+{
+    if (is_leaf(ref)) {
+        SosTreeEntry* const entry = as_leaf(ref);
+        return view_cmp(sos_tree_entry_key(entry), lo) < 0 || fn(entry, ctx);
+    }
+    const Node* const node = ref;
+    if (node->prefix_len) {
+        const unsigned char* const prefix = node_prefix(node, depth);
+        for (size_t i = 0; i < node->prefix_len; ++i) {
+            if (depth + i == lo.len) {
+                return visit_all(ref, fn, ctx); // `lo` is a prefix of all keys here
+            }
+            const unsigned char c = (unsigned char)lo.data[depth + i];
+            if (prefix[i] != c) {
+                return prefix[i] < c || visit_all(ref, fn, ctx);
+            }
+        }
+        depth += node->prefix_len;
+    }
+    if (lo.len == depth) {
+        return visit_all(ref, fn, ctx);
+    }
+
+    // The node's own key is a proper prefix of `lo`, hence less
+    const unsigned char c = (unsigned char)lo.data[depth];
+    unsigned pos = child_pos_from(node, c);
+    unsigned char byte;
+    void* child;
+    while ((child = next_child(node, &pos, &byte)) != NULL) {
+        if (!(byte == c ? visit_from(child, depth + 1, lo, fn, ctx) : visit_all(child, fn, ctx))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+first_visitor(SosTreeEntry* entry, void* ctx)
+{
+    *(SosTreeEntry**)ctx = entry;
+    return false;
+}
+
+SosTreeEntry* sos_tree_lower_bound(const SosTree* self, SosView key)
+{
+    SosTreeEntry* first = NULL;
+    if (self->root) {
+        visit_from(self->root, 0, key, first_visitor, &first);
+    }
+    return first;
+}
+
+typedef struct {
+    SosView        bound;
+    SosTreeVisitor fn;
+    void*          ctx;
+} BoundedScan;
+
+static bool
+range_visitor(SosTreeEntry* entry, void* ctx)
+{
+    const BoundedScan* const scan = ctx;
+    return view_cmp(sos_tree_entry_key(entry), scan->bound) < 0 && scan->fn(entry, scan->ctx);
+}
+
+static bool
+prefix_visitor(SosTreeEntry* entry, void* ctx)
+{
+    const BoundedScan* const scan = ctx;
+    const SosView key = sos_tree_entry_key(entry);
+    return key.len >= scan->bound.len && (scan->bound.len == 0 || memcmp(key.data, scan->bound.data, scan->bound.len) == 0) &&
+           scan->fn(entry, scan->ctx);
+}
+
+void sos_tree_scan_range(const SosTree* self, SosView lo, SosView hi, SosTreeVisitor fn, void* ctx)
+{
+    if (self->root && view_cmp(lo, hi) < 0) {
+        BoundedScan scan = {hi, fn, ctx};
+        visit_from(self->root, 0, lo, range_visitor, &scan);
+    }
+}
+
+void sos_tree_scan_prefix(const SosTree* self, SosView prefix, SosTreeVisitor fn, void* ctx)
+{
+    if (self->root) {
+        BoundedScan scan = {prefix, fn, ctx};
+        visit_from(self->root, 0, prefix, prefix_visitor, &scan);
+    }
+}
+
+/**
+ * Build the subtree of sorted keys [begin, end), which share their first `depth` bytes, into `*ref`.
+ * On failure, `*ref` holds what has been built, for the caller to free.
+ */
+static SosStatus
+build(SosTree* tree, const Sos* keys, void* const* values, size_t begin, size_t end, size_t depth, void** ref)
+{
+    if (end - begin == 1) {
+        SosTreeEntry* const entry = leaf_new(tree, sos_view(&keys[begin]), values ? values[begin] : NULL);
+        if (!entry) {
+            return SOS_ERROR_ALLOC;
+        }
+        *ref = leaf_ref(entry);
+        return SOS_OK;
+    }
+
+    // In sorted keys, the prefix common to the first and last is common to all, which is checked below
+    const SosView first = sos_view(&keys[begin]);
+    const SosView last = sos_view(&keys[end - 1]);
+    const size_t limit = (first.len < last.len ? first.len : last.len) - depth;
+    size_t lcp = 0;
+    while (lcp < limit && first.data[depth + lcp] == last.data[depth + lcp]) {
+        ++lcp;
+    }
+    const size_t d = depth + lcp;
+    if (last.len == d) {
+        return SOS_ERROR_INVALID;
+    }
+    if (d > UINT32_MAX) {
+        return SOS_ERROR_MAX_CAP;
+    }
+
+    // Count children, checking that keys share the prefix and the order of their bytes after it.
+    // Each level compares only the bytes it adds, so checking costs one pass over the keys.
+    const size_t start = first.len == d ? begin + 1 : begin;
+    unsigned runs = 0;
+    int prev = -1;
+    for (size_t i = start; i < end; ++i) {
+        const SosView k = sos_view(&keys[i]);
+        if (k.len <= d || (unsigned char)k.data[d] < prev || (lcp && memcmp(k.data + depth, first.data + depth, lcp) != 0)) {
+            return SOS_ERROR_INVALID;
+        }
+        if ((unsigned char)k.data[d] != prev) {
+            prev = (unsigned char)k.data[d];
+            runs += 1;
+        }
+    }
+
+    Node* const node = node_new(tree, runs <= 4 ? NODE4 : runs <= 16 ? NODE16 : runs <= 48 ? NODE48 : NODE256);
+    if (!node) {
+        return SOS_ERROR_ALLOC;
+    }
+    set_prefix(node, (const unsigned char*)first.data + depth, lcp);
+    *ref = node;
+    if (start != begin) {
+        node->leaf = leaf_new(tree, first, values ? values[begin] : NULL);
+        if (!node->leaf) {
+            return SOS_ERROR_ALLOC;
+        }
+    }
+
+    size_t run = start;
+    while (run < end) {
+        const unsigned char c = (unsigned char)sos_cstr(&keys[run])[d];
+        size_t run_end = run + 1;
+        while (run_end < end && (unsigned char)sos_cstr(&keys[run_end])[d] == c) {
+            ++run_end;
+        }
+        void* child = NULL;
+        const SosStatus status = build(tree, keys, values, run, run_end, d + 1, &child);
+        if (child) {
+            add_child_fit(node, c, child);
+        }
+        if (status != SOS_OK) {
+            return status;
+        }
+        run = run_end;
+    }
+    return SOS_OK;
+}
+
+SosStatus sos_tree_init_from_sorted(SosTree* self, const Sos* keys, void* const* values, size_t n)
+{
+    sos_tree_init(self);
+    if (n == 0) {
+        return SOS_OK;
+    }
+    const SosStatus status = build(self, keys, values, 0, n, 0, &self->root);
+    if (status != SOS_OK) {
+        sos_tree_finish(self);
+    }
+    return status;
+}
@@ -0,0 +1,107 @@
+#ifndef SOS_TREE_H
+#define SOS_TREE_H
+
+// Ordered string index: an adaptive radix tree (ART)
+//
+// Inner nodes branch on one byte of the key, and come in four sizes (4, 16, 48 and 256 children)
+// to stay small when sparse. Runs of bytes without branching are compressed into node prefixes.
+// Each key is stored once, inline in its leaf, so a lookup touches no memory beyond the path and the leaf.
+// Keys are ordered by their bytes as unsigned chars, a proper prefix ordering first, as in sos_sort().
+
+#include "sos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// An entry is followed by its null-terminated key, see sos_tree_entry_key().
+typedef struct {
+    void*  value;
+    size_t key_len;
+} SosTreeEntry;
+
+typedef struct {
+    void*  root;
+    size_t count;
+    size_t bytes; // Memory held by nodes and leaves
+} SosTree;
+
+/**
+ * Visitor of scans, called on entries in ascending order of keys. Returning false stops the scan.
+ */
+typedef bool (*SosTreeVisitor)(SosTreeEntry* entry, void* ctx);
+
+/**
+ * Get the key of an entry. The view is null-terminated.
+ */
+SosView sos_tree_entry_key(const SosTreeEntry* entry);
+
+/**
+ * Initialize an empty tree.
+ *
+ * @pre `self` is not initialized.
+ */
+void sos_tree_init(SosTree* self);
+
+/**
+ * Initialize a tree from keys sorted in ascending order, building nodes bottom-up with no search or node growth.
+ * Keys are copied.
+ *
+ * @param[in] values Value of each key, or NULL for all values to be NULL.
+ * @pre `self` is not initialized.
+ * @post On success, `self` is initialized. On failure, `self` is not initialized.
+ *       SOS_ERROR_INVALID is returned if keys are found to be out of order or duplicated.
+ */
+SosStatus sos_tree_init_from_sorted(SosTree* self, const Sos* keys, void* const* values, size_t n);
+
+/**
+ * Finish a tree, freeing all nodes and keys.
+ */
+void sos_tree_finish(SosTree* self);
+
+/**
+ * Get number of keys.
+ */
+size_t sos_tree_count(const SosTree* self);
+
+/**
+ * Get number of bytes allocated by the tree, including keys.
+ */
+size_t sos_tree_memory(const SosTree* self);
+
+/**
+ * Insert a copy of `key`, or replace its value if present.
+ */
+SosStatus sos_tree_insert(SosTree* self, SosView key, void* value);
+
+/**
+ * Find an entry by key.
+ *
+ * @return The entry, or NULL if not found. Valid until the tree is modified.
+ */
+SosTreeEntry* sos_tree_find(const SosTree* self, SosView key);
+
+/**
+ * Find the first entry with key not less than `key`.
+ *
+ * @return The entry, or NULL if there is none. Valid until the tree is modified.
+ */
+SosTreeEntry* sos_tree_lower_bound(const SosTree* self, SosView key);
+
+/**
+ * Visit entries with keys in [lo, hi), in ascending order.
+ * The tree must not be modified during the scan.
+ */
+void sos_tree_scan_range(const SosTree* self, SosView lo, SosView hi, SosTreeVisitor fn, void* ctx);
+
+/**
+ * Visit entries with keys starting with `prefix`, in ascending order. An empty prefix visits all entries.
+ * The tree must not be modified during the scan.
+ */
+void sos_tree_scan_prefix(const SosTree* self, SosView prefix, SosTreeVisitor fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOS_TREE_H
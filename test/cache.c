@@ -0,0 +1,71 @@
+#include "macros.h"
+#include <string.h>
+
+int cache(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    SosCacheStats stats = sos_cache_stats();
+    ASSERT(stats.limit == 0 && stats.cached_bytes == 0);
+
+    const char* const long_str = "0123456789012345678901234567890123456789";
+
+    // Disabled cache never holds buffers
+    Sos s;
+    sos_init_from_cstr(&s, long_str);
+    sos_finish(&s);
+    ASSERT(sos_cache_stats().cached_bytes == 0);
+
+    sos_cache_set_limit(1024);
+    sos_init_from_cstr(&s, long_str);
+    ASSERT(sos_cap(&s) == 63);
+    stats = sos_cache_stats();
+    ASSERT(stats.misses == 1 && stats.hits == 0);
+    sos_finish(&s);
+    ASSERT(sos_cache_stats().cached_bytes == 64);
+
+    // Same class is recycled
+    Sos s2;
+    sos_init_with_cap(&s2, 40);
+    stats = sos_cache_stats();
+    ASSERT(stats.hits == 1 && stats.cached_bytes == 0);
+    ASSERT(sos_len(&s2) == 0 && sos_cap(&s2) == 63);
+
+    // Growth paths draw from the cache
+    sos_finish(&s2);
+    sos_init(&s);
+    for (int i = 0; i < 40; ++i) {
+        sos_push(&s, 'x'); // 31 (miss), then 63 (hit)
+    }
+    sos_append_cstr(&s, long_str);
+    ASSERT(sos_len(&s) == 80);
+    stats = sos_cache_stats();
+    ASSERT(stats.hits == 2 && stats.misses == 3);
+    sos_finish(&s);
+
+    // Limit is respected
+    Sos many[32];
+    for (int i = 0; i < 32; ++i) {
+        sos_init_with_cap(&many[i], 100);
+    }
+    for (int i = 0; i < 32; ++i) {
+        sos_finish(&many[i]);
+    }
+    stats = sos_cache_stats();
+    ASSERT(stats.cached_bytes <= 1024);
+
+    // Large buffers bypass the cache
+    sos_init_with_cap(&s, 100000);
+    sos_finish(&s);
+    ASSERT(sos_cache_stats().cached_bytes == stats.cached_bytes);
+
+    sos_cache_flush();
+    ASSERT(sos_cache_stats().cached_bytes == 0);
+
+    sos_cache_set_limit(0);
+    sos_init_with_cap(&s, 100);
+    sos_finish(&s);
+    ASSERT(sos_cache_stats().cached_bytes == 0);
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include "macros.h"
+#include "../sos_codec.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Straightforward reference encoders, to check the SIMD kernels against
+static void
+ref_hex(const unsigned char* in, size_t n, char* out)
+{
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < n; ++i) {
+        out[2 * i] = digits[in[i] >> 4];
+        out[2 * i + 1] = digits[in[i] & 0xf];
+    }
+    out[2 * n] = 0;
+}
+
+static void
+ref_base64(const unsigned char* in, size_t n, char* out, bool url)
+{
+    const char* const chars = url ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+                                  : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t bits = 0;
+    unsigned acc = 0;
+    for (size_t i = 0; i < n; ++i) {
+        acc = (acc << 8 | in[i]) & 0xffff;
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            *out++ = chars[acc >> bits & 0x3f];
+        }
+    }
+    if (bits > 0) {
+        *out++ = chars[acc << (6 - bits) & 0x3f];
+    }
+    if (!url) {
+        for (size_t i = 0; i < (3 - n % 3) % 3; ++i) {
+            *out++ = '=';
+        }
+    }
+    *out = 0;
+}
+
+static int
+check_invalid_hex(const char* in)
+{
+    Sos s;
+    ASSERT(sos_init_from_cstr(&s, "prefix") == SOS_OK);
+    ASSERT(sos_append_hex_decoded(&s, in, strlen(in)) == SOS_ERROR_INVALID);
+    ASSERT_SOS_EQS(s, "prefix");
+    sos_finish(&s);
+    return 0;
+}
+
+static int
+check_invalid_base64(const char* in, SosBase64Alphabet alphabet)
+{
+    Sos s;
+    ASSERT(sos_init_from_cstr(&s, "prefix") == SOS_OK);
+    ASSERT(sos_append_base64_decoded(&s, in, strlen(in), alphabet) == SOS_ERROR_INVALID);
+    ASSERT_SOS_EQS(s, "prefix");
+    sos_finish(&s);
+    return 0;
+}
+
+#define CHECK(expr) do { if (expr) return 1; } while (0)
+
+int codec(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    // RFC 4648 test vectors
+    static const char* const plain[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+    static const char* const b64[] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+    for (size_t i = 0; i < 7; ++i) {
+        Sos s;
+        sos_init(&s);
+        ASSERT(sos_append_base64(&s, plain[i], strlen(plain[i]), SOS_BASE64_STANDARD) == SOS_OK);
+        ASSERT_SOS_EQS(s, b64[i]);
+        sos_clear(&s);
+        ASSERT(sos_append_base64_decoded(&s, b64[i], strlen(b64[i]), SOS_BASE64_STANDARD) == SOS_OK);
+        ASSERT_SOS_EQS(s, plain[i]);
+        sos_finish(&s);
+    }
+
+    Sos s;
+    sos_init(&s);
+    ASSERT(sos_append_hex(&s, "\x00\x9f\xff", 3) == SOS_OK);
+    ASSERT_SOS_EQS(s, "009fff");
+    sos_clear(&s);
+    ASSERT(sos_append_hex_decoded(&s, "DEADbeef", 8) == SOS_OK);
+    ASSERT(sos_len(&s) == 4 && memcmp(sos_cstr(&s), "\xde\xad\xbe\xef", 4) == 0);
+    sos_clear(&s);
+    ASSERT(sos_append_base64(&s, "\xfb\xff", 2, SOS_BASE64_URL) == SOS_OK);
+    ASSERT_SOS_EQS(s, "-_8");
+    sos_clear(&s);
+    ASSERT(sos_append_base64_decoded(&s, "-_8=", 4, SOS_BASE64_URL) == SOS_OK); // Padding is optional
+    ASSERT(sos_len(&s) == 2 && memcmp(sos_cstr(&s), "\xfb\xff", 2) == 0);
+    sos_finish(&s);
+
+    CHECK(check_invalid_hex("abc"));
+    CHECK(check_invalid_hex("0g"));
+    // Bad char inside a SIMD block
+    CHECK(check_invalid_hex("00112233445566778899aabbccddeeff00112233445566778899aabbccddeefX00112233"));
+    CHECK(check_invalid_base64("Zm9vY", SOS_BASE64_STANDARD));
+    CHECK(check_invalid_base64("Zm=v", SOS_BASE64_STANDARD));
+    CHECK(check_invalid_base64("====", SOS_BASE64_STANDARD));
+    CHECK(check_invalid_base64("Zm9v-_", SOS_BASE64_STANDARD));
+    CHECK(check_invalid_base64("Zm9v+/", SOS_BASE64_URL));
+    CHECK(check_invalid_base64("QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVpBQkNERUZHSElKS0xNTk9QUVJTVFVWV1hZ*kFCQ0RFRkdISUpLTE1OT1BRUlNUVVZXWFla", SOS_BASE64_STANDARD));
+    CHECK(check_invalid_base64("QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVpBQkNERUZHSElKS0xNTk9QUVJTVFVWV1hZ\x80kFCQ0RFRkdISUpLTE1OT1BRUlNUVVZXWFla", SOS_BASE64_URL));
+
+    // SIMD against reference, over lengths spanning block sizes and tails
+    srand(99);
+    unsigned char buf[300];
+    char expected[2 * sizeof(buf) + 1];
+    for (size_t len = 0; len < sizeof(buf); ++len) {
+        for (size_t i = 0; i < len; ++i) {
+            buf[i] = (unsigned char)rand();
+        }
+        Sos enc, dec;
+        sos_init(&enc);
+        sos_init(&dec);
+
+        ref_hex(buf, len, expected);
+        ASSERT(sos_append_hex(&enc, buf, len) == SOS_OK);
+        ASSERT_SOS_EQS(enc, expected);
+        ASSERT(sos_append_hex_decoded(&dec, sos_cstr(&enc), sos_len(&enc)) == SOS_OK);
+        ASSERT(sos_len(&dec) == len && memcmp(sos_cstr(&dec), buf, len) == 0);
+
+        for (int url = 0; url < 2; ++url) {
+            const SosBase64Alphabet alphabet = url ? SOS_BASE64_URL : SOS_BASE64_STANDARD;
+            sos_clear(&enc);
+            sos_clear(&dec);
+            ref_base64(buf, len, expected, url);
+            ASSERT(sos_append_base64(&enc, buf, len, alphabet) == SOS_OK);
+            ASSERT_SOS_EQS(enc, expected);
+            ASSERT(sos_append_base64_decoded(&dec, sos_cstr(&enc), sos_len(&enc), alphabet) == SOS_OK);
+            ASSERT(sos_len(&dec) == len && memcmp(sos_cstr(&dec), buf, len) == 0);
+        }
+        sos_finish(&enc);
+        sos_finish(&dec);
+    }
+    return 0;
+}
@@ -0,0 +1,279 @@
+#include "macros.h"
+#include "../sos.hpp"
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static_assert(std::is_nothrow_move_constructible<sos::string>::value, "");
+static_assert(std::is_nothrow_move_assignable<sos::string>::value, "");
+static_assert(sos::is_trivially_relocatable_v<sos::string>, "");
+static_assert(!sos::is_trivially_relocatable_v<std::vector<int>>, "");
+
+namespace {
+
+const char long_text[] = "a string that does not fit the small buffer";
+
+// Counts bytes in use, to check that strings free through the resource they allocated from
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t live = 0;
+    std::size_t allocs = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override
+    {
+        live += bytes;
+        allocs += 1;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override
+    {
+        live -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& rhs) const noexcept override { return this == &rhs; }
+};
+
+struct CAllocCounts {
+    long live;
+    std::size_t allocs;
+};
+
+void* c_alloc(void* ctx, std::size_t size)
+{
+    static_cast<CAllocCounts*>(ctx)->live += static_cast<long>(size);
+    static_cast<CAllocCounts*>(ctx)->allocs += 1;
+    return std::malloc(size);
+}
+
+void c_free(void* ctx, void* data, std::size_t size)
+{
+    static_cast<CAllocCounts*>(ctx)->live -= static_cast<long>(size);
+    std::free(data);
+}
+
+} // namespace
+
+extern "C" int cxx(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    // Construction and access
+    sos::string a;
+    ASSERT(a.empty());
+    ASSERT(a == "");
+    sos::string b = "hello";
+    ASSERT_EQ(b.size(), 5);
+    ASSERT(std::strcmp(b.c_str(), "hello") == 0);
+    b += ", ";
+    b += std::string("world");
+    b.push_back('!');
+    ASSERT(b == "hello, world!");
+    ASSERT(b.view() == std::string_view("hello, world!"));
+    ASSERT(std::string(b.begin(), b.end()) == "hello, world!");
+    b[0] = 'H';
+    ASSERT(b.compare("Hello, world!") == 0);
+    b.pop_back();
+    ASSERT(b.back() == 'd');
+
+    // Comparison with other string types, embedded NULs included
+    const std::string_view with_nul("ab\0c", 4);
+    sos::string c(with_nul);
+    ASSERT_EQ(c.size(), 4);
+    ASSERT(c == with_nul);
+    ASSERT(c != "ab");
+    ASSERT("ab" < c);
+    ASSERT(c > std::string("ab"));
+    ASSERT(sos::string("abc") <= sos::string("abd"));
+
+    // Copy and move
+    sos::string l(long_text);
+    sos::string l2 = l;
+    ASSERT(l2 == l && l2.data() != l.data());
+    const char* const buf = l.data();
+    sos::string l3 = std::move(l);
+    ASSERT(l3.data() == buf);
+    ASSERT(l.empty()); // NOLINT: moved-from strings are empty
+    l = std::move(l3);
+    ASSERT(l.data() == buf && l3.empty());
+    l3 = l;
+    ASSERT(l3 == long_text);
+    l3 = "short";
+    ASSERT(l3 == "short");
+    swap(l, l3);
+    ASSERT(l == "short" && l3 == long_text);
+
+    l.resize(8, 'x');
+    ASSERT(l == "shortxxx");
+    l.reserve(100);
+    ASSERT(l.capacity() >= 100);
+    l.shrink_to_fit();
+    l.clear();
+    ASSERT(l.empty());
+
+    // Appending and assigning views of the string itself, short and long
+    {
+        sos::string s = "abc";
+        s += s;
+        ASSERT(s == "abcabc");
+        s += std::string_view(s).substr(1);
+        ASSERT(s == "abcabcbcabc");
+        for (int i = 0; i < 3; ++i) {
+            s += s; // Grows out of the small buffer, then reallocates
+        }
+        ASSERT_EQ(s.size(), 88);
+        ASSERT(s.view().substr(77) == "abcabcbcabc");
+        s += std::string_view(s).substr(1);
+        ASSERT_EQ(s.size(), 175);
+
+        sos::string t(long_text);
+        t = std::string_view(t).substr(1);
+        ASSERT(t == long_text + 1);
+        t = t.view();
+        ASSERT(t == long_text + 1);
+        t = std::string_view(t).substr(1, 6);
+        ASSERT(t == "string");
+        t = std::string_view(t).substr(6);
+        ASSERT(t.empty());
+    }
+
+    // Appends grow geometrically
+    {
+        sos::string s;
+        std::size_t growths = 0;
+        for (int i = 0; i < 10000; ++i) {
+            const std::size_t cap = s.capacity();
+            s += "0123456789abcdef";
+            growths += s.capacity() != cap;
+        }
+        ASSERT_EQ(s.size(), 160000);
+        ASSERT(growths < 20);
+    }
+
+    // Growing containers move, or memcpy for relocation
+    {
+        std::vector<sos::string> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.emplace_back(i % 2 ? long_text : "short");
+        }
+        for (int i = 0; i < 1000; ++i) {
+            ASSERT(v[i] == (i % 2 ? long_text : "short"));
+        }
+
+        sos::string* const src = std::allocator<sos::string>().allocate(2);
+        new (src) sos::string(long_text);
+        new (src + 1) sos::string("short");
+        sos::string* const dst = std::allocator<sos::string>().allocate(2);
+        ASSERT(sos::relocate(src, src + 2, dst) == dst + 2);
+        std::allocator<sos::string>().deallocate(src, 2);
+        ASSERT(dst[0] == long_text && dst[1] == "short");
+        dst[0].~basic_string();
+        dst[1].~basic_string();
+        std::allocator<sos::string>().deallocate(dst, 2);
+    }
+
+    // Hashing agrees with the C API
+    {
+        Sos s;
+        sos_init_from_cstr(&s, long_text);
+        ASSERT_EQ(std::hash<sos::string>()(sos::string(long_text)), static_cast<std::size_t>(sos_hash(&s)));
+        ASSERT_EQ(sos::hash()(long_text), static_cast<std::size_t>(sos_hash(&s)));
+        sos_finish(&s);
+
+        std::unordered_map<sos::string, int> m;
+        m["one"] = 1;
+        m[sos::string(long_text)] = 2;
+        ASSERT_EQ(m.at("one"), 1);
+        ASSERT_EQ(m.at(sos::string(long_text)), 2);
+    }
+
+    // Custom allocator of the C API
+    {
+        CAllocCounts counts = {0, 0};
+        const SosAllocator alloc = {c_alloc, c_free, &counts};
+        ASSERT(sos_set_thread_allocator(&alloc) == nullptr);
+        const SosCacheStats cache_before = sos_cache_stats();
+        Sos s;
+        sos_init_from_cstr(&s, long_text);
+        ASSERT_EQ(counts.allocs, 1);
+        for (int i = 0; i < 100; ++i) {
+            sos_append_cstr(&s, long_text);
+        }
+        ASSERT(counts.live == static_cast<long>(sos_cap(&s) + 1));
+        // Released buffers are malloc()'ed ones
+        SosViewMut released = sos_release(&s);
+        ASSERT_EQ(counts.live, 0);
+        ASSERT_EQ(released.len, (sizeof(long_text) - 1) * 101);
+        // Adopted buffers move to the allocator
+        ASSERT_EQ(sos_init_adopt_cstr(&s, released.data), SOS_OK);
+        ASSERT(counts.live == static_cast<long>(sos_cap(&s) + 1));
+        sos_finish(&s);
+        ASSERT_EQ(counts.live, 0);
+        ASSERT_EQ(sos_cache_stats().hits, cache_before.hits);
+        ASSERT_EQ(sos_cache_stats().misses, cache_before.misses);
+
+        // sos::string ignores the thread allocator, and leaves it installed
+        const std::size_t allocs = counts.allocs;
+        {
+            sos::string d(long_text);
+            d += long_text;
+        }
+        ASSERT_EQ(counts.allocs, allocs);
+        ASSERT_EQ(counts.live, 0);
+        ASSERT(sos_set_thread_allocator(nullptr) == &alloc);
+    }
+
+#ifdef SOS_HAVE_PMR
+    // Memory resources
+    {
+        CountingResource res;
+        {
+            sos::pmr::string p(&res);
+            p = "short";
+            ASSERT_EQ(res.allocs, 0);
+            p += long_text;
+            ASSERT_EQ(res.allocs, 1);
+            ASSERT(res.live > 0);
+            for (int i = 0; i < 100; ++i) {
+                p += long_text;
+            }
+            ASSERT(p.size() == 5 + 101 * (sizeof(long_text) - 1));
+
+            // Moves keep the resource, copies use the default one
+            sos::pmr::string q = std::move(p);
+            ASSERT(q.policy().resource() == &res);
+            sos::pmr::string r = q;
+            ASSERT(r.policy().resource() == std::pmr::get_default_resource());
+            ASSERT(r == q);
+
+            // Move-assignment across resources copies
+            const std::size_t live = res.live;
+            r = std::move(q);
+            ASSERT(r.policy().resource() == std::pmr::get_default_resource());
+            ASSERT_EQ(q.size(), r.size());
+            ASSERT_EQ(res.live, live);
+
+            std::vector<sos::pmr::string> v;
+            for (int i = 0; i < 100; ++i) {
+                v.emplace_back(long_text, &res);
+            }
+        }
+        ASSERT_EQ(res.live, 0);
+        ASSERT(sos_set_thread_allocator(nullptr) == nullptr);
+
+        // Failures of the resource surface as std::bad_alloc, leaving the string intact
+        sos::pmr::string n("short", std::pmr::null_memory_resource());
+        bool thrown = false;
+        try {
+            n += long_text;
+        } catch (const std::bad_alloc&) {
+            thrown = true;
+        }
+        ASSERT(thrown);
+        ASSERT(n == "short");
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "macros.h"
+#include "../sos_escape.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef SosStatus (*AppendFn)(Sos* restrict, const char* restrict, size_t);
+
+static int
+check_escape(AppendFn fn, const char* in, const char* expected)
+{
+    Sos s;
+    sos_init(&s);
+    ASSERT(fn(&s, in, strlen(in)) == SOS_OK);
+    ASSERT_SOS_EQS(s, expected);
+    sos_finish(&s);
+    return 0;
+}
+
+static int
+check_invalid(AppendFn fn, const char* in)
+{
+    Sos s;
+    ASSERT(sos_init_from_cstr(&s, "prefix") == SOS_OK);
+    ASSERT(fn(&s, in, strlen(in)) == SOS_ERROR_INVALID);
+    ASSERT_SOS_EQS(s, "prefix");
+    sos_finish(&s);
+    return 0;
+}
+
+static int
+check_round_trip(AppendFn enc, AppendFn dec, const char* in, size_t len)
+{
+    Sos e, d;
+    sos_init(&e);
+    sos_init(&d);
+    ASSERT(enc(&e, in, len) == SOS_OK);
+    ASSERT(dec(&d, sos_cstr(&e), sos_len(&e)) == SOS_OK);
+    ASSERT(sos_len(&d) == len && memcmp(sos_cstr(&d), in, len) == 0);
+    sos_finish(&e);
+    sos_finish(&d);
+    return 0;
+}
+
+#define CHECK(expr) do { if (expr) return 1; } while (0)
+
+int escape(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    CHECK(check_escape(sos_append_json_escaped, "plain", "plain"));
+    CHECK(check_escape(sos_append_json_escaped, "a \"quoted\" \\path\\ with a long enough tail\n\t\x01", "a \\\"quoted\\\" \\\\path\\\\ with a long enough tail\\n\\t\\u0001"));
+    CHECK(check_escape(sos_append_json_escaped, "caf\xc3\xa9", "caf\xc3\xa9"));
+    CHECK(check_escape(sos_append_json_unescaped, "\\u00e9\\ud83d\\ude00\\/\\b", "\xc3\xa9\xf0\x9f\x98\x80/\b"));
+    CHECK(check_invalid(sos_append_json_unescaped, "bad \\x escape"));
+    CHECK(check_invalid(sos_append_json_unescaped, "trailing \\"));
+    CHECK(check_invalid(sos_append_json_unescaped, "raw \" quote"));
+    CHECK(check_invalid(sos_append_json_unescaped, "\\ud83d alone"));
+    CHECK(check_invalid(sos_append_json_unescaped, "\\ude00"));
+    CHECK(check_invalid(sos_append_json_unescaped, "\\u12"));
+
+    CHECK(check_escape(sos_append_csv_quoted, "", "\"\""));
+    CHECK(check_escape(sos_append_csv_quoted, "say \"hi\", then leave", "\"say \"\"hi\"\", then leave\""));
+    CHECK(check_escape(sos_append_csv_unquoted, "\"a,\"\"b\"\"\"", "a,\"b\""));
+    CHECK(check_escape(sos_append_csv_unquoted, "plain", "plain"));
+    CHECK(check_escape(sos_append_csv_unquoted, "", ""));
+    CHECK(check_invalid(sos_append_csv_unquoted, "\"open"));
+    CHECK(check_invalid(sos_append_csv_unquoted, "\""));
+    CHECK(check_invalid(sos_append_csv_unquoted, "\"in\"side\""));
+    CHECK(check_invalid(sos_append_csv_unquoted, "un\"quoted"));
+
+    CHECK(check_escape(sos_append_url_encoded, "a b/c?d=e&f~g.h-i_j", "a%20b%2Fc%3Fd%3De%26f~g.h-i_j"));
+    CHECK(check_escape(sos_append_url_decoded, "a%20b%2fc", "a b/c"));
+    CHECK(check_invalid(sos_append_url_decoded, "50%"));
+    CHECK(check_invalid(sos_append_url_decoded, "%zz"));
+
+    // Appending keeps the existing content
+    Sos s;
+    ASSERT(sos_init_from_cstr(&s, "x=") == SOS_OK);
+    ASSERT(sos_append_url_encoded(&s, "1 2", 3) == SOS_OK);
+    ASSERT_SOS_EQS(s, "x=1%202");
+    sos_finish(&s);
+
+    // Round trips over random bytes, spanning the SIMD and scalar paths
+    srand(1234);
+    char buf[300];
+    for (int iter = 0; iter < 200; ++iter) {
+        const size_t len = (size_t)rand() % sizeof(buf);
+        for (size_t i = 0; i < len; ++i) {
+            // Mostly clean bytes, some that need escaping
+            buf[i] = rand() % 4 ? (char)('a' + rand() % 26) : (char)(rand() % 256);
+        }
+        CHECK(check_round_trip(sos_append_json_escaped, sos_append_json_unescaped, buf, len));
+        CHECK(check_round_trip(sos_append_csv_quoted, sos_append_csv_unquoted, buf, len));
+        CHECK(check_round_trip(sos_append_url_encoded, sos_append_url_decoded, buf, len));
+    }
+    return 0;
+}
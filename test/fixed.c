@@ -0,0 +1,94 @@
+#include "macros.h"
+#include "../sos_fixed.h"
+#include <string.h>
+
+typedef struct {
+    int id;
+    SOS_FIXED(15) name;
+} Record;
+
+int fixed(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    SOS_FIXED(8) a = SOS_FIXED_INIT(8);
+    ASSERT_EQ(sos_fixed_len(&a.hdr), 0);
+    ASSERT_EQ(sos_fixed_cap(&a.hdr), 8);
+    ASSERT(strcmp(sos_fixed_cstr(&a.hdr), "") == 0);
+
+    ASSERT_EQ(sos_fixed_append_cstr(&a.hdr, "abc"), SOS_OK);
+    ASSERT_EQ(sos_fixed_push(&a.hdr, 'd'), SOS_OK);
+    ASSERT(strcmp(sos_fixed_cstr(&a.hdr), "abcd") == 0);
+
+    // Overflow leaves the content unchanged
+    ASSERT_EQ(sos_fixed_append_cstr(&a.hdr, "efghi"), SOS_ERROR_MAX_CAP);
+    ASSERT(strcmp(sos_fixed_cstr(&a.hdr), "abcd") == 0);
+    ASSERT_EQ(sos_fixed_append_format(&a.hdr, "%d", 123456), SOS_ERROR_MAX_CAP);
+    ASSERT(strcmp(sos_fixed_cstr(&a.hdr), "abcd") == 0);
+    ASSERT_EQ(sos_fixed_append_format(&a.hdr, "%d", 1234), SOS_OK);
+    ASSERT(strcmp(sos_fixed_cstr(&a.hdr), "abcd1234") == 0);
+    ASSERT_EQ(sos_fixed_push(&a.hdr, 'x'), SOS_ERROR_MAX_CAP);
+    ASSERT_EQ(sos_fixed_append_range(&a.hdr, "", 0), SOS_OK);
+
+    const SosView v = sos_fixed_view(&a.hdr);
+    ASSERT(v.data == sos_fixed_cstr(&a.hdr));
+    ASSERT_EQ(v.len, 8);
+
+    // Embedded in a struct, initialized at runtime
+    Record r;
+    r.id = 1;
+    sos_fixed_init(&r.name.hdr, 15);
+    ASSERT_EQ(sos_fixed_append_format(&r.name.hdr, "abcd%s", "1234"), SOS_OK);
+    ASSERT(sos_fixed_eq(&a.hdr, &r.name.hdr));
+    ASSERT_EQ(sos_fixed_cmp(&a.hdr, &r.name.hdr), 0);
+    ASSERT_EQ(sos_fixed_hash(&a.hdr), sos_fixed_hash(&r.name.hdr));
+
+    ASSERT_EQ(sos_fixed_push(&r.name.hdr, 0), SOS_OK); // embedded NUL counts
+    ASSERT(!sos_fixed_eq(&a.hdr, &r.name.hdr));
+    ASSERT(sos_fixed_cmp(&a.hdr, &r.name.hdr) < 0);
+    ASSERT(sos_fixed_cmp(&r.name.hdr, &a.hdr) > 0);
+
+    sos_fixed_clear(&r.name.hdr);
+    ASSERT_EQ(sos_fixed_append_cstr(&r.name.hdr, "abce"), SOS_OK);
+    ASSERT(sos_fixed_cmp(&a.hdr, &r.name.hdr) < 0);
+    ASSERT_EQ(sos_fixed_cmp_cstr(&r.name.hdr, "abce"), 0);
+    ASSERT(sos_fixed_cmp_cstr(&r.name.hdr, "abc") > 0);
+    ASSERT(sos_fixed_cmp_cstr(&r.name.hdr, "abcf") < 0);
+
+    // Resize and pop
+    ASSERT_EQ(sos_fixed_resize(&r.name.hdr, 16, '-'), SOS_ERROR_MAX_CAP);
+    ASSERT(strcmp(sos_fixed_cstr(&r.name.hdr), "abce") == 0);
+    ASSERT_EQ(sos_fixed_resize(&r.name.hdr, 15, '-'), SOS_OK);
+    ASSERT(strcmp(sos_fixed_cstr(&r.name.hdr), "abce-----------") == 0);
+    ASSERT_EQ(sos_fixed_resize(&r.name.hdr, 3, '-'), SOS_OK);
+    ASSERT(strcmp(sos_fixed_cstr(&r.name.hdr), "abc") == 0);
+    ASSERT_EQ(sos_fixed_pop(&r.name.hdr), 'c');
+    ASSERT_EQ(sos_fixed_len(&r.name.hdr), 2);
+    ASSERT(strcmp(sos_fixed_cstr(&r.name.hdr), "ab") == 0);
+
+    // Conversion to Sos; hashes agree with the Sos API
+    Sos s;
+    ASSERT_EQ(sos_fixed_to_sos(&a.hdr, &s), SOS_OK);
+    ASSERT_SOS_EQS(s, "abcd1234");
+    ASSERT_EQ(sos_hash(&s), sos_fixed_hash(&a.hdr));
+    sos_finish(&s);
+
+    SOS_FIXED(40) big = SOS_FIXED_INIT(40);
+    for (int i = 0; i < 40; ++i) {
+        ASSERT_EQ(sos_fixed_push(&big.hdr, (char)('a' + i % 26)), SOS_OK);
+    }
+    ASSERT_EQ(sos_fixed_push(&big.hdr, 'z'), SOS_ERROR_MAX_CAP);
+    ASSERT_EQ(sos_fixed_to_sos(&big.hdr, &s), SOS_OK); // long mode
+    ASSERT_EQ(sos_len(&s), 40);
+    ASSERT(memcmp(sos_cstr(&s), sos_fixed_cstr(&big.hdr), 40) == 0);
+    sos_finish(&s);
+
+    // Zero capacity
+    SOS_FIXED(0) z = SOS_FIXED_INIT(0);
+    ASSERT_EQ(sos_fixed_push(&z.hdr, 'a'), SOS_ERROR_MAX_CAP);
+    ASSERT_EQ(sos_fixed_append_format(&z.hdr, "%s", ""), SOS_OK);
+    ASSERT_EQ(sos_fixed_append_format(&z.hdr, "x"), SOS_ERROR_MAX_CAP);
+    ASSERT(strcmp(sos_fixed_cstr(&z.hdr), "") == 0);
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "macros.h"
+#include "../sos_fsst.h"
+#include <stdio.h>
+#include <string.h>
+
+int fsst(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    enum { N = 2000 };
+    static const char* const hosts[] = {"example.com", "www.example.org", "static.example.net"};
+    static const char* const paths[] = {"/index.html", "/api/v1/users/", "/assets/img/logo.png", "/search?q="};
+
+    Sos arr[N];
+    size_t raw = 0;
+    for (size_t i = 0; i < N; ++i) {
+        ASSERT(sos_init_format(&arr[i], "https://%s%s%zu", hosts[i % 3], paths[i % 4], i * 7919 % 1000) == SOS_OK);
+        raw += sos_len(&arr[i]);
+    }
+    // Empty string, and bytes outside the symbol table
+    sos_clear(&arr[1]);
+    sos_clear(&arr[2]);
+    ASSERT(sos_append_range(&arr[2], "\xff\x00\x01zq\xfe", 6) == SOS_OK);
+    // Long string of mostly escaped bytes, beyond what is decoded in one pass
+    sos_clear(&arr[3]);
+    uint64_t x = 88172645463325252u;
+    for (int i = 0; i < 1500; ++i) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+        ASSERT(sos_push(&arr[3], (char)(x >> 56)) == SOS_OK);
+    }
+
+    SosFsstColumn col;
+    ASSERT(sos_fsst_column_build(&col, arr, N) == SOS_OK);
+    ASSERT(sos_fsst_column_count(&col) == N);
+    // Repetitive data compresses well
+    ASSERT(col.offsets[N] * 2 < raw);
+
+    char buf[256];
+    for (size_t i = 0; i < N; ++i) {
+        ASSERT(sos_fsst_column_len(&col, i) == sos_len(&arr[i]));
+        Sos s;
+        ASSERT(sos_fsst_column_get(&col, i, &s) == SOS_OK);
+        ASSERT(sos_eq(&s, &arr[i]));
+        ASSERT(sos_cstr(&s)[sos_len(&s)] == '\0');
+        sos_finish(&s);
+
+        ASSERT(sos_fsst_column_get_into(&col, i, buf, sizeof(buf)) == sos_len(&arr[i]));
+        ASSERT(sos_len(&arr[i]) >= sizeof(buf) || memcmp(buf, sos_cstr(&arr[i]), sos_len(&arr[i]) + 1) == 0);
+    }
+    // Buffers that fit exactly
+    char big[1501];
+    ASSERT(sos_fsst_column_get_into(&col, 3, big, sizeof(big)) == 1500);
+    ASSERT(memcmp(big, sos_cstr(&arr[3]), 1501) == 0);
+    ASSERT(sos_fsst_column_get_into(&col, 0, big, sos_len(&arr[0]) + 1) == sos_len(&arr[0]));
+    ASSERT(memcmp(big, sos_cstr(&arr[0]), sos_len(&arr[0]) + 1) == 0);
+    // Buffer too small: nothing written
+    buf[0] = 'x';
+    ASSERT(sos_fsst_column_get_into(&col, 0, buf, 4) == sos_len(&arr[0]));
+    ASSERT(buf[0] == 'x');
+
+    // Compressed comparison
+    Sos needle;
+    sos_init(&needle);
+    ASSERT(sos_fsst_compress(&col.table, sos_cstr(&arr[5]), sos_len(&arr[5]), &needle) == SOS_OK);
+    for (size_t i = 0; i < N; ++i) {
+        ASSERT(sos_fsst_column_eq(&col, i, &needle) == sos_eq(&arr[i], &arr[5]));
+    }
+    ASSERT(sos_fsst_compress(&col.table, "https://nowhere", 15, &needle) == SOS_OK);
+    for (size_t i = 0; i < N; ++i) {
+        ASSERT(!sos_fsst_column_eq(&col, i, &needle));
+    }
+    sos_finish(&needle);
+    sos_fsst_column_finish(&col);
+
+    // Empty column
+    ASSERT(sos_fsst_column_build(&col, arr, 0) == SOS_OK);
+    ASSERT(sos_fsst_column_count(&col) == 0);
+    sos_fsst_column_finish(&col);
+
+    for (size_t i = 0; i < N; ++i) {
+        sos_finish(&arr[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "macros.h"
+#include <string.h>
+
+typedef struct {
+    size_t allocs;
+    size_t reallocs;
+    size_t frees;
+    long   live_bytes;
+    size_t push_reallocs;
+} HookCounts;
+
+static void
+on_alloc(void* ctx, void* data, size_t size, const char* site)
+{
+    HookCounts* const c = ctx;
+    (void)data; (void)site;
+    c->allocs += 1;
+    c->live_bytes += (long)size;
+}
+
+static void
+on_realloc(void* ctx, void* old_data, size_t old_size, void* new_data, size_t new_size, const char* site)
+{
+    HookCounts* const c = ctx;
+    (void)old_data; (void)new_data;
+    c->reallocs += 1;
+    c->live_bytes += (long)new_size - (long)old_size;
+    if (strcmp(site, "sos_push") == 0) {
+        c->push_reallocs += 1;
+    }
+}
+
+static void
+on_free(void* ctx, void* data, size_t size, const char* site)
+{
+    HookCounts* const c = ctx;
+    (void)data; (void)site;
+    c->frees += 1;
+    c->live_bytes -= (long)size;
+}
+
+int hooks(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    HookCounts counts = {0};
+    const SosAllocHooks table = {.on_alloc = on_alloc, .on_realloc = on_realloc, .on_free = on_free, .ctx = &counts};
+    sos_set_alloc_hooks(&table);
+
+    Sos s1, s2, s3;
+    sos_init(&s1);
+    for (int i = 0; i < 200; ++i) {
+        ASSERT(sos_push(&s1, 'x') == SOS_OK);
+    }
+    ASSERT(counts.allocs == 1); // short to long
+    ASSERT(counts.push_reallocs == 3); // 31 -> 63 -> 127 -> 255
+    ASSERT(sos_init_by_copy(&s2, &s1) == SOS_OK);
+    ASSERT(sos_init_from_cstr(&s3, "a long string, released to the caller") == SOS_OK);
+    ASSERT(counts.allocs == 3);
+    sos_shrink_to_fit(&s2);
+    ASSERT(counts.reallocs == 4);
+    ASSERT(counts.live_bytes > 0);
+
+    sos_finish(&s1);
+    sos_finish(&s2);
+    SosViewMut released = sos_release(&s3);
+    ASSERT(counts.frees == 3);
+    ASSERT(counts.live_bytes == 0);
+
+    // Bulk blocks are reported with the same size on allocation and release
+    const char fields[] = "short,a field long enough for long mode,another field in long mode";
+    Sos many[4];
+    const SosManyResult ret = sos_init_many_from_delimited(fields, sizeof(fields) - 1, ',', many, 4);
+    ASSERT(ret.status == SOS_OK && ret.count == 3 && ret.storage);
+    ASSERT(counts.allocs == 4 && counts.live_bytes > 0);
+    sos_finish_many(many, ret.count, ret.storage);
+    ASSERT(counts.frees == 4);
+    ASSERT(counts.live_bytes == 0);
+
+    sos_set_alloc_hooks(NULL);
+    Sos s4;
+    ASSERT(sos_init_from_cstr(&s4, "no hooks are called for this long string") == SOS_OK);
+    sos_finish(&s4);
+    ASSERT(counts.allocs == 4 && counts.frees == 4);
+
+    free(released.data);
+    return 0;
+}
@@ -0,0 +1,154 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // mkstemp
+#endif
+
+#include "macros.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <sos_io.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static void*
+counting_alloc(void* ctx, size_t size)
+{
+    *(size_t*)ctx += 1;
+    return malloc(size);
+}
+
+static void
+counting_free(void* ctx, void* data, size_t size)
+{
+    (void)ctx; (void)size;
+    free(data);
+}
+
+int io(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    char path[] = "/tmp/sos_test_io_XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT(fd >= 0);
+
+    Sos lines[4];
+    sos_init_from_cstr(&lines[0], "first\n");
+    sos_init(&lines[1]); // empty strings are skipped
+    sos_init(&lines[2]);
+    for (int i = 0; i < 300; ++i) {
+        sos_push(&lines[2], (char)('a' + i % 26));
+    }
+    sos_push(&lines[2], '\n');
+    sos_init_from_cstr(&lines[3], "last, without newline");
+
+    ASSERT(sos_writev_fd(fd, lines, 4) == SOS_OK);
+
+    Sos whole, expected;
+    sos_init(&expected);
+    for (int i = 0; i < 4; ++i) {
+        sos_append(&expected, &lines[i]);
+    }
+
+    ASSERT(sos_read_file(&whole, path) == SOS_OK);
+    ASSERT_SOS_EQ(whole, expected);
+    sos_finish(&whole);
+
+    ASSERT(lseek(fd, 6, SEEK_SET) == 6);
+    ASSERT(sos_read_fd(&whole, fd) == SOS_OK);
+    ASSERT_SOS_EQS(whole, sos_cstr(&expected) + 6);
+    sos_finish(&whole);
+
+    FILE* const fp = fopen(path, "r");
+    ASSERT(fp);
+    Sos line;
+    sos_init(&line);
+    ASSERT(sos_getline(&line, fp) == SOS_OK);
+    ASSERT_SOS_EQ(line, lines[0]);
+    ASSERT(sos_getline(&line, fp) == SOS_OK);
+    ASSERT_SOS_EQ(line, lines[2]);
+    const size_t cap = sos_cap(&line);
+    ASSERT(sos_getline(&line, fp) == SOS_OK);
+    ASSERT_SOS_EQ(line, lines[3]);
+    ASSERT(sos_cap(&line) == cap); // capacity is reused
+    ASSERT(sos_getline(&line, fp) == SOS_OK);
+    ASSERT(sos_len(&line) == 0);
+    fclose(fp);
+
+    // Null bytes are kept, at the beginning of a line, in the middle, and across a buffer regrowth
+    FILE* const nul_fp = tmpfile();
+    ASSERT(nul_fp);
+    static const char nul_input[] = "\0abc\nmid\0dle\n";
+    ASSERT(fwrite(nul_input, 1, sizeof(nul_input) - 1, nul_fp) == sizeof(nul_input) - 1);
+    char long_line[500];
+    memset(long_line, 'x', sizeof(long_line));
+    long_line[0] = 0;
+    long_line[200] = 0;
+    long_line[sizeof(long_line) - 1] = '\n';
+    ASSERT(fwrite(long_line, 1, sizeof(long_line), nul_fp) == sizeof(long_line));
+    rewind(nul_fp);
+    ASSERT(sos_getline(&line, nul_fp) == SOS_OK);
+    ASSERT(sos_len(&line) == 5 && memcmp(sos_cstr(&line), "\0abc\n", 5) == 0);
+    ASSERT(sos_getline(&line, nul_fp) == SOS_OK);
+    ASSERT(sos_len(&line) == 8 && memcmp(sos_cstr(&line), "mid\0dle\n", 8) == 0);
+    ASSERT(sos_getline(&line, nul_fp) == SOS_OK);
+    ASSERT(sos_len(&line) == sizeof(long_line) && memcmp(sos_cstr(&line), long_line, sizeof(long_line)) == 0);
+    ASSERT(sos_getline(&line, nul_fp) == SOS_OK);
+    ASSERT(sos_len(&line) == 0 && feof(nul_fp));
+    fclose(nul_fp);
+    sos_finish(&line);
+
+    ASSERT(sos_read_file(&whole, "/nonexistent/sos") == SOS_ERROR_IO);
+
+    // Reading a pipe, of unknown size, grows the string geometrically
+    int fds[2];
+    ASSERT(pipe(fds) == 0);
+    enum { PIPED = 8 << 20 };
+    const pid_t child = fork();
+    ASSERT(child >= 0);
+    if (child == 0) {
+        close(fds[0]);
+        char block[4096];
+        memset(block, 'p', sizeof(block));
+        for (size_t done = 0; done < PIPED; done += sizeof(block)) {
+            if (write(fds[1], block, sizeof(block)) != (ssize_t)sizeof(block)) {
+                _exit(1);
+            }
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+    size_t allocs = 0;
+    const SosAllocator alloc = {counting_alloc, counting_free, &allocs};
+    sos_set_thread_allocator(&alloc);
+    ASSERT(sos_read_fd(&whole, fds[0]) == SOS_OK);
+    sos_set_thread_allocator(NULL);
+    close(fds[0]);
+    int child_status;
+    ASSERT(waitpid(child, &child_status, 0) == child && WIFEXITED(child_status) && WEXITSTATUS(child_status) == 0);
+    ASSERT_EQ(sos_len(&whole), PIPED);
+    ASSERT(allocs < 16);
+    sos_set_thread_allocator(&alloc);
+    sos_finish(&whole);
+    sos_set_thread_allocator(NULL);
+
+    close(fd);
+    unlink(path);
+    for (int i = 0; i < 4; ++i) {
+        sos_finish(&lines[i]);
+    }
+    sos_finish(&expected);
+
+    return 0;
+}
+
+#else
+
+int io(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,57 @@
+#include "macros.h"
+#include <string.h>
+
+int large(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    // Crosses SOS_MMAP_THRESHOLD, if it is configured
+#ifdef SOS_MMAP_THRESHOLD
+    const size_t total = (size_t)SOS_MMAP_THRESHOLD * 3;
+#else
+    const size_t total = (size_t)1 << 20;
+#endif
+    char chunk[4096];
+    for (size_t i = 0; i < sizeof(chunk); ++i) {
+        chunk[i] = (char)('a' + i % 26);
+    }
+
+    Sos s;
+    sos_init(&s);
+    while (sos_len(&s) < total) {
+        ASSERT(sos_append_range(&s, chunk, sizeof(chunk)) == SOS_OK);
+        ASSERT(sos_cap(&s) >= sos_len(&s) && sos_cap(&s) % 2 == 1);
+    }
+    ASSERT(sos_len(&s) == total);
+    const char* const data = sos_cstr(&s);
+    ASSERT(data[total] == 0);
+    for (size_t i = 0; i < total; i += 4093) {
+        ASSERT(data[i] == (char)('a' + i % sizeof(chunk) % 26));
+    }
+
+    Sos copy;
+    ASSERT(sos_init_by_copy(&copy, &s) == SOS_OK);
+    ASSERT_SOS_EQ(copy, s);
+
+    sos_shrink_to_fit(&s);
+    ASSERT(sos_cap(&s) >= total);
+    ASSERT_SOS_EQ(copy, s);
+
+    // Shrink back below the threshold
+    sos_resize(&s, 100, 0);
+    sos_shrink_to_fit(&s);
+    ASSERT(sos_len(&s) == 100 && sos_cap(&s) >= 100);
+    ASSERT(memcmp(sos_cstr(&s), sos_cstr(&copy), 100) == 0);
+    sos_finish(&s);
+
+    // Released buffers are free()-able
+    SosViewMut released = sos_release(&copy);
+    ASSERT(released.data && released.len == total);
+    ASSERT(released.data[total] == 0);
+
+    ASSERT(sos_init_adopt_cstr(&s, released.data) == SOS_OK);
+    ASSERT(sos_len(&s) == total);
+    sos_finish(&s);
+
+    return 0;
+}
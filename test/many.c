@@ -0,0 +1,74 @@
+#include "macros.h"
+#include <string.h>
+
+int many(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    const char* const fields[] = {"id", "", "short field", "a field that is long enough for long mode", "x",
+                                  "another long field, which goes into the bulk block", "last"};
+    const size_t n = sizeof(fields) / sizeof(fields[0]);
+
+    char buf[512] = {0};
+    for (size_t i = 0; i < n; ++i) {
+        strcat(buf, fields[i]);
+        if (i + 1 < n) {
+            strcat(buf, "\t");
+        }
+    }
+    const size_t len = strlen(buf);
+
+    Sos out[16];
+    SosManyResult ret = sos_init_many_from_delimited(buf, len, '\t', out, 16);
+    ASSERT(ret.status == SOS_OK);
+    ASSERT(ret.count == n && ret.consumed == len);
+    ASSERT(ret.storage != NULL);
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_SOS_EQS(out[i], fields[i]);
+    }
+    sos_finish_many(out, ret.count, ret.storage);
+
+    // Trailing delimiter, output filled up
+    buf[len] = '\t';
+    ret = sos_init_many_from_delimited(buf, len + 1, '\t', out, 3);
+    ASSERT(ret.status == SOS_OK && ret.count == 3);
+    ASSERT(ret.storage == NULL); // no long fields
+    size_t total = ret.count;
+    size_t consumed = ret.consumed;
+    sos_finish_many(out, ret.count, ret.storage);
+    ret = sos_init_many_from_delimited(buf + consumed, len + 1 - consumed, '\t', out, 16);
+    ASSERT(ret.status == SOS_OK && ret.consumed == len + 1 - consumed);
+    total += ret.count;
+    ASSERT(total == n);
+    ASSERT_SOS_EQS(out[ret.count - 1], "last");
+    sos_finish_many(out, ret.count, ret.storage);
+
+    // Arena too small for the second long field
+    char arena[64];
+    ret = sos_init_many_from_delimited_in(buf, len, '\t', out, 16, arena, sizeof(arena));
+    ASSERT(ret.status == SOS_OK && ret.count == 5 && ret.storage == NULL);
+    ASSERT_SOS_EQS(out[3], fields[3]);
+    ASSERT(sos_cstr(&out[3]) >= arena && sos_cstr(&out[3]) < arena + sizeof(arena));
+    ASSERT(strncmp(buf + ret.consumed, fields[5], strlen(fields[5])) == 0);
+
+    // Many short lines, exercising the vectorized scan
+    char lines[4096];
+    size_t pos = 0;
+    for (int i = 0; i < 400; ++i) {
+        pos += (size_t)sprintf(lines + pos, "%d\n", i);
+    }
+    Sos many_out[512];
+    ret = sos_init_many_from_delimited(lines, pos, '\n', many_out, 512);
+    ASSERT(ret.status == SOS_OK && ret.count == 400 && ret.consumed == pos);
+    for (int i = 0; i < 400; ++i) {
+        char expected[16];
+        sprintf(expected, "%d", i);
+        ASSERT_SOS_EQS(many_out[i], expected);
+    }
+    sos_finish_many(many_out, ret.count, ret.storage);
+
+    ret = sos_init_many_from_delimited("", 0, '\n', out, 16);
+    ASSERT(ret.status == SOS_OK && ret.count == 0 && ret.consumed == 0);
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "macros.h"
+#include <sos_ngram.h>
+#include <string.h>
+
+#define CHECK(expr)       \
+    do {                  \
+        if (!(expr)) {    \
+            return false; \
+        }                 \
+    } while (0)
+
+typedef struct {
+    size_t* ids;
+    size_t  n;
+    size_t  cap;
+    size_t  stop_after; // Stop the search after this many results
+} Results;
+
+static bool
+collect(size_t id, SosView str, void* ctx)
+{
+    Results* const r = ctx;
+    (void)str;
+    if (r->n < r->cap) {
+        r->ids[r->n] = id;
+    }
+    r->n += 1;
+    return r->n < r->stop_after;
+}
+
+static bool
+ref_contains(SosView hay, SosView needle)
+{
+    for (size_t i = 0; i + needle.len <= hay.len; ++i) {
+        if (needle.len == 0 || memcmp(hay.data + i, needle.data, needle.len) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Check a search against a scan of `strs`
+static bool
+check_search(const SosNgramIndex* index, const Sos* strs, size_t n, SosView needle, size_t* ids)
+{
+    Results r = {ids, 0, n, (size_t)-1};
+    CHECK(sos_ngram_index_search(index, needle, collect, &r) == SOS_OK);
+    CHECK(r.n <= n);
+    size_t pos = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (ref_contains(sos_view(&strs[i]), needle)) {
+            CHECK(pos < r.n && ids[pos] == i);
+            ++pos;
+        }
+    }
+    CHECK(pos == r.n);
+
+    // Stopping early
+    if (r.n > 1) {
+        const size_t first = ids[0];
+        r = (Results) {ids, 0, n, 1};
+        CHECK(sos_ngram_index_search(index, needle, collect, &r) == SOS_OK);
+        CHECK(r.n == 1 && ids[0] == first);
+    }
+    return true;
+}
+
+static SosView
+cview(const char* s)
+{
+    return (SosView) {.data = s, .len = strlen(s)};
+}
+
+#define NSTRS 12000
+
+int ngram(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    SosNgramIndex* const empty = sos_ngram_index_create();
+    ASSERT(empty);
+    ASSERT_EQ(sos_ngram_index_count(empty), 0);
+    Results r = {NULL, 0, 0, (size_t)-1};
+    ASSERT_EQ(sos_ngram_index_search(empty, cview("abc"), collect, &r), SOS_OK);
+    ASSERT_EQ(sos_ngram_index_search(empty, cview(""), collect, &r), SOS_OK);
+    ASSERT_EQ(r.n, 0);
+    sos_ngram_index_destroy(empty);
+
+    // Hostnames and user agents sharing many trigrams, short strings, repeated trigrams and embedded nulls
+    Sos* const strs = malloc(NSTRS * sizeof(Sos));
+    size_t* const ids = malloc(NSTRS * sizeof(size_t));
+    ASSERT(strs && ids);
+    static const char* const words[] = {"api", "cdn", "mail", "www", "static", "eu-west", "us-east", "edge", "img", "auth"};
+    static const char* const tlds[] = {"com", "net", "org", "io", "co.uk"};
+    uint64_t x = 88172645463325252u;
+    size_t n = 0;
+    for (; n < NSTRS - 200; ++n) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+        if (n % 3 == 0) {
+            sos_init_format(&strs[n], "Mozilla/5.0 (Platform %u) Engine/%u.%u", (unsigned)(x % 40), (unsigned)(x >> 8) % 700, (unsigned)(x >> 20) % 100);
+        } else {
+            sos_init_format(&strs[n], "%s%u.%s.%s", words[x % 10], (unsigned)(x >> 8) % 5000, words[(x >> 24) % 10], tlds[(x >> 32) % 5]);
+        }
+    }
+    for (; n < NSTRS; ++n) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+        char s[8];
+        const size_t len = x % 8;
+        for (size_t i = 0; i < len; ++i) {
+            s[i] = "aab\0."[(x >> (8 * i)) % 5];
+        }
+        sos_init_from_range(&strs[n], s, len);
+    }
+
+    // Built on the calling thread, in parallel, and by single inserts
+    SosNgramIndex* indexes[3];
+    for (int i = 0; i < 3; ++i) {
+        indexes[i] = sos_ngram_index_create();
+        ASSERT(indexes[i]);
+    }
+    ASSERT_EQ(sos_ngram_index_add(indexes[0], NULL, strs, n), SOS_OK);
+    SosPool* const pool = sos_pool_create(4);
+    ASSERT(pool);
+    ASSERT_EQ(sos_ngram_index_add(indexes[1], pool, strs, n / 2), SOS_OK);
+    ASSERT_EQ(sos_ngram_index_add(indexes[1], pool, strs + n / 2, n - n / 2), SOS_OK);
+    sos_pool_destroy(pool);
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(sos_ngram_index_insert(indexes[2], sos_view(&strs[i])), SOS_OK);
+    }
+
+    for (int k = 0; k < 3; ++k) {
+        const SosNgramIndex* const index = indexes[k];
+        ASSERT_EQ(sos_ngram_index_count(index), n);
+        ASSERT(sos_ngram_index_memory(index) > 0);
+        for (size_t i = 0; i < n; ++i) {
+            const SosView v = sos_ngram_index_get(index, i);
+            ASSERT(v.len == sos_len(&strs[i]) && memcmp(v.data, sos_cstr(&strs[i]), v.len) == 0 && v.data[v.len] == 0);
+        }
+
+        static const char* const needles[] = {"", "a", ".c", "com", ".co.uk", "api1", "mail42.", "Engine/6", "Platform 3)", "zzz", "www.www", "5.0 (P"};
+        for (size_t i = 0; i < sizeof(needles) / sizeof(needles[0]); ++i) {
+            ASSERT(check_search(index, strs, n, cview(needles[i]), ids));
+        }
+        ASSERT(check_search(index, strs, n, (SosView) {.data = "a\0b", .len = 3}, ids));
+        // Substrings of stored strings
+        for (int q = 0; q < 50; ++q) {
+            x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+            const SosView s = sos_view(&strs[x % n]);
+            const size_t begin = s.len ? (x >> 16) % s.len : 0;
+            const size_t len = (x >> 32) % 12 < s.len - begin ? (x >> 32) % 12 : s.len - begin;
+            ASSERT(check_search(index, strs, n, (SosView) {.data = s.data + begin, .len = len}, ids));
+        }
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        sos_ngram_index_destroy(indexes[i]);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        sos_finish(&strs[i]);
+    }
+    free(ids);
+    free(strs);
+    return 0;
+}
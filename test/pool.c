@@ -0,0 +1,112 @@
+#include "macros.h"
+#include <sos_pool.h>
+#include <sos_sort.h>
+#include <string.h>
+
+static void
+mark_task(void* ctx, size_t begin, size_t end)
+{
+    unsigned char* const marks = ctx;
+    for (size_t i = begin; i < end; ++i) {
+        marks[i] += 1;
+    }
+}
+
+static void
+lower_fn(Sos* str, void* ctx)
+{
+    (void)ctx;
+    sos_to_lower(str);
+}
+
+int pool(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    SosPool* const p = sos_pool_create(4);
+    ASSERT(p);
+    ASSERT(sos_pool_size(p) >= 1);
+
+    // Every element is visited exactly once
+    enum { N = 100003 };
+    unsigned char* const marks = calloc(N, 1);
+    ASSERT(marks);
+    for (int round = 0; round < 3; ++round) {
+        sos_pool_run(p, N, 37, mark_task, marks);
+    }
+    for (size_t i = 0; i < N; ++i) {
+        ASSERT(marks[i] == 3);
+    }
+    free(marks);
+
+    enum { M = 20000 };
+    Sos* const arr = malloc(M * sizeof(Sos));
+    Sos* const expected = malloc(M * sizeof(Sos));
+    uint64_t* const hashes = malloc(M * sizeof(uint64_t));
+    unsigned char bitmap[(M + 7) / 8];
+    ASSERT(arr && expected && hashes);
+    for (int i = 0; i < M; ++i) {
+        if (i % 5 == 0) {
+            sos_init_format(&arr[i], "Invalid \xff %d", i);
+        } else {
+            sos_init_format(&arr[i], "Key-%d/%s", (i * 7919) % M, i % 2 ? "SHORT" : "A MUCH LONGER SUFFIX FOR LONG MODE");
+        }
+    }
+
+    sos_pool_set_chunk(p, 100);
+    sos_parallel_hash(p, arr, M, hashes);
+    sos_parallel_utf8_validate(p, arr, M, bitmap);
+    for (int i = 0; i < M; ++i) {
+        ASSERT(hashes[i] == sos_hash(&arr[i]));
+        ASSERT(((bitmap[i / 8] >> (i % 8)) & 1) == (i % 5 != 0));
+    }
+
+    sos_parallel_for_each(p, arr, M, lower_fn, NULL);
+    for (int i = 0; i < M; ++i) {
+        sos_init_by_copy(&expected[i], &arr[i]);
+        ASSERT(strchr(sos_cstr(&arr[i]), 'K') == NULL);
+    }
+
+    ASSERT(sos_sort(expected, M) == SOS_OK);
+    ASSERT(sos_sort_parallel(p, arr, M) == SOS_OK);
+    for (int i = 0; i < M; ++i) {
+        ASSERT_SOS_EQ(arr[i], expected[i]);
+    }
+
+    // Without a pool
+    sos_parallel_hash(NULL, arr, M, hashes);
+    ASSERT(hashes[M - 1] == sos_hash(&arr[M - 1]));
+
+    for (int i = 0; i < M; ++i) {
+        sos_finish(&arr[i]);
+        sos_finish(&expected[i]);
+    }
+
+    // Long common prefixes, identical or differing only near the end, take many byte passes
+    enum { LONG_N = 20000, LONG_LEN = 4000 };
+    Sos* const long_arr = malloc(LONG_N * sizeof(Sos));
+    ASSERT(long_arr);
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < LONG_N; ++i) {
+            ASSERT(sos_init_with_cap(&long_arr[i], LONG_LEN) == SOS_OK);
+            ASSERT(sos_resize(&long_arr[i], LONG_LEN, 'x') == SOS_OK);
+            if (round == 1) {
+                sos_cstr_mut(&long_arr[i])[LONG_LEN - 1 - i % 5] = (char)('a' + (LONG_N - i) % 7);
+            }
+        }
+        ASSERT(sos_sort_parallel(p, long_arr, LONG_N) == SOS_OK);
+        for (int i = 1; i < LONG_N; ++i) {
+            ASSERT(sos_cmp(&long_arr[i - 1], &long_arr[i]) <= 0);
+        }
+        for (int i = 0; i < LONG_N; ++i) {
+            sos_finish(&long_arr[i]);
+        }
+    }
+    free(long_arr);
+    free(arr);
+    free(expected);
+    free(hashes);
+    sos_pool_destroy(p);
+
+    return 0;
+}
@@ -0,0 +1,167 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // mkstemp
+#endif
+
+#include "macros.h"
+#include <sos_ring.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sos_io.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define PRODUCERS 4
+#define PER_PRODUCER 20000
+
+typedef struct {
+    SosRing* ring;
+    unsigned id;
+} Producer;
+
+static void*
+produce(void* arg)
+{
+    const Producer* const p = arg;
+    for (unsigned i = 0; i < PER_PRODUCER; ++i) {
+        Sos s;
+        // Every 8th string is long, to move heap buffers across threads
+        if (i % 8 == 0) {
+            sos_init_format(&s, "%u:%u:%s", p->id, i, "padding to exceed the small buffer");
+        } else {
+            sos_init_format(&s, "%u:%u", p->id, i);
+        }
+        while (sos_ring_push(p->ring, &s) != SOS_OK) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+#endif
+
+int ring(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+    static const char long_str[] = "a string that does not fit the small buffer";
+
+    SosRing* const r = sos_ring_create(5);
+    ASSERT(r);
+    ASSERT_EQ(sos_ring_cap(r), 8);
+
+    Sos out[16];
+    ASSERT_EQ(sos_ring_pop_batch(r, out, 16), 0);
+
+    // Fill up, alternating short and long strings
+    for (int i = 0; i < 8; ++i) {
+        Sos s;
+        if (i % 2) {
+            sos_init_format(&s, "%d:%s", i, long_str);
+        } else {
+            sos_init_format(&s, "%d", i);
+        }
+        ASSERT_EQ(sos_ring_push(r, &s), SOS_OK);
+    }
+    Sos extra;
+    sos_init_from_cstr(&extra, long_str);
+    ASSERT_EQ(sos_ring_push(r, &extra), SOS_ERROR_MAX_CAP);
+    ASSERT_SOS_EQS(extra, long_str);
+
+    // FIFO order, across wrap-around
+    ASSERT_EQ(sos_ring_pop_batch(r, out, 3), 3);
+    ASSERT_SOS_EQS(out[0], "0");
+    ASSERT(strncmp(sos_cstr(&out[1]), "1:", 2) == 0);
+    ASSERT_SOS_EQS(out[2], "2");
+    for (int i = 0; i < 3; ++i) {
+        sos_finish(&out[i]);
+    }
+    ASSERT_EQ(sos_ring_push(r, &extra), SOS_OK);
+    ASSERT_EQ(sos_ring_pop_batch(r, out, 16), 6);
+    ASSERT(strncmp(sos_cstr(&out[0]), "3:", 2) == 0);
+    ASSERT_SOS_EQS(out[1], "4");
+    ASSERT_SOS_EQS(out[5], long_str);
+    for (int i = 0; i < 6; ++i) {
+        sos_finish(&out[i]);
+    }
+    ASSERT_EQ(sos_ring_pop_batch(r, out, 16), 0);
+
+    // Queued strings are finished with the ring
+    for (int i = 0; i < 4; ++i) {
+        Sos s;
+        sos_init_from_cstr(&s, long_str);
+        ASSERT_EQ(sos_ring_push(r, &s), SOS_OK);
+    }
+    sos_ring_destroy(r);
+    sos_ring_destroy(NULL);
+
+#if defined(__unix__) || defined(__APPLE__)
+    // Concurrent producers: everything arrives once, in order per producer
+    {
+        SosRing* const mr = sos_ring_create(64);
+        ASSERT(mr);
+        pthread_t threads[PRODUCERS];
+        Producer producers[PRODUCERS];
+        for (unsigned t = 0; t < PRODUCERS; ++t) {
+            producers[t] = (Producer) {mr, t};
+            ASSERT_EQ(pthread_create(&threads[t], NULL, produce, &producers[t]), 0);
+        }
+        unsigned next[PRODUCERS] = {0};
+        size_t received = 0;
+        while (received < (size_t)PRODUCERS * PER_PRODUCER) {
+            const size_t n = sos_ring_pop_batch(mr, out, 16);
+            if (n == 0) {
+                sched_yield();
+            }
+            for (size_t i = 0; i < n; ++i) {
+                unsigned id, seq;
+                ASSERT_EQ(sscanf(sos_cstr(&out[i]), "%u:%u", &id, &seq), 2);
+                ASSERT(id < PRODUCERS);
+                ASSERT_EQ(seq, next[id]);
+                next[id] += 1;
+                sos_finish(&out[i]);
+            }
+            received += n;
+        }
+        for (unsigned t = 0; t < PRODUCERS; ++t) {
+            ASSERT_EQ(pthread_join(threads[t], NULL), 0);
+        }
+        ASSERT_EQ(sos_ring_pop_batch(mr, out, 16), 0);
+        sos_ring_destroy(mr);
+    }
+
+    // Draining to a file descriptor, in more than one vectored write
+    {
+        char path[] = "/tmp/sos_test_ring_XXXXXX";
+        const int fd = mkstemp(path);
+        ASSERT(fd >= 0);
+        SosRing* const wr = sos_ring_create(1024);
+        ASSERT(wr);
+        Sos expected;
+        sos_init(&expected);
+        for (int i = 0; i < 1000; ++i) {
+            Sos s;
+            sos_init_format(&s, i % 3 ? "line %d\n" : "line %d, %s\n", i, long_str);
+            sos_append(&expected, &s);
+            ASSERT_EQ(sos_ring_push(wr, &s), SOS_OK);
+        }
+        size_t count;
+        ASSERT_EQ(sos_ring_write_fd(wr, fd, 10, &count), SOS_OK);
+        ASSERT_EQ(count, 10);
+        ASSERT_EQ(sos_ring_write_fd(wr, fd, (size_t)-1, &count), SOS_OK);
+        ASSERT_EQ(count, 990);
+        ASSERT_EQ(sos_ring_write_fd(wr, fd, (size_t)-1, &count), SOS_OK);
+        ASSERT_EQ(count, 0);
+        sos_ring_destroy(wr);
+        close(fd);
+
+        Sos content;
+        ASSERT_EQ(sos_read_file(&content, path), SOS_OK);
+        ASSERT_SOS_EQ(content, expected);
+        sos_finish(&content);
+        sos_finish(&expected);
+        unlink(path);
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "macros.h"
+#include <sos_rope.h>
+#include <string.h>
+
+// Check the rope against a flat string
+static void
+check(const SosRope* rope, const Sos* flat)
+{
+    ASSERT(sos_rope_len(rope) == sos_len(flat));
+
+    Sos out;
+    ASSERT(sos_rope_flatten(rope, &out) == SOS_OK);
+    ASSERT_SOS_EQ(out, *flat);
+    sos_finish(&out);
+
+    SosRopeIter iter;
+    SosView chunk;
+    size_t pos = 0;
+    sos_rope_iter_init(&iter, rope, 0);
+    while (sos_rope_iter_next(&iter, &chunk)) {
+        ASSERT(chunk.len > 0);
+        ASSERT(memcmp(chunk.data, sos_cstr(flat) + pos, chunk.len) == 0);
+        pos += chunk.len;
+    }
+    ASSERT(pos == sos_len(flat));
+}
+
+static void
+flat_insert(Sos* flat, size_t pos, const char* str, size_t count)
+{
+    const size_t len = sos_len(flat);
+    sos_expand_for_overwrite(flat, count);
+    char* const data = sos_cstr_mut(flat);
+    memmove(data + pos + count, data + pos, len - pos);
+    memcpy(data + pos, str, count);
+}
+
+static void
+flat_erase(Sos* flat, size_t pos, size_t count)
+{
+    const size_t len = sos_len(flat);
+    char* const data = sos_cstr_mut(flat);
+    memmove(data + pos, data + pos + count, len - pos - count);
+    sos_resize(flat, len - count, 0);
+}
+
+int rope(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    SosRope r;
+    Sos flat;
+    sos_rope_init(&r);
+    sos_init(&flat);
+    check(&r, &flat);
+
+    char text[5000];
+    for (size_t i = 0; i < sizeof(text); ++i) {
+        text[i] = (char)('a' + i % 26);
+    }
+
+    // Random edits
+    unsigned seed = 12345;
+    for (int i = 0; i < 2000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        const size_t len = sos_len(&flat);
+        const size_t pos = len ? (seed >> 8) % (len + 1) : 0;
+        const size_t count = (seed >> 4) % 7 == 0 ? (seed >> 12) % sizeof(text) : (seed >> 12) % 40;
+        if ((seed >> 20) % 3 == 0 && len > 0) {
+            const size_t n = count < len - pos ? count : len - pos;
+            ASSERT(sos_rope_erase(&r, pos, count) == SOS_OK);
+            flat_erase(&flat, pos, n);
+        } else {
+            ASSERT(sos_rope_insert(&r, pos, text + (seed % 26), count - (count >= 26 ? seed % 26 : 0)) == SOS_OK);
+            flat_insert(&flat, pos, text + (seed % 26), count - (count >= 26 ? seed % 26 : 0));
+        }
+        if (i % 97 == 0) {
+            check(&r, &flat);
+        }
+    }
+    check(&r, &flat);
+
+    const size_t len = sos_len(&flat);
+    ASSERT(len > 1000);
+    ASSERT(sos_rope_at(&r, 0) == sos_cstr(&flat)[0]);
+    ASSERT(sos_rope_at(&r, len - 1) == sos_cstr(&flat)[len - 1]);
+
+    // Substring
+    SosRope sub;
+    ASSERT(sos_rope_substr(&r, 100, 700, &sub) == SOS_OK);
+    Sos sub_flat;
+    sos_init_from_range(&sub_flat, sos_cstr(&flat) + 100, 700);
+    check(&sub, &sub_flat);
+    sos_rope_finish(&sub);
+    sos_finish(&sub_flat);
+
+    // Split and concatenate
+    SosRope rest;
+    ASSERT(sos_rope_split(&r, len / 3, &rest) == SOS_OK);
+    ASSERT(sos_rope_len(&r) == len / 3);
+    ASSERT(sos_rope_len(&rest) == len - len / 3);
+    sos_rope_concat(&r, &rest);
+    check(&r, &flat);
+
+    // Iterate from the middle
+    SosRopeIter iter;
+    SosView chunk;
+    sos_rope_iter_init(&iter, &r, len / 2);
+    ASSERT(sos_rope_iter_next(&iter, &chunk));
+    ASSERT(chunk.data[0] == sos_cstr(&flat)[len / 2]);
+
+    ASSERT(sos_rope_erase(&r, 0, len) == SOS_OK);
+    ASSERT(sos_rope_len(&r) == 0);
+
+    sos_rope_finish(&r);
+    sos_finish(&flat);
+
+    ASSERT(sos_rope_init_from_range(&r, text, sizeof(text)) == SOS_OK);
+    ASSERT(sos_rope_len(&r) == sizeof(text));
+    sos_rope_finish(&r);
+
+    return 0;
+}
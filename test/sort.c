@@ -0,0 +1,59 @@
+#include "macros.h"
+#include <sos_sort.h>
+#include <string.h>
+
+static int
+qsort_cmp(const void* lhs, const void* rhs)
+{
+    return sos_cmp(lhs, rhs);
+}
+
+int sort(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    enum { N = 5000 };
+    static const char* const prefixes[] = {"", "a", "http://example.com/", "http://example.com/path/to/resource/", "\xff\xfe", "zz"};
+
+    Sos* const arr = malloc(N * sizeof(Sos));
+    Sos* const expected = malloc(N * sizeof(Sos));
+    SosView* const views = malloc(N * sizeof(SosView));
+    ASSERT(arr && expected && views);
+
+    unsigned seed = 42;
+    for (int i = 0; i < N; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        sos_init_from_cstr(&arr[i], prefixes[(seed >> 16) % 6]);
+        const int extra = (int)((seed >> 8) % 24);
+        for (int k = 0; k < extra; ++k) {
+            seed = seed * 1103515245u + 12345u;
+            sos_push(&arr[i], (char)('a' + (seed >> 16) % 4));
+        }
+        sos_init_by_copy(&expected[i], &arr[i]);
+    }
+
+    qsort(expected, N, sizeof(Sos), qsort_cmp);
+    ASSERT(sos_sort(arr, N) == SOS_OK);
+    for (int i = 0; i < N; ++i) {
+        ASSERT_SOS_EQ(arr[i], expected[i]);
+        views[i] = sos_view(&expected[N - 1 - i]);
+    }
+
+    ASSERT(sos_view_sort(views, N) == SOS_OK);
+    for (int i = 0; i < N; ++i) {
+        ASSERT(views[i].data == sos_cstr(&expected[i]) || strcmp(views[i].data, sos_cstr(&expected[i])) == 0);
+    }
+
+    ASSERT(sos_sort(arr, 0) == SOS_OK);
+    ASSERT(sos_sort(arr, 1) == SOS_OK);
+
+    for (int i = 0; i < N; ++i) {
+        sos_finish(&arr[i]);
+        sos_finish(&expected[i]);
+    }
+    free(arr);
+    free(expected);
+    free(views);
+
+    return 0;
+}
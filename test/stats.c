@@ -0,0 +1,53 @@
+#include "macros.h"
+
+int stats(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    sos_stats_reset();
+    Sos s1, s2;
+    sos_init(&s1);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT(sos_push(&s1, 'a') == SOS_OK);
+    }
+    ASSERT(sos_init_from_cstr(&s2, "short") == SOS_OK);
+    sos_finish(&s1);
+    sos_finish(&s2);
+
+    SosStats st;
+    sos_stats_snapshot(&st);
+    Sos report;
+    sos_init(&report);
+    ASSERT(sos_stats_format(&st, &report) == SOS_OK);
+    ASSERT(sos_len(&report) > 0);
+
+    if (!st.enabled) {
+        ASSERT(st.short_inits == 0 && st.finish_len_log2[0] == 0);
+        sos_finish(&report);
+        return 0;
+    }
+    ASSERT(st.short_inits == 2);
+    ASSERT(st.long_inits == 0);
+    ASSERT(st.short_to_long == 1);
+    ASSERT(st.reallocs == 2); // 31 -> 63 -> 127
+    ASSERT(st.frees == 1);
+    ASSERT(st.bytes_copied == 23 + 32 + 64);
+    ASSERT(st.finish_len_log2[3] == 1); // 5
+    ASSERT(st.finish_len_log2[7] == 1); // 100
+
+    // Only the fields returned by a batch count, not those dropped when the arena fills up
+    sos_stats_reset();
+    const char input[] = "ab,this field is longer than inline,and so is this one here";
+    Sos fields[3];
+    char arena[40];
+    const SosManyResult many = sos_init_many_from_delimited_in(input, sizeof(input) - 1, ',', fields, 3, arena, sizeof(arena));
+    ASSERT(many.count == 2);
+    sos_stats_snapshot(&st);
+    ASSERT(st.short_inits == 1 && st.long_inits == 1);
+
+    sos_stats_reset();
+    sos_stats_snapshot(&st);
+    ASSERT(st.short_inits == 0 && st.finish_len_log2[7] == 0);
+    sos_finish(&report);
+    return 0;
+}
@@ -0,0 +1,155 @@
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // mkstemp
+#endif
+#if defined(_MSC_VER) && !defined(_CRT_SECURE_NO_WARNINGS)
+#define _CRT_SECURE_NO_WARNINGS // fopen
+#endif
+
+#include "macros.h"
+#include <sos_strtab.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+static SosStatus
+open_crafted(uint64_t* image, size_t size, const SosStrtabHeader* header)
+{
+    SosStrtab tab;
+    memcpy(image, header, sizeof(*header));
+    const SosStatus status = sos_strtab_open_buffer(&tab, image, size);
+    if (status == SOS_OK) {
+        sos_strtab_close(&tab);
+    }
+    return status;
+}
+
+int strtab(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    const char* const words[] = {"pear", "apple", "", "banana split with a long name to go long mode", "app", "cherry"};
+    const size_t n = sizeof(words) / sizeof(words[0]);
+
+    Sos strs[sizeof(words) / sizeof(words[0])];
+    for (size_t i = 0; i < n; ++i) {
+        sos_init_from_cstr(&strs[i], words[i]);
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    char path[] = "/tmp/sos_test_strtab_XXXXXX";
+    const int fd = mkstemp(path);
+    ASSERT(fd >= 0);
+    close(fd);
+#else
+    const char* const path = "sos_test_strtab.bin";
+#endif
+    ASSERT(sos_strtab_write_file(path, strs, n, true) == SOS_OK);
+
+    SosStrtab tab;
+    ASSERT(sos_strtab_open(&tab, path) == SOS_OK);
+    ASSERT(sos_strtab_count(&tab) == n);
+    for (size_t i = 0; i < n; ++i) {
+        const SosView v = sos_strtab_get(&tab, i);
+        ASSERT(v.len == strlen(words[i]));
+        ASSERT(strcmp(v.data, words[i]) == 0);
+        ASSERT(sos_strtab_find(&tab, v) == i);
+    }
+    ASSERT(sos_strtab_find(&tab, (SosView) {.data = "apples", .len = 6}) == SOS_STRTAB_NPOS);
+    ASSERT(sos_strtab_find(&tab, (SosView) {.data = "ap", .len = 2}) == SOS_STRTAB_NPOS);
+    sos_strtab_close(&tab);
+
+    // Without index
+    ASSERT(sos_strtab_write_file(path, strs, n, false) == SOS_OK);
+    ASSERT(sos_strtab_open(&tab, path) == SOS_OK);
+    ASSERT(strcmp(sos_strtab_get(&tab, 5).data, "cherry") == 0);
+    ASSERT(sos_strtab_find(&tab, sos_strtab_get(&tab, 5)) == SOS_STRTAB_NPOS);
+    sos_strtab_close(&tab);
+
+    // Crafted headers in memory: offsets and counts that would wrap or overlap sections
+    FILE* const in = fopen(path, "rb");
+    ASSERT(in);
+    uint64_t image[64];
+    const size_t size = fread(image, 1, sizeof(image), in);
+    fclose(in);
+    ASSERT(size > sizeof(SosStrtabHeader) && size < sizeof(image));
+    ASSERT(sos_strtab_open_buffer(&tab, image, size) == SOS_OK);
+    sos_strtab_close(&tab);
+    SosStrtabHeader header;
+    memcpy(&header, image, sizeof(header));
+    SosStrtabHeader h = header;
+    h.entries_offset = UINT64_MAX - 63;
+    h.count = 4;
+    ASSERT(open_crafted(image, size, &h) == SOS_ERROR_INVALID);
+    h = header;
+    h.entries_offset = 0;
+    ASSERT(open_crafted(image, size, &h) == SOS_ERROR_INVALID);
+    h = header;
+    h.entries_offset = header.payload_offset + 8;
+    ASSERT(open_crafted(image, size, &h) == SOS_ERROR_INVALID);
+    h = header;
+    h.count = (header.payload_offset - header.entries_offset) / sizeof(SosStrtabEntry) + 1;
+    ASSERT(open_crafted(image, size, &h) == SOS_ERROR_INVALID);
+    h.count = UINT64_MAX / 8;
+    ASSERT(open_crafted(image, size, &h) == SOS_ERROR_INVALID);
+    h = header;
+    h.index_offset = header.entries_offset + 8; // Overlaps entries
+    ASSERT(open_crafted(image, size, &h) == SOS_ERROR_INVALID);
+    h.index_offset = UINT64_MAX - 7;
+    ASSERT(open_crafted(image, size, &h) == SOS_ERROR_INVALID);
+    h = header;
+    h.payload_offset = size + 8;
+    ASSERT(open_crafted(image, size, &h) == SOS_ERROR_INVALID);
+
+    // Crafted entries in memory: out of bounds or not null-terminated strings read as empty
+    memcpy(image, &header, sizeof(header));
+    SosStrtabEntry* const entries = (SosStrtabEntry*)(void*)((char*)image + header.entries_offset);
+    entries[0].offset = UINT64_MAX - 1;
+    entries[1].offset = header.payload_size;
+    entries[1].len = 0;
+    entries[3].len = UINT64_MAX;
+    entries[5].len -= 1; // Points before the null byte of "cherry"
+    ASSERT(sos_strtab_open_buffer(&tab, image, size) == SOS_OK);
+    for (size_t i = 0; i < n; ++i) {
+        const SosView v = sos_strtab_get(&tab, i);
+        if (i == 2 || i == 4) {
+            ASSERT(v.len == strlen(words[i]) && strcmp(v.data, words[i]) == 0);
+        } else {
+            ASSERT(v.len == 0 && v.data[0] == 0);
+        }
+    }
+    sos_strtab_close(&tab);
+
+    // Crafted index: entry numbers out of range are not followed
+    ASSERT(sos_strtab_write_file(path, strs, n, true) == SOS_OK);
+    FILE* const indexed = fopen(path, "rb");
+    ASSERT(indexed);
+    const size_t indexed_size = fread(image, 1, sizeof(image), indexed);
+    fclose(indexed);
+    ASSERT(indexed_size > sizeof(SosStrtabHeader) && indexed_size < sizeof(image));
+    memcpy(&header, image, sizeof(header));
+    uint64_t* const index = (uint64_t*)(void*)((char*)image + header.index_offset);
+    for (size_t i = 0; i < n; ++i) {
+        index[i] = UINT64_MAX - i;
+    }
+    ASSERT(sos_strtab_open_buffer(&tab, image, indexed_size) == SOS_OK);
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT(sos_strtab_find(&tab, (SosView) {.data = words[i], .len = strlen(words[i])}) == SOS_STRTAB_NPOS);
+    }
+    sos_strtab_close(&tab);
+
+    // Corrupted header
+    FILE* const fp = fopen(path, "r+b");
+    ASSERT(fp);
+    fputc('X', fp);
+    fclose(fp);
+    ASSERT(sos_strtab_open(&tab, path) == SOS_ERROR_INVALID);
+    remove(path);
+
+    for (size_t i = 0; i < n; ++i) {
+        sos_finish(&strs[i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "macros.h"
+#include <string.h>
+
+#define ASSERT_UTF8(STR, VALID)                                        \
+    do {                                                               \
+        Sos s_;                                                        \
+        sos_init_from_range(&s_, (STR), sizeof(STR) - 1);              \
+        ASSERT(sos_is_utf8(&s_) == (VALID));                           \
+        sos_finish(&s_);                                               \
+    } while (0)
+
+int transform(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    Sos s1, s2;
+    sos_init_from_cstr(&s1, "Hello, World! 123");
+    sos_to_lower(&s1);
+    ASSERT_SOS_EQS(s1, "hello, world! 123");
+    sos_to_upper(&s1);
+    ASSERT_SOS_EQS(s1, "HELLO, WORLD! 123");
+    sos_finish(&s1);
+
+    sos_init_from_cstr(&s1, " \t\r\n  some text with inner  spaces that is long \n");
+    sos_trim(&s1);
+    ASSERT_SOS_EQS(s1, "some text with inner  spaces that is long");
+    sos_finish(&s1);
+    sos_init_from_cstr(&s1, "   ");
+    sos_trim(&s1);
+    ASSERT(sos_len(&s1) == 0);
+    sos_finish(&s1);
+
+    // Equal strings hash equally, regardless of short/long mode history
+    sos_init_from_cstr(&s1, "the quick brown fox jumps over the lazy dog");
+    sos_init_with_cap(&s2, 100);
+    sos_append_cstr(&s2, "the quick brown fox jumps over the lazy dog");
+    ASSERT(sos_hash(&s1) == sos_hash(&s2));
+    sos_pop(&s2);
+    ASSERT(sos_hash(&s1) != sos_hash(&s2));
+    ASSERT(sos_hash_range("", 0) != sos_hash_range("\0", 1));
+    sos_finish(&s1);
+    sos_finish(&s2);
+
+    ASSERT_UTF8("plain ascii text, long enough for the fast path", true);
+    ASSERT_UTF8("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80", true);
+    ASSERT_UTF8("\xed\x9f\xbf", true);          // U+D7FF
+    ASSERT_UTF8("\xf4\x8f\xbf\xbf", true);      // U+10FFFF
+    ASSERT_UTF8("\xc0\xaf", false);             // Overlong
+    ASSERT_UTF8("\xe0\x80\xaf", false);         // Overlong
+    ASSERT_UTF8("\xed\xa0\x80", false);         // Surrogate
+    ASSERT_UTF8("\xf4\x90\x80\x80", false);     // Above U+10FFFF
+    ASSERT_UTF8("abc\xe2\x82", false);          // Truncated
+    ASSERT_UTF8("\x80", false);                 // Stray continuation
+    ASSERT_UTF8("abcdefgh\xe2\x28\xa1", false); // Bad continuation
+
+    return 0;
+}
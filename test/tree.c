@@ -0,0 +1,275 @@
+#include "macros.h"
+#include <sos_tree.h>
+#include <string.h>
+
+#define CHECK(expr)       \
+    do {                  \
+        if (!(expr)) {    \
+            return false; \
+        }                 \
+    } while (0)
+
+static SosView
+view_of(const char* s, size_t len)
+{
+    return (SosView) {.data = s, .len = len};
+}
+
+static SosView
+cview(const char* s)
+{
+    return view_of(s, strlen(s));
+}
+
+static int
+ref_cmp(SosView lhs, SosView rhs)
+{
+    const size_t len = lhs.len < rhs.len ? lhs.len : rhs.len;
+    const int ret = len ? memcmp(lhs.data, rhs.data, len) : 0;
+    return ret ? ret : (lhs.len > rhs.len) - (lhs.len < rhs.len);
+}
+
+// Byte-wise equality; sos_eq() stops at null bytes
+static bool
+key_eq(SosView lhs, SosView rhs)
+{
+    return ref_cmp(lhs, rhs) == 0;
+}
+
+static int
+sos_qsort_cmp(const void* lhs, const void* rhs)
+{
+    return ref_cmp(sos_view(lhs), sos_view(rhs));
+}
+
+typedef struct {
+    const Sos* expected;
+    size_t     pos;
+    size_t     end;
+    size_t     stop_after; // Stop the scan after this many entries
+} Collector;
+
+static bool
+collect(SosTreeEntry* entry, void* ctx)
+{
+    Collector* const c = ctx;
+    if (c->pos >= c->end || !key_eq(sos_tree_entry_key(entry), sos_view(&c->expected[c->pos]))) {
+        c->pos = (size_t)-1;
+        return false;
+    }
+    c->pos += 1;
+    return c->pos < c->stop_after;
+}
+
+// Index of the first reference key not less than `key`
+static size_t
+ref_lower_bound(const Sos* keys, size_t n, SosView key)
+{
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (ref_cmp(sos_view(&keys[mid]), key) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Check lookups and scans of `tree` against sorted, distinct `keys`, whose values are their indices
+static bool
+check_tree(const SosTree* tree, const Sos* keys, size_t n)
+{
+    CHECK(sos_tree_count(tree) == n);
+    for (size_t i = 0; i < n; ++i) {
+        const SosTreeEntry* const e = sos_tree_find(tree, sos_view(&keys[i]));
+        CHECK(e && key_eq(sos_tree_entry_key(e), sos_view(&keys[i])) && (size_t)(uintptr_t)e->value == i);
+    }
+
+    // Full scan, then scans stopping early
+    Collector c = {keys, 0, n, (size_t)-1};
+    sos_tree_scan_prefix(tree, view_of(NULL, 0), collect, &c);
+    CHECK(c.pos == n);
+    c = (Collector) {keys, 0, n, 3};
+    sos_tree_scan_prefix(tree, view_of(NULL, 0), collect, &c);
+    CHECK(c.pos == (n < 3 ? n : 3));
+
+    // Probes: each key, the key with a byte removed or appended
+    for (size_t i = 0; i < n; ++i) {
+        const SosView k = sos_view(&keys[i]);
+        char buf[256];
+        if (k.len + 1 > sizeof(buf)) {
+            continue;
+        }
+        memcpy(buf, k.data, k.len);
+        SosView probes[4];
+        size_t nprobes = 0;
+        probes[nprobes++] = k;
+        buf[k.len] = '\x01';
+        probes[nprobes++] = view_of(buf, k.len + 1);
+        if (k.len > 0) {
+            probes[nprobes++] = view_of(buf, k.len - 1);
+            probes[nprobes++] = view_of(buf, k.len / 2);
+        }
+        for (size_t p = 0; p < nprobes; ++p) {
+            const size_t lb = ref_lower_bound(keys, n, probes[p]);
+            const SosTreeEntry* const e = sos_tree_lower_bound(tree, probes[p]);
+            CHECK(lb == n ? e == NULL : e && key_eq(sos_tree_entry_key(e), sos_view(&keys[lb])));
+
+            const SosTreeEntry* const f = sos_tree_find(tree, probes[p]);
+            CHECK((lb < n && ref_cmp(sos_view(&keys[lb]), probes[p]) == 0) == (f != NULL));
+
+            // Prefix scan: the keys starting with the probe follow its lower bound
+            size_t end = lb;
+            while (end < n && sos_len(&keys[end]) >= probes[p].len &&
+                   memcmp(sos_cstr(&keys[end]), probes[p].data, probes[p].len) == 0) {
+                ++end;
+            }
+            c = (Collector) {keys, lb, end, (size_t)-1};
+            sos_tree_scan_prefix(tree, probes[p], collect, &c);
+            CHECK(c.pos == end);
+
+            // Range scan up to a later key
+            const size_t hi = (i + 7) % n;
+            if (ref_cmp(probes[p], sos_view(&keys[hi])) < 0) {
+                c = (Collector) {keys, lb, hi, (size_t)-1};
+                sos_tree_scan_range(tree, probes[p], sos_view(&keys[hi]), collect, &c);
+                CHECK(c.pos == hi);
+            }
+        }
+    }
+    return true;
+}
+
+// Sort and remove duplicates
+static size_t
+sort_unique(Sos* keys, size_t n)
+{
+    qsort(keys, n, sizeof(Sos), sos_qsort_cmp);
+    size_t out = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (out > 0 && key_eq(sos_view(&keys[out - 1]), sos_view(&keys[i]))) {
+            sos_finish(&keys[i]);
+        } else {
+            sos_init_by_move(&keys[out++], &keys[i]);
+        }
+    }
+    return out;
+}
+
+#define NKEYS 3000
+
+int tree(int argc, char** argv)
+{
+    (void)argc; (void)argv;
+
+    SosTree t;
+    sos_tree_init(&t);
+    ASSERT_EQ(sos_tree_count(&t), 0);
+    ASSERT(sos_tree_find(&t, cview("a")) == NULL);
+    ASSERT(sos_tree_lower_bound(&t, cview("")) == NULL);
+
+    // Keys that are prefixes of each other, including the empty key
+    ASSERT_EQ(sos_tree_insert(&t, cview("abc"), (void*)1), SOS_OK);
+    ASSERT_EQ(sos_tree_insert(&t, cview("ab"), (void*)2), SOS_OK);
+    ASSERT_EQ(sos_tree_insert(&t, cview(""), (void*)3), SOS_OK);
+    ASSERT_EQ(sos_tree_insert(&t, cview("abcd"), (void*)4), SOS_OK);
+    ASSERT_EQ(sos_tree_insert(&t, cview("ab"), (void*)5), SOS_OK); // replaces
+    ASSERT_EQ(sos_tree_count(&t), 4);
+    ASSERT(sos_tree_find(&t, cview("ab"))->value == (void*)5);
+    ASSERT(sos_tree_find(&t, cview(""))->value == (void*)3);
+    ASSERT(sos_tree_find(&t, cview("a")) == NULL);
+    ASSERT(sos_tree_find(&t, cview("abcde")) == NULL);
+    ASSERT(sos_tree_lower_bound(&t, cview("a"))->value == (void*)5);
+    ASSERT(sos_tree_lower_bound(&t, cview("abd")) == NULL);
+    ASSERT(sos_tree_memory(&t) > 0);
+    sos_tree_finish(&t);
+    ASSERT_EQ(sos_tree_count(&t), 0);
+    ASSERT_EQ(sos_tree_memory(&t), 0);
+
+    // Path-like keys with long shared prefixes, fan-out of all 256 bytes, embedded nulls and random keys
+    Sos* const keys = malloc(NKEYS * sizeof(Sos));
+    ASSERT(keys);
+    size_t n = 0;
+    uint64_t x = 88172645463325252u;
+    for (; n < 1000; ++n) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+        sos_init_format(&keys[n], "/srv/data/projects/p%u/src/module%u/file%u.c", (unsigned)(x % 7), (unsigned)(x >> 8) % 13, (unsigned)(x >> 16) % 50);
+    }
+    for (unsigned c = 0; c < 256; ++c, ++n) {
+        const char k[3] = {'f', 'a', (char)c};
+        sos_init_from_range(&keys[n], k, (c % 2) ? 3 : 2 + (c % 4 == 0));
+    }
+    for (; n < NKEYS; ++n) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+        char k[40];
+        const size_t len = x % 40;
+        for (size_t i = 0; i < len; ++i) {
+            k[i] = "ab\0/z"[(x >> (i % 60)) % 5];
+        }
+        sos_init_from_range(&keys[n], k, len);
+    }
+
+    // Insert in input order, check against the sorted keys
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(sos_tree_insert(&t, sos_view(&keys[i]), NULL), SOS_OK);
+    }
+    n = sort_unique(keys, n);
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(sos_tree_insert(&t, sos_view(&keys[i]), (void*)(uintptr_t)i), SOS_OK);
+    }
+    ASSERT(check_tree(&t, keys, n));
+    const size_t inserted_memory = sos_tree_memory(&t);
+    sos_tree_finish(&t);
+
+    // Bulk load
+    void** const values = malloc(n * sizeof(void*));
+    ASSERT(values);
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = (void*)(uintptr_t)i;
+    }
+    ASSERT_EQ(sos_tree_init_from_sorted(&t, keys, values, n), SOS_OK);
+    ASSERT(check_tree(&t, keys, n));
+    ASSERT(sos_tree_memory(&t) <= inserted_memory); // Nodes sized to fit
+    // Inserting into a bulk-loaded tree
+    ASSERT_EQ(sos_tree_insert(&t, cview("/srv/data/projects/p9"), NULL), SOS_OK);
+    ASSERT(sos_tree_find(&t, cview("/srv/data/projects/p9")) != NULL);
+    ASSERT(sos_tree_find(&t, cview("/srv/data/projects/p")) == NULL);
+    sos_tree_finish(&t);
+
+    ASSERT_EQ(sos_tree_init_from_sorted(&t, keys, NULL, 1), SOS_OK);
+    ASSERT_EQ(sos_tree_count(&t), 1);
+    ASSERT(sos_tree_find(&t, sos_view(&keys[0]))->value == NULL);
+    sos_tree_finish(&t);
+    ASSERT_EQ(sos_tree_init_from_sorted(&t, keys, NULL, 0), SOS_OK);
+    ASSERT_EQ(sos_tree_count(&t), 0);
+    sos_tree_finish(&t);
+
+    // Unsorted and duplicated input
+    Sos bad[3];
+    sos_init_from_cstr(&bad[0], "path/b");
+    sos_init_from_cstr(&bad[1], "path/a");
+    sos_init_from_cstr(&bad[2], "path/c");
+    ASSERT_EQ(sos_tree_init_from_sorted(&t, bad, NULL, 3), SOS_ERROR_INVALID);
+    sos_finish(&bad[1]);
+    sos_init_from_cstr(&bad[1], "path/b");
+    ASSERT_EQ(sos_tree_init_from_sorted(&t, bad, NULL, 3), SOS_ERROR_INVALID);
+    // Out of order within the prefix of the first and last keys
+    const char* const misplaced[3] = {"aab", "bac", "abb"};
+    for (int i = 0; i < 3; ++i) {
+        sos_finish(&bad[i]);
+        sos_init_from_cstr(&bad[i], misplaced[i]);
+    }
+    ASSERT_EQ(sos_tree_init_from_sorted(&t, bad, NULL, 3), SOS_ERROR_INVALID);
+    for (int i = 0; i < 3; ++i) {
+        sos_finish(&bad[i]);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        sos_finish(&keys[i]);
+    }
+    free(values);
+    free(keys);
+    return 0;
+}